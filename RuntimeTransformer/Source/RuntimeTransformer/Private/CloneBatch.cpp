@@ -0,0 +1,122 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "CloneBatch.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+
+FCloneBatch::FCloneBatch()
+{
+	NextTemplate = 0;
+	AverageCloneTime = 0.0;
+	bSelectNewClones = false;
+	bAppendToList = false;
+	bActive = false;
+}
+
+void FCloneBatch::Init(const TArray<AActor*>& Actors, bool bInSelectNewClones, bool bInAppendToList)
+{
+	Reset();
+
+	Templates.Reserve(Actors.Num());
+	for (AActor* actor : Actors)
+	{
+		if (!IsValid(actor) || TemplateIndex.Contains(actor)) continue;
+		TemplateIndex.Add(actor, Templates.Add(actor));
+	}
+
+	//Depth of each Template (how many of its attach ancestors are also in the Batch). Memoized, so it's linear
+	TMap<const AActor*, int32> depths;
+	depths.Reserve(Templates.Num());
+	TArray<const AActor*> chain;
+	for (AActor* actor : Templates)
+	{
+		//walk up until an Actor whose Depth is known (or the top of the hierarchy) is found
+		int32 depth = 0;
+		for (const AActor* current = actor; current; current = current->GetAttachParentActor())
+		{
+			if (const int32* knownDepth = depths.Find(current))
+			{
+				depth = *knownDepth;
+				break;
+			}
+			chain.Add(current);
+		}
+
+		//assign the depths top down
+		for (int32 i = chain.Num() - 1; i >= 0; --i)
+		{
+			if (TemplateIndex.Contains(chain[i]))
+				++depth;
+			depths.Add(chain[i], depth);
+		}
+		chain.Reset();
+	}
+
+	Templates.StableSort([&depths](const AActor& A, const AActor& B)
+	{
+		return depths.FindChecked(&A) < depths.FindChecked(&B);
+	});
+
+	for (int32 i = 0; i < Templates.Num(); ++i)
+		TemplateIndex.Add(Templates[i], i);
+
+	Clones.SetNumZeroed(Templates.Num());
+	bSelectNewClones = bInSelectNewClones;
+	bAppendToList = bInAppendToList;
+	bActive = true;
+}
+
+void FCloneBatch::InitSpawns(const TArray<UClass*>& Classes, const TArray<FTransform>& Transforms
+                             , bool bInSelectNewClones, bool bInAppendToList)
+{
+	Reset();
+
+	const int32 num = FMath::Min(Classes.Num(), Transforms.Num());
+	SpawnClasses.Reserve(num);
+	SpawnTransforms.Reserve(num);
+	for (int32 i = 0; i < num; ++i)
+	{
+		if (!Classes[i]) continue;
+		SpawnClasses.Add(Classes[i]);
+		SpawnTransforms.Add(Transforms[i]);
+	}
+
+	Templates.SetNumZeroed(SpawnClasses.Num());
+	Clones.SetNumZeroed(SpawnClasses.Num());
+	bSelectNewClones = bInSelectNewClones;
+	bAppendToList = bInAppendToList;
+	bActive = true;
+}
+
+void FCloneBatch::Reset()
+{
+	Templates.Reset();
+	Clones.Reset();
+	SpawnClasses.Reset();
+	SpawnTransforms.Reset();
+	TemplateIndex.Reset();
+	NextTemplate = 0;
+	AverageCloneTime = 0.0;
+	bSelectNewClones = false;
+	bAppendToList = false;
+	bActive = false;
+}
+
+int32 FCloneBatch::FindTemplate(const AActor* Template) const
+{
+	const int32* index = TemplateIndex.Find(Template);
+	return index ? *index : INDEX_NONE;
+}
+
+TArray<USceneComponent*> FCloneBatch::GetCloneRoots() const
+{
+	TArray<USceneComponent*> outRoots;
+	outRoots.Reserve(Clones.Num());
+	for (AActor* clone : Clones)
+	{
+		if (IsValid(clone) && clone->GetRootComponent())
+			outRoots.Add(clone->GetRootComponent());
+	}
+	return outRoots;
+}
@@ -0,0 +1,102 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "DragPreview.h"
+#include "Components/SceneComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+void FDragPreview::Begin(const TArray<USceneComponent*>& InComponents)
+{
+	TSet<UPrimitiveComponent*> previewedPrimitives;
+	for (const FPrimitiveState& state : Primitives)
+		previewedPrimitives.Add(state.Primitive.Get());
+
+	TArray<USceneComponent*> hierarchy;
+	for (USceneComponent* component : InComponents)
+	{
+		if (!IsValid(component) || Components.Contains(component)) continue;
+
+		if (UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(component))
+			if (primitive->IsSimulatingPhysics())
+				continue;
+
+		Components.Add(component);
+
+		hierarchy.Reset();
+		hierarchy.Add(component);
+		component->GetChildrenComponents(true, hierarchy);
+
+		for (USceneComponent* child : hierarchy)
+		{
+			UPrimitiveComponent* primitive = Cast<UPrimitiveComponent>(child);
+			if (!primitive || previewedPrimitives.Contains(primitive)) continue;
+			previewedPrimitives.Add(primitive);
+
+			FPrimitiveState& state = Primitives.AddDefaulted_GetRef();
+			state.Primitive = primitive;
+			state.CollisionEnabled = primitive->GetCollisionEnabled();
+			state.bGenerateOverlapEvents = primitive->GetGenerateOverlapEvents();
+
+			//only write what actually changes
+			if (state.CollisionEnabled != ECollisionEnabled::NoCollision)
+				primitive->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			if (state.bGenerateOverlapEvents)
+				primitive->SetGenerateOverlapEvents(false);
+		}
+	}
+}
+
+void FDragPreview::End()
+{
+	if (!IsActive()) return;
+
+	//the Collision goes back first, so the Body Teleports and the Overlap Updates see it
+	for (const FPrimitiveState& state : Primitives)
+	{
+		UPrimitiveComponent* primitive = state.Primitive.Get();
+		if (!primitive) continue;
+
+		//unless something else changed it meanwhile (e.g. a Soft-Delete)
+		if (state.CollisionEnabled != ECollisionEnabled::NoCollision
+			&& primitive->GetCollisionEnabled() == ECollisionEnabled::NoCollision)
+			primitive->SetCollisionEnabled(state.CollisionEnabled);
+		if (state.bGenerateOverlapEvents && !primitive->GetGenerateOverlapEvents())
+			primitive->SetGenerateOverlapEvents(true);
+	}
+
+	//the Bodies were left behind while Previewing (the Physics Update was skipped), so each is Teleported explicitly
+	for (const FPrimitiveState& state : Primitives)
+	{
+		UPrimitiveComponent* primitive = state.Primitive.Get();
+		if (!primitive) continue;
+
+		if (FBodyInstance* body = primitive->GetBodyInstance())
+			body->SetBodyTransform(primitive->GetComponentTransform(), ETeleportType::TeleportPhysics);
+		primitive->UpdateOverlaps();
+	}
+	Primitives.Empty();
+	Components.Empty();
+}
+
+void FDragPreview::MoveComponent(USceneComponent* Component, const FTransform& WorldTransform)
+{
+	FTransform relativeTransform = WorldTransform;
+	if (const USceneComponent* parent = Component->GetAttachParent())
+		relativeTransform = WorldTransform.GetRelativeTransform(
+			parent->GetSocketTransform(Component->GetAttachSocketName()));
+
+	//same as SetWorldTransform
+	if (Component->IsUsingAbsoluteLocation())
+		relativeTransform.SetLocation(WorldTransform.GetLocation());
+	if (Component->IsUsingAbsoluteRotation())
+		relativeTransform.SetRotation(WorldTransform.GetRotation());
+	if (Component->IsUsingAbsoluteScale())
+		relativeTransform.SetScale3D(WorldTransform.GetScale3D());
+
+	Component->SetRelativeLocation_Direct(relativeTransform.GetLocation());
+	Component->SetRelativeRotation_Direct(relativeTransform.Rotator());
+	Component->SetRelativeScale3D_Direct(relativeTransform.GetScale3D());
+
+	//the Component and Render Transforms only (of the children too). No Sweep, so no Overlaps are updated either
+	Component->UpdateComponentToWorld(EUpdateTransformFlags::SkipPhysicsUpdate, ETeleportType::None);
+}
@@ -5,6 +5,8 @@
 #include "Components/SceneComponent.h"
 #include "Components/ShapeComponent.h"
 #include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "Gizmos/GizmoRenderComponent.h"
 #include "Engine/World.h"
 
 // Sets default values
@@ -31,6 +33,9 @@ ABaseGizmo::ABaseGizmo()
 	RegisterDomainComponent(Y_AxisBox, ETransformationDomain::TD_Y_Axis);
 	RegisterDomainComponent(Z_AxisBox, ETransformationDomain::TD_Z_Axis);
 
+	//only created if used, once the (Blueprint) Defaults tell whether it is. @see PostInitializeComponents
+	GizmoRenderer = nullptr;
+
 	GizmoSceneScaleFactor = 0.1f;
 	CameraArcRadius = 150.f;
 
@@ -39,6 +44,36 @@ ABaseGizmo::ABaseGizmo()
 
 	bTransformInProgress = false;
 	bIsPrevRayValid = false;
+	bGizmoActive = true;
+	bAttachmentDirty = true;
+	bAlwaysTick = false;
+	bUseGizmoRenderer = false;
+	GizmoRendererClass = UGizmoRenderComponent::StaticClass();
+	bConstantScreenSize = false;
+	ViewFieldOfView = 90.f;
+	bMirrorAxesToView = false;
+}
+
+void ABaseGizmo::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	//the Renderer is given its Shapes before it's registered, so its Scene Proxy is only created once
+	if (bUseGizmoRenderer && !GizmoRenderer)
+	{
+		UClass* rendererClass = GizmoRendererClass ? GizmoRendererClass.Get() : UGizmoRenderComponent::StaticClass();
+		GizmoRenderer = NewObject<UGizmoRenderComponent>(this, rendererClass, TEXT("Gizmo Renderer"));
+		GizmoRenderer->SetupAttachment(ScalingScene);
+
+		TArray<FGizmoRenderShape> shapes;
+		GetRenderShapes(shapes);
+		GizmoRenderer->SetShapes(MoveTemp(shapes));
+
+		if (bConstantScreenSize)
+			GizmoRenderer->SetViewScaling(true, GizmoSceneScaleFactor, CameraArcRadius, bMirrorAxesToView);
+
+		GizmoRenderer->RegisterComponent();
+	}
 }
 
 void ABaseGizmo::Tick(float DeltaSeconds)
@@ -46,10 +81,22 @@ void ABaseGizmo::Tick(float DeltaSeconds)
 	Super::Tick(DeltaSeconds);
 
 	//ToDo: There seems to be an issue where the Root Scene doesn't Attach properly on the first 'go' on Unreal 4.26
-	if (RootScene)
+	if (RootScene && bAttachmentDirty && RootScene->GetAttachParent())
 	{
 		RootScene->AttachToComponent(RootScene->GetAttachParent(), FAttachmentTransformRules::SnapToTargetIncludingScale);
 	}
+	bAttachmentDirty = false;
+
+	//nothing else to do until the next attachment
+	if (!bAlwaysTick)
+		SetActorTickEnabled(false);
+}
+
+void ABaseGizmo::NotifyAttachmentChanged()
+{
+	bAttachmentDirty = true;
+	if (bGizmoActive)
+		SetActorTickEnabled(true);
 }
 
 void ABaseGizmo::UpdateGizmoSpace(ESpaceType SpaceType)
@@ -81,10 +128,28 @@ void ABaseGizmo::ScaleGizmoScene(const FVector& ReferenceLocation, const FVector
 {
 	FVector Scale = CalculateGizmoSceneScale(ReferenceLocation, ReferenceLookDirection, FieldOfView);
 	//UE_LOG(LogRuntimeTransformer, Warning, TEXT("Scale: %s"), *Scale.ToString());
+
+	//the Renderer does the scaling for each View. Only what Picking and the Mirroring need is kept
+	if (bConstantScreenSize && bUseGizmoRenderer && GizmoRenderer)
+	{
+		ViewFieldOfView = FieldOfView;
+		if (bMirrorAxesToView)
+			GizmoRenderer->SetFrozenMirror(GetTransformProgressState(), Scale.GetSignVector());
+		return;
+	}
+
 	if (ScalingScene)
 		ScalingScene->SetWorldScale3D(Scale);
 }
 
+float ABaseGizmo::ComputeViewScale(const FVector& GizmoLocation, const FVector& ViewLocation
+	, const FVector& ViewDirection, float FieldOfView, float ScaleFactor, float ArcRadius)
+{
+	const float distance = (GizmoLocation - ViewLocation).ProjectOnTo(ViewDirection).Size();
+	const float scaleView = (distance * FMath::Sin(FMath::DegreesToRadians(FieldOfView))) / ArcRadius;
+	return scaleView * ScaleFactor;
+}
+
 FTransform ABaseGizmo::GetSnappedTransform(FTransform& outCurrentAccumulatedTransform
 	, const FTransform& DeltaTransform
 	, ETransformationDomain Domain
@@ -108,13 +173,215 @@ ETransformationDomain ABaseGizmo::GetTransformationDomain(USceneComponent* Compo
 	return ETransformationDomain::TD_None;
 }
 
+ETransformationDomain ABaseGizmo::PickDomain(const FVector& RayOrigin, const FVector& RayDirection
+	, float& outDistance) const
+{
+	ETransformationDomain pickedDomain = ETransformationDomain::TD_None;
+	outDistance = BIG_NUMBER;
+
+	FVector rayOrigin, rayDirection;
+	float rayScale;
+	GetPickRay(RayOrigin, RayDirection, rayOrigin, rayDirection, rayScale);
+
+	for (auto& domainPair : DomainMap)
+	{
+		const UShapeComponent* shape = domainPair.Key;
+		if (!shape || !shape->IsRegistered()) continue;
+
+		float distance = BIG_NUMBER;
+		bool bHit = false;
+
+		if (const UBoxComponent* box = Cast<UBoxComponent>(shape))
+			bHit = IntersectRayBox(box, rayOrigin, rayDirection, distance);
+		else if (const USphereComponent* sphere = Cast<USphereComponent>(shape))
+			bHit = IntersectRaySphere(sphere, rayOrigin, rayDirection, distance);
+
+		if (bHit && distance < outDistance)
+		{
+			outDistance = distance;
+			pickedDomain = domainPair.Value;
+		}
+	}
+
+	if (pickedDomain != ETransformationDomain::TD_None)
+		outDistance *= rayScale;
+	return pickedDomain;
+}
+
+void ABaseGizmo::GetPickRay(const FVector& RayOrigin, const FVector& RayDirection
+	, FVector& outOrigin, FVector& outDirection, float& outScale) const
+{
+	outOrigin = RayOrigin;
+	outDirection = RayDirection;
+	outScale = 1.f;
+	if (!bConstantScreenSize || !bUseGizmoRenderer) return;
+
+	//the Ray stands in for the View Direction, as both are close whenever the Gizmo is being picked
+	const FVector pivot = GetActorLocation();
+	outScale = FMath::Max(ComputeViewScale(pivot, RayOrigin, RayDirection, ViewFieldOfView
+		, GizmoSceneScaleFactor, CameraArcRadius), KINDA_SMALL_NUMBER);
+	outOrigin = pivot + (RayOrigin - pivot) / outScale;
+
+	if (!bMirrorAxesToView) return;
+
+	//the Renderer flips each Axis towards the View (the Ray Origin), and a Mirror is its own inverse
+	const FQuat rotation = ScalingScene ? ScalingScene->GetComponentQuat() : GetActorQuat();
+	const FVector toView = RayOrigin - pivot;
+	FVector mirror;
+	mirror.X = FVector::DotProduct(rotation.GetAxisX(), toView) >= 0.f ? 1.f : -1.f;
+	mirror.Y = FVector::DotProduct(rotation.GetAxisY(), toView) >= 0.f ? 1.f : -1.f;
+	mirror.Z = FVector::DotProduct(rotation.GetAxisZ(), toView) >= 0.f ? 1.f : -1.f;
+
+	outOrigin = pivot + rotation.RotateVector(rotation.UnrotateVector(outOrigin - pivot) * mirror);
+	outDirection = rotation.RotateVector(rotation.UnrotateVector(RayDirection) * mirror);
+}
+
+ETransformationDomain ABaseGizmo::PickDomainAt(const FTransform& GizmoTransform, const FVector& RayOrigin
+	, const FVector& RayDirection, float& outDistance) const
+{
+	ETransformationDomain pickedDomain = ETransformationDomain::TD_None;
+	outDistance = BIG_NUMBER;
+
+	//the Scaling Scene, as CalculateGizmoSceneScale would have scaled it for a View looking along the Ray
+	const FVector pivot = GizmoTransform.GetLocation();
+	FVector scale(ComputeViewScale(pivot, RayOrigin, RayDirection, ViewFieldOfView
+		, GizmoSceneScaleFactor, CameraArcRadius));
+	if (bMirrorAxesToView)
+	{
+		const FVector toView = RayOrigin - pivot;
+		scale.X *= FVector::DotProduct(GizmoTransform.GetUnitAxis(EAxis::X), toView) >= 0.f ? 1.f : -1.f;
+		scale.Y *= FVector::DotProduct(GizmoTransform.GetUnitAxis(EAxis::Y), toView) >= 0.f ? 1.f : -1.f;
+		scale.Z *= FVector::DotProduct(GizmoTransform.GetUnitAxis(EAxis::Z), toView) >= 0.f ? 1.f : -1.f;
+	}
+	const FTransform sceneTransform(GizmoTransform.GetRotation(), pivot, scale);
+
+	TArray<FGizmoRenderShape> shapes;
+	GetRenderShapes(shapes);
+
+	for (const FGizmoRenderShape& shape : shapes)
+	{
+		const FTransform shapeTransform = shape.Transform * sceneTransform;
+		float distance = BIG_NUMBER;
+		bool bHit = false;
+
+		switch (shape.Type)
+		{
+		case FGizmoRenderShape::EType::Box:
+			bHit = IntersectRayBox(shapeTransform, shape.Size, RayOrigin, RayDirection, distance);
+			break;
+		case FGizmoRenderShape::EType::Sphere:
+			bHit = IntersectRaySphere(shapeTransform.GetLocation(), shape.Size.X * shapeTransform.GetMaximumAxisScale()
+				, RayOrigin, RayDirection, distance);
+			break;
+		case FGizmoRenderShape::EType::Ring:
+			bHit = IntersectRayRing(shapeTransform, shape.Size.X, shape.Size.Y, RayOrigin, RayDirection, distance);
+			break;
+		}
+
+		if (bHit && distance < outDistance)
+		{
+			outDistance = distance;
+			pickedDomain = shape.Domain;
+		}
+	}
+
+	return pickedDomain;
+}
+
+bool ABaseGizmo::IntersectRayBox(const UBoxComponent* Box, const FVector& RayOrigin
+	, const FVector& RayDirection, float& outDistance)
+{
+	return IntersectRayBox(Box->GetComponentTransform(), Box->GetUnscaledBoxExtent(), RayOrigin, RayDirection
+		, outDistance);
+}
+
+bool ABaseGizmo::IntersectRayBox(const FTransform& BoxTransform, const FVector& Extent, const FVector& RayOrigin
+	, const FVector& RayDirection, float& outDistance)
+{
+	//In the Box space, the Box is an AABB. Since the transform is affine, the ray parameter is the same in both spaces
+	const FVector localOrigin = BoxTransform.InverseTransformPosition(RayOrigin);
+	const FVector localDirection = BoxTransform.InverseTransformVector(RayDirection);
+	const FVector& extent = Extent;
+
+	float tMin = 0.f;
+	float tMax = BIG_NUMBER;
+
+	for (int32 axis = 0; axis < 3; ++axis)
+	{
+		if (FMath::IsNearlyZero(localDirection[axis]))
+		{
+			//parallel to the slab, so it must already be inside it
+			if (FMath::Abs(localOrigin[axis]) > extent[axis])
+				return false;
+			continue;
+		}
+
+		const float invDirection = 1.f / localDirection[axis];
+		float t0 = (-extent[axis] - localOrigin[axis]) * invDirection;
+		float t1 = (extent[axis] - localOrigin[axis]) * invDirection;
+		if (t0 > t1) Swap(t0, t1);
+
+		tMin = FMath::Max(tMin, t0);
+		tMax = FMath::Min(tMax, t1);
+		if (tMin > tMax)
+			return false;
+	}
+
+	outDistance = tMin;
+	return true;
+}
+
+bool ABaseGizmo::IntersectRaySphere(const USphereComponent* Sphere, const FVector& RayOrigin
+	, const FVector& RayDirection, float& outDistance)
+{
+	return IntersectRaySphere(Sphere->GetComponentLocation(), Sphere->GetScaledSphereRadius(), RayOrigin
+		, RayDirection, outDistance);
+}
+
+bool ABaseGizmo::IntersectRaySphere(const FVector& Center, float Radius, const FVector& RayOrigin
+	, const FVector& RayDirection, float& outDistance)
+{
+	const float radius = Radius;
+	const FVector toOrigin = RayOrigin - Center;
+
+	const float b = FVector::DotProduct(toOrigin, RayDirection);
+	const float c = toOrigin.SizeSquared() - FMath::Square(radius);
+
+	//origin outside and pointing away
+	if (c > 0.f && b > 0.f)
+		return false;
+
+	const float discriminant = b * b - c;
+	if (discriminant < 0.f)
+		return false;
+
+	outDistance = FMath::Max(0.f, -b - FMath::Sqrt(discriminant));
+	return true;
+}
+
+bool ABaseGizmo::IntersectRayRing(const FTransform& RingTransform, float Radius, float Thickness
+	, const FVector& RayOrigin, const FVector& RayDirection, float& outDistance)
+{
+	//the ray parameter is the same in both spaces
+	const FVector localOrigin = RingTransform.InverseTransformPosition(RayOrigin);
+	const FVector localDirection = RingTransform.InverseTransformVector(RayDirection);
+	if (FMath::IsNearlyZero(localDirection.X)) return false;
+
+	const float distance = -localOrigin.X / localDirection.X;
+	if (distance < 0.f) return false;
+
+	FVector pointOnPlane = localOrigin + localDirection * distance;
+	pointOnPlane.X = 0.f;
+	if (FMath::Abs(pointOnPlane.Size() - Radius) > Thickness * 0.5f) return false;
+
+	outDistance = distance;
+	return true;
+}
+
 FVector ABaseGizmo::CalculateGizmoSceneScale(const FVector& ReferenceLocation, const FVector& ReferenceLookDirection, float FieldOfView)
 {
-	FVector deltaLocation = (GetActorLocation() - ReferenceLocation);
-	float distance = deltaLocation.ProjectOnTo(ReferenceLookDirection).Size();
-	float scaleView = (distance * FMath::Sin(FMath::DegreesToRadians(FieldOfView))) / CameraArcRadius;
-	scaleView *= GizmoSceneScaleFactor;
-	return FVector(scaleView);
+	return FVector(ComputeViewScale(GetActorLocation(), ReferenceLocation, ReferenceLookDirection, FieldOfView
+		, GizmoSceneScaleFactor, CameraArcRadius));
 }
 
 bool ABaseGizmo::AreRaysValid() const
@@ -140,6 +407,40 @@ void ABaseGizmo::RegisterDomainComponent(USceneComponent* Component
 		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Failed to Register Component! Component is not a Shape Component %s"), *Component->GetName());
 }
 
+void ABaseGizmo::GetRenderShapes(TArray<FGizmoRenderShape>& outShapes) const
+{
+	if (!ScalingScene) return;
+
+	const FTransform& sceneTransform = ScalingScene->GetComponentTransform();
+	for (auto& domainPair : DomainMap)
+	{
+		const UShapeComponent* shape = domainPair.Key;
+		if (!shape) continue;
+
+		FGizmoRenderShape renderShape;
+		renderShape.Domain = domainPair.Value;
+		//the Relative Transform is also valid for a Gizmo that is not spawned (e.g. the Class Default Object)
+		renderShape.Transform = shape->GetAttachParent() == ScalingScene
+			? shape->GetRelativeTransform()
+			: shape->GetComponentTransform().GetRelativeTransform(sceneTransform);
+
+		if (const UBoxComponent* box = Cast<UBoxComponent>(shape))
+		{
+			renderShape.Type = FGizmoRenderShape::EType::Box;
+			renderShape.Size = box->GetUnscaledBoxExtent();
+		}
+		else if (const USphereComponent* sphere = Cast<USphereComponent>(shape))
+		{
+			renderShape.Type = FGizmoRenderShape::EType::Sphere;
+			renderShape.Size = FVector(sphere->GetUnscaledSphereRadius());
+		}
+		else
+			continue;
+
+		outShapes.Add(renderShape);
+	}
+}
+
 void ABaseGizmo::SetTransformProgressState(bool bInProgress
 	, ETransformationDomain CurrentDomain)
 {
@@ -149,4 +450,26 @@ void ABaseGizmo::SetTransformProgressState(bool bInProgress
 		bTransformInProgress = bInProgress;
 		OnGizmoStateChange.Broadcast(GetGizmoType(), bTransformInProgress, CurrentDomain);
 	}
+
+	if (bUseGizmoRenderer && GizmoRenderer)
+		GizmoRenderer->SetHighlightedDomain(bInProgress ? CurrentDomain : ETransformationDomain::TD_None);
+}
+
+void ABaseGizmo::SetGizmoActive(bool bActive)
+{
+	bGizmoActive = bActive;
+
+	SetActorHiddenInGame(!bActive);
+	SetActorEnableCollision(bActive);
+	SetActorTickEnabled(bActive);
+
+	if (!bActive)
+	{
+		//reset the state so that it does not carry over to when the Gizmo is reused
+		bTransformInProgress = false;
+		bIsPrevRayValid = false;
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	else
+		bAttachmentDirty = true;
 }
@@ -0,0 +1,489 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "Gizmos/GizmoRenderComponent.h"
+#include "Gizmos/BaseGizmo.h"
+#include "PrimitiveSceneProxy.h"
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "StaticMeshResources.h"
+#include "SceneManagement.h"
+#include "RenderingThread.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInterface.h"
+#include "Engine/Engine.h"
+#include "Engine/CollisionProfile.h"
+
+static constexpr int32 DomainCount = static_cast<int32>(ETransformationDomain::TD_XYZ) + 1;
+
+//Segments around the tube of a Ring
+static constexpr int32 RingTubeSegments = 6;
+
+/**
+ * Keeps the Handles as a single Mesh, built and uploaded once, and submits it as one Mesh Batch per View.
+ * Each Vertex remembers its Domain, so highlighting only rewrites the Vertex Color Buffer.
+ */
+class FGizmoRenderSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+
+	FGizmoRenderSceneProxy(const UGizmoRenderComponent* Component, const TArray<FGizmoRenderShape>& Shapes
+	                       , UMaterialInterface* Material)
+		: FPrimitiveSceneProxy(Component)
+		, MaterialRenderProxy(Material->GetRenderProxy())
+		, MaterialRelevance(Material->GetRelevance_Concurrent(GetScene().GetFeatureLevel()))
+		, HighlightedDomain(Component->GetHighlightedDomain())
+		, bViewScaling(Component->bViewScaling)
+		, ViewScaleFactor(Component->ViewScaleFactor)
+		, ViewArcRadius(Component->ViewArcRadius)
+		, bMirrorAxesToView(Component->bMirrorAxesToView)
+		, bMirrorFrozen(Component->bMirrorFrozen)
+		, FrozenMirror(Component->FrozenMirror)
+		, VertexFactory(GetScene().GetFeatureLevel(), "FGizmoRenderSceneProxy")
+	{
+		for (int32 i = 0; i < DomainCount; ++i)
+			DomainColors[i] = Component->GetDomainColor(static_cast<ETransformationDomain>(i)).ToFColor(true);
+		HighlightColor = Component->HighlightColor.ToFColor(true);
+
+		const int32 segments = FMath::Max(Component->CircleSegments, 4);
+		for (const FGizmoRenderShape& shape : Shapes)
+		{
+			switch (shape.Type)
+			{
+			case FGizmoRenderShape::EType::Box:
+				AddBox(shape);
+				break;
+			case FGizmoRenderShape::EType::Sphere:
+				AddSphere(shape, segments);
+				break;
+			case FGizmoRenderShape::EType::Ring:
+				AddRing(shape, segments);
+				break;
+			}
+		}
+
+		if (Vertices.Num() == 0 || Indices.Num() == 0) return;
+
+		for (int32 i = 0; i < Vertices.Num(); ++i)
+			Vertices[i].Color = GetVertexColor(i);
+
+		//only the Domains are kept, the rest lives in the Buffers
+		IndexBuffer.Indices = MoveTemp(Indices);
+		VertexBuffers.InitFromDynamicVertex(&VertexFactory, Vertices);
+		Vertices.Empty();
+
+		BeginInitResource(&VertexBuffers.PositionVertexBuffer);
+		BeginInitResource(&VertexBuffers.StaticMeshVertexBuffer);
+		BeginInitResource(&VertexBuffers.ColorVertexBuffer);
+		BeginInitResource(&IndexBuffer);
+		BeginInitResource(&VertexFactory);
+		bHasMesh = true;
+	}
+
+	virtual ~FGizmoRenderSceneProxy() override
+	{
+		VertexBuffers.PositionVertexBuffer.ReleaseResource();
+		VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+		VertexBuffers.ColorVertexBuffer.ReleaseResource();
+		IndexBuffer.ReleaseResource();
+		VertexFactory.ReleaseResource();
+	}
+
+	void SetHighlightedDomain_RenderThread(ETransformationDomain Domain)
+	{
+		check(IsInRenderingThread());
+		HighlightedDomain = Domain;
+		if (!bHasMesh) return;
+
+		FColorVertexBuffer& colorBuffer = VertexBuffers.ColorVertexBuffer;
+		for (int32 i = 0; i < VertexDomains.Num(); ++i)
+			colorBuffer.VertexColor(i) = GetVertexColor(i);
+
+		const uint32 size = colorBuffer.GetNumVertices() * colorBuffer.GetStride();
+		void* data = RHILockVertexBuffer(colorBuffer.VertexBufferRHI, 0, size, RLM_WriteOnly);
+		FMemory::Memcpy(data, colorBuffer.GetVertexData(), size);
+		RHIUnlockVertexBuffer(colorBuffer.VertexBufferRHI);
+	}
+
+	void SetFrozenMirror_RenderThread(bool bFrozen, const FVector& Mirror)
+	{
+		check(IsInRenderingThread());
+		bMirrorFrozen = bFrozen;
+		FrozenMirror = Mirror;
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily
+	                                    , uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		if (!bHasMesh) return;
+
+		for (int32 viewIndex = 0; viewIndex < Views.Num(); ++viewIndex)
+		{
+			if (!(VisibilityMap & (1 << viewIndex))) continue;
+
+			const FSceneView* view = Views[viewIndex];
+
+			//all the Handles go in the same batch
+			FMeshBatch& mesh = Collector.AllocateMesh();
+			mesh.VertexFactory = &VertexFactory;
+			mesh.MaterialRenderProxy = MaterialRenderProxy;
+			mesh.Type = PT_TriangleList;
+			mesh.DepthPriorityGroup = GetDepthPriorityGroup(view);
+			mesh.bDisableBackfaceCulling = true;
+			mesh.bCanApplyViewModeOverrides = false;
+
+			FMeshBatchElement& element = mesh.Elements[0];
+			element.IndexBuffer = &IndexBuffer;
+			element.FirstIndex = 0;
+			element.NumPrimitives = IndexBuffer.Indices.Num() / 3;
+			element.MinVertexIndex = 0;
+			element.MaxVertexIndex = VertexBuffers.PositionVertexBuffer.GetNumVertices() - 1;
+
+			//only the Transform changes per View, the Buffers are shared
+			if (bViewScaling)
+			{
+				const FMatrix localToWorld = GetViewLocalToWorld(view);
+				FDynamicPrimitiveUniformBuffer& uniformBuffer
+					= Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+				uniformBuffer.Set(localToWorld, localToWorld, GetBounds(), GetLocalBounds(), false, false
+				                  , false, false);
+				element.PrimitiveUniformBufferResource = &uniformBuffer.UniformBuffer;
+			}
+			else
+				element.PrimitiveUniformBuffer = GetUniformBuffer();
+
+			Collector.AddMesh(viewIndex, mesh);
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance result;
+		result.bDrawRelevance = IsShown(View);
+		result.bDynamicRelevance = true;
+		result.bShadowRelevance = false;
+		result.bRenderInMainPass = ShouldRenderInMainPass();
+		result.bRenderCustomDepth = ShouldRenderCustomDepth();
+		MaterialRelevance.SetPrimitiveViewRelevance(result);
+		return result;
+	}
+
+	virtual uint32 GetMemoryFootprint() const override
+	{
+		return sizeof(*this) + GetAllocatedSize() + IndexBuffer.Indices.GetAllocatedSize()
+			+ VertexDomains.GetAllocatedSize();
+	}
+
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+private:
+
+	FMatrix GetViewLocalToWorld(const FSceneView* View) const
+	{
+		const FMatrix& localToWorld = GetLocalToWorld();
+		if (!bViewScaling) return localToWorld;
+
+		const FVector pivot = localToWorld.GetOrigin();
+		const FVector viewLocation = View->ViewMatrices.GetViewOrigin();
+
+		//the horizontal Field of View, out of the Projection
+		float fieldOfView = 90.f;
+		if (View->IsPerspectiveProjection())
+		{
+			const FMatrix& projection = View->ViewMatrices.GetProjectionMatrix();
+			fieldOfView = FMath::RadiansToDegrees(2.f * FMath::Atan(1.f / projection.M[0][0]));
+		}
+
+		FVector scale(ABaseGizmo::ComputeViewScale(pivot, viewLocation, View->GetViewDirection(), fieldOfView
+		                                           , ViewScaleFactor, ViewArcRadius));
+
+		if (bMirrorAxesToView)
+		{
+			FVector mirror = FrozenMirror;
+			if (!bMirrorFrozen)
+			{
+				const FVector toView = viewLocation - pivot;
+				for (int32 axis = 0; axis < 3; ++axis)
+				{
+					const EAxis::Type axisType = static_cast<EAxis::Type>(EAxis::X + axis);
+					mirror[axis] = FVector::DotProduct(localToWorld.GetUnitAxis(axisType), toView) >= 0.f ? 1.f : -1.f;
+				}
+			}
+			scale *= mirror;
+		}
+
+		return FScaleMatrix(scale) * localToWorld;
+	}
+
+	void AddVertex(const FGizmoRenderShape& Shape, const FVector& LocalPosition, const FVector& LocalNormal)
+	{
+		const FVector normal = Shape.Transform.TransformVectorNoScale(LocalNormal);
+		const FVector up = FMath::Abs(normal.Z) < 0.999f ? FVector::UpVector : FVector::ForwardVector;
+		const FVector tangentX = FVector::CrossProduct(up, normal).GetSafeNormal();
+		Vertices.Emplace(Shape.Transform.TransformPosition(LocalPosition), tangentX, normal
+		                 , FVector2D::ZeroVector, FColor::White);
+		VertexDomains.Add(Shape.Domain);
+	}
+
+	void AddQuad(int32 A, int32 B, int32 C, int32 D)
+	{
+		Indices.Append({ static_cast<uint32>(A), static_cast<uint32>(B), static_cast<uint32>(C)
+		                 , static_cast<uint32>(A), static_cast<uint32>(C), static_cast<uint32>(D) });
+	}
+
+	void AddBox(const FGizmoRenderShape& Shape)
+	{
+		const FVector faceNormals[6] = {
+			FVector::ForwardVector, FVector::BackwardVector,
+			FVector::RightVector, FVector::LeftVector,
+			FVector::UpVector, FVector::DownVector
+		};
+
+		for (const FVector& normal : faceNormals)
+		{
+			//two axes on the face
+			const FVector u(normal.Z, normal.X, normal.Y);
+			const FVector v = normal ^ u;
+
+			const int32 first = Vertices.Num();
+			AddVertex(Shape, (normal - u - v) * Shape.Size, normal);
+			AddVertex(Shape, (normal + u - v) * Shape.Size, normal);
+			AddVertex(Shape, (normal + u + v) * Shape.Size, normal);
+			AddVertex(Shape, (normal - u + v) * Shape.Size, normal);
+			AddQuad(first, first + 1, first + 2, first + 3);
+		}
+	}
+
+	void AddSphere(const FGizmoRenderShape& Shape, int32 Segments)
+	{
+		const int32 rings = Segments / 2;
+		const int32 first = Vertices.Num();
+
+		for (int32 ring = 0; ring <= rings; ++ring)
+		{
+			const float theta = PI * ring / rings;
+			for (int32 segment = 0; segment <= Segments; ++segment)
+			{
+				const float phi = 2.f * PI * segment / Segments;
+				const FVector normal(FMath::Sin(theta) * FMath::Cos(phi), FMath::Sin(theta) * FMath::Sin(phi)
+				                     , FMath::Cos(theta));
+				AddVertex(Shape, normal * Shape.Size.X, normal);
+			}
+		}
+
+		const int32 stride = Segments + 1;
+		for (int32 ring = 0; ring < rings; ++ring)
+		{
+			for (int32 segment = 0; segment < Segments; ++segment)
+			{
+				const int32 a = first + ring * stride + segment;
+				AddQuad(a, a + stride, a + stride + 1, a + 1);
+			}
+		}
+	}
+
+	void AddRing(const FGizmoRenderShape& Shape, int32 Segments)
+	{
+		const float radius = Shape.Size.X;
+		const float tubeRadius = Shape.Size.Y * 0.5f;
+		const int32 first = Vertices.Num();
+
+		for (int32 segment = 0; segment <= Segments; ++segment)
+		{
+			const float angle = 2.f * PI * segment / Segments;
+			const FVector direction(0.f, FMath::Cos(angle), FMath::Sin(angle));
+			for (int32 tubeSegment = 0; tubeSegment <= RingTubeSegments; ++tubeSegment)
+			{
+				const float tubeAngle = 2.f * PI * tubeSegment / RingTubeSegments;
+				const FVector normal = direction * FMath::Cos(tubeAngle) + FVector::ForwardVector * FMath::Sin(tubeAngle);
+				AddVertex(Shape, direction * radius + normal * tubeRadius, normal);
+			}
+		}
+
+		const int32 stride = RingTubeSegments + 1;
+		for (int32 segment = 0; segment < Segments; ++segment)
+		{
+			for (int32 tubeSegment = 0; tubeSegment < RingTubeSegments; ++tubeSegment)
+			{
+				const int32 a = first + segment * stride + tubeSegment;
+				AddQuad(a, a + stride, a + stride + 1, a + 1);
+			}
+		}
+	}
+
+	FColor GetVertexColor(int32 Index) const
+	{
+		const ETransformationDomain domain = VertexDomains[Index];
+		return (domain != ETransformationDomain::TD_None && domain == HighlightedDomain)
+			       ? HighlightColor
+			       : DomainColors[static_cast<int32>(domain)];
+	}
+
+	FMaterialRenderProxy* MaterialRenderProxy;
+	FMaterialRelevance MaterialRelevance;
+
+	//only used while the Mesh is built, then moved into the Buffers
+	TArray<FDynamicMeshVertex> Vertices;
+	TArray<uint32> Indices;
+
+	//the Domain of each Vertex
+	TArray<ETransformationDomain> VertexDomains;
+
+	FColor DomainColors[DomainCount];
+	FColor HighlightColor;
+	ETransformationDomain HighlightedDomain;
+
+	bool bViewScaling;
+	float ViewScaleFactor;
+	float ViewArcRadius;
+	bool bMirrorAxesToView;
+	bool bMirrorFrozen;
+	FVector FrozenMirror;
+
+	FStaticMeshVertexBuffers VertexBuffers;
+	FDynamicMeshIndexBuffer32 IndexBuffer;
+	FLocalVertexFactory VertexFactory;
+	bool bHasMesh = false;
+};
+
+UGizmoRenderComponent::UGizmoRenderComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	SetGenerateOverlapEvents(false);
+	CastShadow = false;
+	bUseAsOccluder = false;
+
+	XColor = FLinearColor(1.f, 0.1f, 0.1f);
+	YColor = FLinearColor(0.1f, 1.f, 0.1f);
+	ZColor = FLinearColor(0.1f, 0.1f, 1.f);
+	XYZColor = FLinearColor(0.8f, 0.8f, 0.8f);
+	HighlightColor = FLinearColor(1.f, 1.f, 0.f);
+	HandleMaterial = nullptr;
+	CircleSegments = 24;
+	HighlightedDomain = ETransformationDomain::TD_None;
+	bViewScaling = false;
+	ViewScaleFactor = 1.f;
+	ViewArcRadius = 1.f;
+	bMirrorAxesToView = false;
+	bMirrorFrozen = false;
+	FrozenMirror = FVector::OneVector;
+}
+
+void UGizmoRenderComponent::SetShapes(TArray<FGizmoRenderShape>&& InShapes)
+{
+	Shapes = MoveTemp(InShapes);
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UGizmoRenderComponent::SetHighlightedDomain(ETransformationDomain Domain)
+{
+	if (HighlightedDomain == Domain) return;
+	HighlightedDomain = Domain;
+
+	//no need to recreate the Proxy just to recolor it
+	if (SceneProxy)
+	{
+		FGizmoRenderSceneProxy* proxy = static_cast<FGizmoRenderSceneProxy*>(SceneProxy);
+		ENQUEUE_RENDER_COMMAND(SetGizmoHighlightedDomain)(
+			[proxy, Domain](FRHICommandListImmediate& RHICmdList)
+			{
+				proxy->SetHighlightedDomain_RenderThread(Domain);
+			});
+	}
+}
+
+void UGizmoRenderComponent::SetViewScaling(bool bEnabled, float ScaleFactor, float ArcRadius, bool bMirrorAxes)
+{
+	bViewScaling = bEnabled;
+	ViewScaleFactor = ScaleFactor;
+	ViewArcRadius = FMath::Max(ArcRadius, KINDA_SMALL_NUMBER);
+	bMirrorAxesToView = bMirrorAxes;
+	UpdateBounds();
+	MarkRenderStateDirty();
+}
+
+void UGizmoRenderComponent::SetFrozenMirror(bool bFrozen, const FVector& Mirror)
+{
+	//only pushed when it changes, as this is called whenever the Gizmo would have been rescaled
+	if (bMirrorFrozen == bFrozen && (!bFrozen || FrozenMirror == Mirror)) return;
+	bMirrorFrozen = bFrozen;
+	FrozenMirror = Mirror;
+
+	if (SceneProxy)
+	{
+		FGizmoRenderSceneProxy* proxy = static_cast<FGizmoRenderSceneProxy*>(SceneProxy);
+		ENQUEUE_RENDER_COMMAND(SetGizmoFrozenMirror)(
+			[proxy, bFrozen, Mirror](FRHICommandListImmediate& RHICmdList)
+			{
+				proxy->SetFrozenMirror_RenderThread(bFrozen, Mirror);
+			});
+	}
+}
+
+FLinearColor UGizmoRenderComponent::GetDomainColor(ETransformationDomain Domain) const
+{
+	switch (Domain)
+	{
+	case ETransformationDomain::TD_X_Axis: return XColor;
+	case ETransformationDomain::TD_Y_Axis: return YColor;
+	case ETransformationDomain::TD_Z_Axis: return ZColor;
+	case ETransformationDomain::TD_XY_Plane: return (XColor + YColor) * 0.5f;
+	case ETransformationDomain::TD_YZ_Plane: return (YColor + ZColor) * 0.5f;
+	case ETransformationDomain::TD_XZ_Plane: return (XColor + ZColor) * 0.5f;
+	case ETransformationDomain::TD_XYZ: return XYZColor;
+	default: return FLinearColor::White;
+	}
+}
+
+FPrimitiveSceneProxy* UGizmoRenderComponent::CreateSceneProxy()
+{
+	UMaterialInterface* material = GetHandleMaterial();
+	if (Shapes.Num() == 0 || !material)
+		return nullptr;
+	return new FGizmoRenderSceneProxy(this, Shapes, material);
+}
+
+void UGizmoRenderComponent::GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials
+                                             , bool bGetDebugMaterials) const
+{
+	if (UMaterialInterface* material = GetHandleMaterial())
+		OutMaterials.Add(material);
+}
+
+FBoxSphereBounds UGizmoRenderComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	//the size depends on the View, so it is never culled
+	if (bViewScaling && Shapes.Num() > 0)
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector(HALF_WORLD_MAX), HALF_WORLD_MAX);
+
+	FBox bounds(ForceInit);
+	for (const FGizmoRenderShape& shape : Shapes)
+	{
+		FVector extent = shape.Size;
+		if (shape.Type == FGizmoRenderShape::EType::Sphere)
+			extent = FVector(shape.Size.X);
+		else if (shape.Type == FGizmoRenderShape::EType::Ring)
+			extent = FVector(shape.Size.X + shape.Size.Y * 0.5f);
+
+		bounds += FBox(-extent, extent).TransformBy(shape.Transform);
+	}
+
+	if (!bounds.IsValid)
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+	return FBoxSphereBounds(bounds.TransformBy(LocalToWorld));
+}
+
+UMaterialInterface* UGizmoRenderComponent::GetHandleMaterial() const
+{
+	if (HandleMaterial)
+		return HandleMaterial;
+	if (GEngine && GEngine->VertexColorMaterial)
+		return GEngine->VertexColorMaterial;
+	return UMaterial::GetDefaultMaterial(MD_Surface);
+}
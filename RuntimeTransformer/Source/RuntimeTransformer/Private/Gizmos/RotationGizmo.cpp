@@ -1,10 +1,91 @@
 // Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
 
 #include "Gizmos/RotationGizmo.h"
+#include "Gizmos/GizmoRenderComponent.h"
 
 ARotationGizmo::ARotationGizmo()
 {
 	PreviousRotationViewScale = FVector::OneVector;
+	RingPickRadius = 0.f;
+	RingPickThickness = 10.f;
+	bMirrorAxesToView = true;
+}
+
+ETransformationDomain ARotationGizmo::PickDomain(const FVector& RayOrigin, const FVector& RayDirection
+	, float& outDistance) const
+{
+	if (RingPickRadius <= 0.f || !ScalingScene)
+		return Super::PickDomain(RayOrigin, RayDirection, outDistance);
+
+	ETransformationDomain pickedDomain = ETransformationDomain::TD_None;
+	outDistance = BIG_NUMBER;
+
+	FVector rayOrigin, rayDirection;
+	float rayScale;
+	GetPickRay(RayOrigin, RayDirection, rayOrigin, rayDirection, rayScale);
+
+	//In Scaling Scene space the Rings are centered at the origin. The ray parameter is the same in both spaces
+	const FTransform& sceneTransform = ScalingScene->GetComponentTransform();
+	const FVector localOrigin = sceneTransform.InverseTransformPosition(rayOrigin);
+	const FVector localDirection = sceneTransform.InverseTransformVector(rayDirection);
+	const float halfThickness = RingPickThickness * 0.5f;
+
+	const ETransformationDomain axisDomains[3] = {
+		ETransformationDomain::TD_X_Axis,
+		ETransformationDomain::TD_Y_Axis,
+		ETransformationDomain::TD_Z_Axis
+	};
+
+	for (int32 axis = 0; axis < 3; ++axis)
+	{
+		//the Ring of this Axis lies on the plane where this coordinate is 0
+		if (FMath::IsNearlyZero(localDirection[axis])) continue;
+
+		const float distance = -localOrigin[axis] / localDirection[axis];
+		if (distance < 0.f || distance >= outDistance) continue;
+
+		FVector pointOnPlane = localOrigin + localDirection * distance;
+		pointOnPlane[axis] = 0.f;
+
+		if (FMath::Abs(pointOnPlane.Size() - RingPickRadius) <= halfThickness)
+		{
+			outDistance = distance;
+			pickedDomain = axisDomains[axis];
+		}
+	}
+
+	if (pickedDomain != ETransformationDomain::TD_None)
+		outDistance *= rayScale;
+	return pickedDomain;
+}
+
+void ARotationGizmo::GetRenderShapes(TArray<FGizmoRenderShape>& outShapes) const
+{
+	if (RingPickRadius <= 0.f)
+	{
+		Super::GetRenderShapes(outShapes);
+		return;
+	}
+
+	const ETransformationDomain axisDomains[3] = {
+		ETransformationDomain::TD_X_Axis,
+		ETransformationDomain::TD_Y_Axis,
+		ETransformationDomain::TD_Z_Axis
+	};
+
+	for (int32 axis = 0; axis < 3; ++axis)
+	{
+		FVector normal = FVector::ZeroVector;
+		normal[axis] = 1.f;
+
+		//the Ring Shape lies on the plane perpendicular to its X Axis
+		FGizmoRenderShape renderShape;
+		renderShape.Type = FGizmoRenderShape::EType::Ring;
+		renderShape.Domain = axisDomains[axis];
+		renderShape.Transform = FTransform(FRotationMatrix::MakeFromX(normal).ToQuat());
+		renderShape.Size = FVector(RingPickRadius, RingPickThickness, 0.f);
+		outShapes.Add(renderShape);
+	}
 }
 
 FVector ARotationGizmo::CalculateGizmoSceneScale(const FVector& ReferenceLocation
@@ -0,0 +1,65 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "InstanceSet.h"
+
+FInstanceSet::FInstanceSet()
+{
+	Count = 0;
+	LastAdded = INDEX_NONE;
+}
+
+bool FInstanceSet::Add(int32 Instance)
+{
+	if (Instance < 0) return false;
+
+	if (Instance >= Bits.Num())
+		Bits.Add(false, Instance + 1 - Bits.Num());
+	else if (Bits[Instance])
+		return false;
+
+	Bits[Instance] = true;
+	++Count;
+	LastAdded = Instance;
+	return true;
+}
+
+bool FInstanceSet::Remove(int32 Instance)
+{
+	if (!Contains(Instance)) return false;
+
+	Bits[Instance] = false;
+	--Count;
+	if (LastAdded == Instance)
+		LastAdded = INDEX_NONE;
+	return true;
+}
+
+void FInstanceSet::Relocate(int32 OldInstance, int32 NewInstance)
+{
+	//Add overwrites it, and the Last Added is only moved along if it was the one Relocated
+	const int32 lastAdded = LastAdded;
+	if (!Remove(OldInstance)) return;
+
+	Add(NewInstance);
+	LastAdded = lastAdded == OldInstance ? NewInstance : lastAdded;
+}
+
+bool FInstanceSet::Contains(int32 Instance) const
+{
+	return Instance >= 0 && Instance < Bits.Num() && Bits[Instance];
+}
+
+void FInstanceSet::Empty()
+{
+	Bits.Empty();
+	Count = 0;
+	LastAdded = INDEX_NONE;
+}
+
+void FInstanceSet::GetInstances(TArray<int32>& outInstances) const
+{
+	outInstances.Reset(Count);
+	for (TConstSetBitIterator<> it(Bits); it; ++it)
+		outInstances.Add(it.GetIndex());
+}
@@ -0,0 +1,263 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "LayoutSnapshot.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+
+//"RTLY"
+static constexpr uint32 LayoutMagic = 0x594C5452;
+static constexpr uint16 LayoutVersion = 1;
+
+//Steps per Unit
+static constexpr float LayoutLocationQuantization = 100.f;
+static constexpr float LayoutScaleQuantization = 1000.f;
+static constexpr float LayoutRotationQuantization = 32767.f;
+
+enum ELayoutEntryFlags : uint8
+{
+	LEF_Class = 1 << 0,
+	LEF_Scale = 1 << 1,
+};
+
+static void WritePackedInt(FArchive& Ar, int32 Value)
+{
+	//Zig-Zag, so small negative values stay small
+	uint32 zigZag = (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	Ar.SerializeIntPacked(zigZag);
+}
+
+static int32 ReadPackedInt(FArchive& Ar)
+{
+	uint32 zigZag = 0;
+	Ar.SerializeIntPacked(zigZag);
+	return static_cast<int32>(zigZag >> 1) ^ -static_cast<int32>(zigZag & 1);
+}
+
+static void WriteQuantizedVector(FArchive& Ar, const FVector& Value, float Quantization)
+{
+	//clamped so that it can't overflow once Zig-Zagged
+	const float limit = (MAX_int32 >> 1) / Quantization;
+	for (int32 i = 0; i < 3; ++i)
+		WritePackedInt(Ar, FMath::RoundToInt(FMath::Clamp(Value[i], -limit, limit) * Quantization));
+}
+
+static FVector ReadQuantizedVector(FArchive& Ar, float Quantization)
+{
+	FVector outValue;
+	for (int32 i = 0; i < 3; ++i)
+		outValue[i] = ReadPackedInt(Ar) / Quantization;
+	return outValue;
+}
+
+void FLayoutWriter::Write(const TArray<FLayoutEntry>& Entries, TArray<uint8>& outData)
+{
+	TArray<FString> strings;
+	TMap<FString, uint32> stringIndex;
+	auto getStringIndex = [&strings, &stringIndex](const FString& String)
+	{
+		if (const uint32* index = stringIndex.Find(String))
+			return *index;
+		const uint32 index = strings.Add(String);
+		stringIndex.Add(String, index);
+		return index;
+	};
+
+	//the String Table goes before the Entries, so gather it first
+	TArray<uint32> assetIndices;
+	TArray<uint32> classIndices;
+	assetIndices.Reserve(Entries.Num());
+	classIndices.Reserve(Entries.Num());
+	for (const FLayoutEntry& entry : Entries)
+	{
+		assetIndices.Add(getStringIndex(entry.Path.GetAssetPathString()));
+		classIndices.Add(entry.ActorClass.IsValid() ? getStringIndex(entry.ActorClass.ToString()) : 0);
+	}
+
+	outData.Reset();
+	FMemoryWriter writer(outData);
+
+	uint32 magic = LayoutMagic;
+	uint16 version = LayoutVersion;
+	writer << magic;
+	writer << version;
+
+	uint32 numStrings = strings.Num();
+	writer.SerializeIntPacked(numStrings);
+	for (FString& string : strings)
+		writer << string;
+
+	uint32 numEntries = Entries.Num();
+	writer.SerializeIntPacked(numEntries);
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FLayoutEntry& entry = Entries[i];
+		const FTransform& transform = entry.Transform;
+		const bool bScale = !transform.GetScale3D().Equals(FVector::OneVector, 0.5f / LayoutScaleQuantization);
+
+		uint8 flags = (entry.ActorClass.IsValid() ? LEF_Class : 0) | (bScale ? LEF_Scale : 0);
+		writer << flags;
+
+		writer.SerializeIntPacked(assetIndices[i]);
+		FString subPath = entry.Path.GetSubPathString();
+		writer << subPath;
+		if (flags & LEF_Class)
+			writer.SerializeIntPacked(classIndices[i]);
+
+		WriteQuantizedVector(writer, transform.GetLocation(), LayoutLocationQuantization);
+
+		const FQuat rotation = transform.GetRotation().GetNormalized();
+		int16 rotationComponents[4] = {
+			static_cast<int16>(FMath::RoundToInt(rotation.X * LayoutRotationQuantization)),
+			static_cast<int16>(FMath::RoundToInt(rotation.Y * LayoutRotationQuantization)),
+			static_cast<int16>(FMath::RoundToInt(rotation.Z * LayoutRotationQuantization)),
+			static_cast<int16>(FMath::RoundToInt(rotation.W * LayoutRotationQuantization)),
+		};
+		for (int16& component : rotationComponents)
+			writer << component;
+
+		if (bScale)
+			WriteQuantizedVector(writer, transform.GetScale3D(), LayoutScaleQuantization);
+	}
+}
+
+FLayoutReader::FLayoutReader()
+{
+	NumEntries = 0;
+	EntriesRead = 0;
+	bError = false;
+}
+
+FLayoutReader::~FLayoutReader()
+{
+}
+
+bool FLayoutReader::Open(const uint8* Data, int64 Size)
+{
+	Reader.Reset();
+	Strings.Reset();
+	NumEntries = 0;
+	EntriesRead = 0;
+	bError = true;
+
+	if (!Data || Size <= 0) return false;
+
+	//only read from, and not freed on close
+	Reader = MakeUnique<FBufferReader>(const_cast<uint8*>(Data), Size, false);
+
+	//so a corrupt String length errors out instead of allocating more than the whole Data
+	Reader->ArMaxSerializeSize = Size;
+
+	uint32 magic = 0;
+	uint16 version = 0;
+	*Reader << magic;
+	*Reader << version;
+	if (Reader->IsError() || magic != LayoutMagic || version > LayoutVersion)
+	{
+		Reader.Reset();
+		return false;
+	}
+
+	//every String and Entry takes at least a byte, so a corrupt count can't make it allocate more than the Data either
+	uint32 numStrings = 0;
+	Reader->SerializeIntPacked(numStrings);
+	if (Reader->IsError() || numStrings > Size) return false;
+
+	Strings.SetNum(numStrings);
+	for (FString& string : Strings)
+		*Reader << string;
+
+	uint32 numEntries = 0;
+	Reader->SerializeIntPacked(numEntries);
+	if (Reader->IsError() || numEntries > Size) return false;
+
+	NumEntries = numEntries;
+	bError = false;
+	return true;
+}
+
+bool FLayoutReader::ReadEntry(FLayoutEntry& outEntry)
+{
+	if (!Reader || bError || IsDone()) return false;
+
+	uint8 flags = 0;
+	*Reader << flags;
+
+	uint32 assetIndex = 0;
+	Reader->SerializeIntPacked(assetIndex);
+	FString subPath;
+	*Reader << subPath;
+
+	uint32 classIndex = 0;
+	if (flags & LEF_Class)
+		Reader->SerializeIntPacked(classIndex);
+
+	const FVector location = ReadQuantizedVector(*Reader, LayoutLocationQuantization);
+
+	int16 rotationComponents[4] = {0, 0, 0, 0};
+	for (int16& component : rotationComponents)
+		*Reader << component;
+
+	const FVector scale = (flags & LEF_Scale)
+		                      ? ReadQuantizedVector(*Reader, LayoutScaleQuantization)
+		                      : FVector::OneVector;
+
+	if (Reader->IsError() || !Strings.IsValidIndex(assetIndex)
+		|| ((flags & LEF_Class) && !Strings.IsValidIndex(classIndex)))
+	{
+		bError = true;
+		return false;
+	}
+
+	outEntry.Path = FSoftObjectPath(FName(*Strings[assetIndex]), MoveTemp(subPath));
+	outEntry.ActorClass = (flags & LEF_Class) ? FSoftClassPath(Strings[classIndex]) : FSoftClassPath();
+
+	FQuat rotation(rotationComponents[0], rotationComponents[1], rotationComponents[2], rotationComponents[3]);
+	rotation.Normalize();
+	outEntry.Transform = FTransform(rotation, location, scale);
+
+	++EntriesRead;
+	return true;
+}
+
+bool FLayoutReader::IsError() const
+{
+	return bError || !Reader || Reader->IsError();
+}
+
+FLayoutImport::FLayoutImport()
+{
+	NumPlaced = 0;
+}
+
+FLayoutImport::~FLayoutImport()
+{
+}
+
+bool FLayoutImport::OpenData(TArray<uint8>&& InData)
+{
+	Data = MoveTemp(InData);
+	return Reader.Open(Data.GetData(), Data.Num());
+}
+
+bool FLayoutImport::OpenFile(const FString& FilePath)
+{
+	IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+	MappedFile.Reset(platformFile.OpenMapped(*FilePath));
+	if (MappedFile && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+		if (MappedRegion)
+			return Reader.Open(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	}
+
+	MappedRegion.Reset();
+	MappedFile.Reset();
+
+	TArray<uint8> fileData;
+	if (!FFileHelper::LoadFileToArray(fileData, *FilePath)) return false;
+	return OpenData(MoveTemp(fileData));
+}
@@ -0,0 +1,109 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "MarqueeSelection.h"
+#include "SceneView.h"
+
+//Rectangles smaller than this (in pixels) are considered clicks rather than marquees
+static constexpr float MinMarqueeSize = 1.f;
+
+//Makes the Plane face away from the given point (i.e. outwards, if the point is inside)
+static FPlane MakeOutwardPlane(const FVector& A, const FVector& B, const FVector& C, const FVector& InsidePoint)
+{
+	FPlane plane(A, B, C);
+	return plane.PlaneDot(InsidePoint) > 0.f ? plane.Flip() : plane;
+}
+
+bool FMarqueeFrustum::Build(const FVector2D& CornerA, const FVector2D& CornerB
+                            , const FIntRect& InViewRect, const FMatrix& InViewProjectionMatrix, float Distance)
+{
+	RectMin = FVector2D(FMath::Min(CornerA.X, CornerB.X), FMath::Min(CornerA.Y, CornerB.Y));
+	RectMax = FVector2D(FMath::Max(CornerA.X, CornerB.X), FMath::Max(CornerA.Y, CornerB.Y));
+	if (RectMax.X - RectMin.X < MinMarqueeSize || RectMax.Y - RectMin.Y < MinMarqueeSize)
+		return false;
+
+	ViewRect = InViewRect;
+	ViewProjectionMatrix = InViewProjectionMatrix;
+	const FMatrix invViewProjectionMatrix = ViewProjectionMatrix.InverseFast();
+
+	//Corners in order around the Rectangle, so each consecutive pair makes a side
+	const FVector2D corners[4] = {
+		RectMin, FVector2D(RectMax.X, RectMin.Y), RectMax, FVector2D(RectMin.X, RectMax.Y)
+	};
+
+	FVector nearPoints[4];
+	FVector farPoints[4];
+	FVector forward = FVector::ZeroVector;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		FVector direction;
+		FSceneView::DeprojectScreenToWorld(corners[i], ViewRect, invViewProjectionMatrix, nearPoints[i], direction);
+		farPoints[i] = nearPoints[i] + direction * Distance;
+		forward += direction;
+	}
+
+	FVector center = FVector::ZeroVector;
+	for (int32 i = 0; i < 4; ++i)
+		center += nearPoints[i] + farPoints[i];
+	center /= 8.f;
+
+	Volume.Planes.Reset(6);
+	for (int32 i = 0; i < 4; ++i)
+		Volume.Planes.Add(MakeOutwardPlane(nearPoints[i], nearPoints[(i + 1) % 4], farPoints[i], center));
+	Volume.Planes.Add(MakeOutwardPlane(nearPoints[0], nearPoints[1], nearPoints[2], center));
+	Volume.Planes.Add(MakeOutwardPlane(farPoints[0], farPoints[1], farPoints[2], center));
+	Volume.Init();
+
+	//Box in Camera Space that encloses the 8 points of the Frustum
+	BoxRotation = FRotationMatrix::MakeFromX(forward.GetSafeNormal()).ToQuat();
+	FBox localBox(ForceInit);
+	for (int32 i = 0; i < 4; ++i)
+	{
+		localBox += BoxRotation.UnrotateVector(nearPoints[i]);
+		localBox += BoxRotation.UnrotateVector(farPoints[i]);
+	}
+	BoxCenter = BoxRotation.RotateVector(localBox.GetCenter());
+	BoxExtent = localBox.GetExtent();
+	return true;
+}
+
+bool FMarqueeFrustum::IsInside(const FBoxSphereBounds& Bounds, bool bFullyInside) const
+{
+	if (!Volume.IntersectBox(Bounds.Origin, Bounds.BoxExtent))
+		return false;
+
+	if (!bFullyInside)
+		return true;
+
+	FVector vertices[8];
+	Bounds.GetBox().GetVertices(vertices);
+	for (const FVector& vertex : vertices)
+	{
+		FVector2D screenPosition;
+		if (!FSceneView::ProjectWorldToScreen(vertex, ViewRect, ViewProjectionMatrix, screenPosition))
+			return false; //behind the Camera
+
+		if (screenPosition.X < RectMin.X || screenPosition.X > RectMax.X
+			|| screenPosition.Y < RectMin.Y || screenPosition.Y > RectMax.Y)
+			return false;
+	}
+	return true;
+}
+
+FMarqueeSelection::FMarqueeSelection()
+{
+	Reset();
+}
+
+void FMarqueeSelection::Reset()
+{
+	bActive = false;
+	ScreenStart = FVector2D::ZeroVector;
+	Distance = 0.f;
+	QueryType = EMarqueeQueryType::MQ_ObjectTypes;
+	ObjectQueryParams = FCollisionObjectQueryParams();
+	TraceChannel = ECollisionChannel::ECC_Visibility;
+	ProfileName = NAME_None;
+	IgnoredActors.Reset();
+	MarqueeSelected.Reset();
+}
@@ -0,0 +1,120 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "ObservedEditor.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/NetworkGuid.h"
+
+//no Update that big is sent, so anything past this is a malformed packet
+static constexpr uint32 MaxObservedComponents = 1 << 16;
+
+FObservedEditorState::FObservedEditorState()
+{
+	Editor = nullptr;
+	TransformationType = ETransformationType::TT_NoTransform;
+	SpaceType = ESpaceType::ST_None;
+	Domain = ETransformationDomain::TD_None;
+}
+
+FObservedEditorUpdate::FObservedEditorUpdate()
+{
+	Editor = nullptr;
+	bReset = false;
+	TransformationType = ETransformationType::TT_NoTransform;
+	SpaceType = ESpaceType::ST_None;
+	Domain = ETransformationDomain::TD_None;
+}
+
+static bool SerializeComponents(FArchive& Ar, TArray<USceneComponent*>& Components)
+{
+	uint32 num = Components.Num();
+	Ar.SerializeIntPacked(num);
+
+	if (Ar.IsLoading())
+	{
+		if (num > MaxObservedComponents)
+			return false;
+		Components.SetNumZeroed(num);
+	}
+
+	for (USceneComponent*& component : Components)
+	{
+		UObject* object = component;
+		Ar << object;
+		if (Ar.IsLoading())
+			component = Cast<USceneComponent>(object);
+	}
+	return true;
+}
+
+bool FObservedEditorUpdate::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	UObject* editor = Editor;
+	Ar << editor;
+
+	//2 bits for the Transformation & Space Types, 4 for the Domain
+	uint8 packed = static_cast<uint8>(TransformationType) | (static_cast<uint8>(SpaceType) << 2)
+		| (static_cast<uint8>(Domain) << 4);
+	Ar << packed;
+
+	uint8 reset = bReset ? 1 : 0;
+	Ar.SerializeBits(&reset, 1);
+
+	if (Ar.IsLoading())
+	{
+		Editor = Cast<APlayerState>(editor);
+		TransformationType = static_cast<ETransformationType>(packed & 0x3);
+		SpaceType = static_cast<ESpaceType>((packed >> 2) & 0x3);
+		Domain = static_cast<ETransformationDomain>(packed >> 4);
+		bReset = !!reset;
+	}
+
+	if (!SerializeComponents(Ar, AddedComponents) || !SerializeComponents(Ar, RemovedComponents))
+	{
+		bOutSuccess = false;
+		return false;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+void FObservedEditorUpdate::ApplyTo(FObservedEditorState& outState) const
+{
+	outState.Editor = Editor;
+	outState.TransformationType = TransformationType;
+	outState.SpaceType = SpaceType;
+	outState.Domain = Domain;
+
+	if (bReset)
+		outState.Components.Reset();
+
+	//the Components that can't be resolved in this Client (or are gone) are of no use to it
+	if (RemovedComponents.Num() > 0)
+	{
+		const TSet<USceneComponent*> removed(RemovedComponents);
+		outState.Components.RemoveAllSwap([&removed](USceneComponent* Component)
+		{
+			return !Component || removed.Contains(Component);
+		});
+	}
+
+	if (AddedComponents.Num() == 0) return;
+
+	TSet<USceneComponent*> known(outState.Components);
+	for (USceneComponent* component : AddedComponents)
+	{
+		bool bAlreadyKnown = false;
+		if (component)
+			known.Add(component, &bAlreadyKnown);
+		if (component && !bAlreadyKnown)
+			outState.Components.Add(component);
+	}
+}
+
+int32 FObservedEditorUpdate::GetParameterSize() const
+{
+	return sizeof(FNetworkGUID) * (AddedComponents.Num() + RemovedComponents.Num() + 1) + sizeof(uint8) * 2
+		+ sizeof(uint32) * 2;
+}
@@ -0,0 +1,99 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "ReplicatedSelection.h"
+#include "TransformerComponent.h"
+
+FReplicatedSelectionItem::FReplicatedSelectionItem()
+{
+	Component = nullptr;
+	AppliedComponent = nullptr;
+}
+
+void FReplicatedSelectionItem::PreReplicatedRemove(const FReplicatedSelectionList& InArraySerializer)
+{
+	if (InArraySerializer.Owner && AppliedComponent)
+		InArraySerializer.Owner->OnReplicatedDeselect(AppliedComponent);
+	AppliedComponent = nullptr;
+}
+
+void FReplicatedSelectionItem::PostReplicatedAdd(const FReplicatedSelectionList& InArraySerializer)
+{
+	//nullptr if not resolvable yet. PostReplicatedChange will be called once it is
+	if (InArraySerializer.Owner && Component)
+		InArraySerializer.Owner->OnReplicatedSelect(Component);
+	AppliedComponent = Component;
+}
+
+void FReplicatedSelectionItem::PostReplicatedChange(const FReplicatedSelectionList& InArraySerializer)
+{
+	if (AppliedComponent == Component) return;
+
+	if (InArraySerializer.Owner)
+	{
+		if (AppliedComponent)
+			InArraySerializer.Owner->OnReplicatedDeselect(AppliedComponent);
+		if (Component)
+			InArraySerializer.Owner->OnReplicatedSelect(Component);
+	}
+	AppliedComponent = Component;
+}
+
+FReplicatedSelectionList::FReplicatedSelectionList()
+{
+	Owner = nullptr;
+	bHasRemovals = false;
+}
+
+void FReplicatedSelectionList::Add(USceneComponent* Component)
+{
+	if (!Component) return;
+
+	if (int32* index = ItemIndex.Find(Component))
+	{
+		if (Items.IsValidIndex(*index) && Items[*index].Component == Component)
+			return; //already in the list
+
+		//the Item was nulled by the GC, so this is a stale entry (new object in the same address)
+		ItemIndex.Remove(Component);
+	}
+
+	const int32 index = Items.AddDefaulted();
+	Items[index].Component = Component;
+	ItemIndex.Add(Component, index);
+	MarkItemDirty(Items[index]);
+}
+
+void FReplicatedSelectionList::Remove(USceneComponent* Component)
+{
+	int32 index;
+	if (!ItemIndex.RemoveAndCopyValue(Component, index)) return;
+	if (!Items.IsValidIndex(index) || Items[index].Component != Component) return;
+
+	Items[index].Component = nullptr;
+	bHasRemovals = true;
+}
+
+void FReplicatedSelectionList::FlushRemovals()
+{
+	if (!bHasRemovals) return;
+	bHasRemovals = false;
+
+	Items.RemoveAll([](const FReplicatedSelectionItem& Item) { return !Item.Component; });
+
+	ItemIndex.Reset();
+	for (int32 i = 0; i < Items.Num(); ++i)
+		ItemIndex.Add(Items[i].Component, i);
+
+	MarkArrayDirty();
+}
+
+void FReplicatedSelectionList::Reset()
+{
+	if (Items.Num() == 0) return;
+
+	Items.Reset();
+	ItemIndex.Reset();
+	bHasRemovals = false;
+	MarkArrayDirty();
+}
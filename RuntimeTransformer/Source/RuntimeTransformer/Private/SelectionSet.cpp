@@ -0,0 +1,229 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "SelectionSet.h"
+#include "Components/SceneComponent.h"
+
+//Below this amount of slots it's not worth compacting
+static constexpr int32 MinSlotsToCompact = 32;
+
+FSelectionSet::FSelectionSet()
+{
+	FirstSlot = 0;
+	NumLive = 0;
+}
+
+bool FSelectionSet::Add(USceneComponent* Component, const FSelectionEntry& Entry)
+{
+	if (!Component) return false;
+
+	if (int32* slot = Index.Find(Component))
+	{
+		if (Components.IsValidIndex(*slot) && Components[*slot] == Component)
+			return false; //already selected
+
+		//the slot was nulled by the GC, so this is a stale entry (new object in the same address)
+		Index.Remove(Component);
+		NonRoots.Remove(Component);
+	}
+
+	Index.Add(Component, Components.Add(Component));
+	Entries.Add(Entry);
+	++NumLive;
+
+	if (HasSelectedAncestor(Component))
+		NonRoots.Add(Component);
+	else if (Index.Num() > 1)
+		SetDescendantsNonRoots(Component, true);
+	return true;
+}
+
+bool FSelectionSet::Remove(USceneComponent* Component)
+{
+	const bool bWasRoot = NonRoots.Remove(Component) == 0;
+
+	int32 slot;
+	if (!Index.RemoveAndCopyValue(Component, slot))
+		return false;
+
+	//the slot might have been nulled (and trimmed) already if the GC collected the Component
+	if (!Components.IsValidIndex(slot) || Components[slot] != Component)
+		return false;
+
+	Components[slot] = nullptr; //leave a tombstone
+	--NumLive;
+
+	//its nearest Selected descendants become Roots, as nothing above it was Selected either
+	if (bWasRoot && Index.Num() > 0)
+		SetDescendantsNonRoots(Component, false);
+
+	TrimTombstones();
+
+	const int32 tombstones = Components.Num() - NumLive;
+	if (Components.Num() >= MinSlotsToCompact && tombstones * 2 >= Components.Num())
+		Compact();
+
+	return true;
+}
+
+bool FSelectionSet::Contains(const USceneComponent* Component) const
+{
+	const int32* slot = Index.Find(Component);
+	return slot && Components.IsValidIndex(*slot) && Components[*slot] == Component;
+}
+
+const FSelectionEntry* FSelectionSet::FindEntry(const USceneComponent* Component) const
+{
+	const int32* slot = Index.Find(Component);
+	if (slot && Components.IsValidIndex(*slot) && Components[*slot] == Component)
+		return &Entries[*slot];
+	return nullptr;
+}
+
+void FSelectionSet::ForEachEntry(TFunctionRef<void(USceneComponent*, const FSelectionEntry&)> Function) const
+{
+	for (int32 i = FirstSlot; i < Components.Num(); ++i)
+	{
+		if (Components[i])
+			Function(Components[i], Entries[i]);
+	}
+}
+
+void FSelectionSet::ForEachRootEntry(TFunctionRef<void(USceneComponent*, const FSelectionEntry&)> Function) const
+{
+	for (int32 i = FirstSlot; i < Components.Num(); ++i)
+	{
+		if (Components[i] && !NonRoots.Contains(Components[i]))
+			Function(Components[i], Entries[i]);
+	}
+}
+
+void FSelectionSet::RebuildRoots()
+{
+	NonRoots.Reset();
+	for (USceneComponent* component : *this)
+	{
+		if (HasSelectedAncestor(component))
+			NonRoots.Add(component);
+	}
+}
+
+bool FSelectionSet::HasSelectedAncestor(const USceneComponent* Component) const
+{
+	for (const USceneComponent* parent = Component->GetAttachParent(); parent; parent = parent->GetAttachParent())
+	{
+		if (Contains(parent))
+			return true;
+	}
+	return false;
+}
+
+void FSelectionSet::SetDescendantsNonRoots(const USceneComponent* Component, bool bNonRoots)
+{
+	TArray<const USceneComponent*, TInlineAllocator<16>> pending;
+	pending.Append(Component->GetAttachChildren());
+	while (pending.Num() > 0)
+	{
+		const USceneComponent* child = pending.Pop(false);
+		if (!child) continue;
+
+		if (Contains(child))
+		{
+			if (bNonRoots)
+				NonRoots.Add(child);
+			else
+				NonRoots.Remove(child);
+			continue;
+		}
+		pending.Append(child->GetAttachChildren());
+	}
+}
+
+void FSelectionSet::Empty()
+{
+	Components.Reset();
+	Entries.Reset();
+	Index.Reset();
+	NonRoots.Reset();
+	FirstSlot = 0;
+	NumLive = 0;
+}
+
+void FSelectionSet::PruneCollected()
+{
+	int32 liveSlots = 0;
+	for (int32 i = FirstSlot; i < Components.Num(); ++i)
+	{
+		if (Components[i])
+			++liveSlots;
+	}
+
+	//the GC nulled out some slots, leaving their Index and Non Root entries behind (and the counter off)
+	if (liveSlots != NumLive)
+		Compact();
+}
+
+USceneComponent* FSelectionSet::First() const
+{
+	for (int32 i = FirstSlot; i < Components.Num(); ++i)
+	{
+		if (Components[i]) return Components[i];
+	}
+	return nullptr;
+}
+
+USceneComponent* FSelectionSet::Last() const
+{
+	for (int32 i = Components.Num() - 1; i >= FirstSlot; --i)
+	{
+		if (Components[i]) return Components[i];
+	}
+	return nullptr;
+}
+
+TArray<USceneComponent*> FSelectionSet::ToArray() const
+{
+	TArray<USceneComponent*> outComponents;
+	outComponents.Reserve(Index.Num());
+	for (USceneComponent* component : *this)
+		outComponents.Add(component);
+	return outComponents;
+}
+
+void FSelectionSet::Compact()
+{
+	int32 writeSlot = 0;
+	Index.Reset();
+	for (int32 readSlot = FirstSlot; readSlot < Components.Num(); ++readSlot)
+	{
+		if (USceneComponent* component = Components[readSlot])
+		{
+			Components[writeSlot] = component;
+			Entries[writeSlot] = Entries[readSlot];
+			Index.Add(component, writeSlot);
+			++writeSlot;
+		}
+	}
+	Components.SetNum(writeSlot, false);
+	Entries.SetNum(writeSlot, false);
+	FirstSlot = 0;
+	NumLive = writeSlot;
+
+	//the Components collected by the GC might have been ancestors of others
+	RebuildRoots();
+}
+
+void FSelectionSet::TrimTombstones()
+{
+	while (Components.Num() > 0 && !Components.Last())
+	{
+		Components.Pop(false);
+		Entries.Pop(false);
+	}
+
+	while (FirstSlot < Components.Num() && !Components[FirstSlot])
+		++FirstSlot;
+
+	if (Components.Num() == 0)
+		FirstSlot = 0;
+}
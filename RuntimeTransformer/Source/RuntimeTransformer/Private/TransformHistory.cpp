@@ -0,0 +1,440 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformHistory.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "Math/Float16.h"
+
+enum ETransformField : uint8
+{
+	TF_Location = 1 << 0,
+	TF_Rotation = 1 << 1,
+	TF_Scale = 1 << 2,
+};
+
+//Arenas smaller than this are never compacted, it's not worth the copy
+static constexpr int32 MinArenaSizeToCompact = 4096;
+
+static constexpr float QuatQuantizeScale = 32767.f;
+
+static int32 GetFieldsSize(uint8 FieldMask, bool bQuantized)
+{
+	int32 size = 0;
+	if (FieldMask & TF_Location)
+		size += sizeof(FVector);
+	if (FieldMask & TF_Rotation)
+		size += bQuantized ? 4 * sizeof(int16) : sizeof(FQuat);
+	if (FieldMask & TF_Scale)
+		size += bQuantized ? 3 * sizeof(FFloat16) : sizeof(FVector);
+	return size;
+}
+
+//Size of the Payload of every Object of the Operation
+static int32 GetItemSize(ETransformHistoryOperation Type, uint8 FieldMask, bool bQuantized)
+{
+	int32 size = sizeof(FWeakObjectPtr);
+	if (Type == ETransformHistoryOperation::Transform)
+		size += 2 * GetFieldsSize(FieldMask, bQuantized); //Before & After
+	return size;
+}
+
+template<typename T>
+static void WriteValue(uint8*& Data, const T& Value)
+{
+	FMemory::Memcpy(Data, &Value, sizeof(T));
+	Data += sizeof(T);
+}
+
+template<typename T>
+static T ReadValue(const uint8*& Data)
+{
+	T value;
+	FMemory::Memcpy(&value, Data, sizeof(T));
+	Data += sizeof(T);
+	return value;
+}
+
+static void WriteFields(uint8*& Data, const FTransform& Transform, uint8 FieldMask, bool bQuantized)
+{
+	if (FieldMask & TF_Location)
+		WriteValue(Data, Transform.GetLocation());
+
+	if (FieldMask & TF_Rotation)
+	{
+		const FQuat rotation = Transform.GetRotation().GetNormalized();
+		if (bQuantized)
+		{
+			WriteValue(Data, static_cast<int16>(FMath::RoundToInt(rotation.X * QuatQuantizeScale)));
+			WriteValue(Data, static_cast<int16>(FMath::RoundToInt(rotation.Y * QuatQuantizeScale)));
+			WriteValue(Data, static_cast<int16>(FMath::RoundToInt(rotation.Z * QuatQuantizeScale)));
+			WriteValue(Data, static_cast<int16>(FMath::RoundToInt(rotation.W * QuatQuantizeScale)));
+		}
+		else
+			WriteValue(Data, rotation);
+	}
+
+	if (FieldMask & TF_Scale)
+	{
+		const FVector scale = Transform.GetScale3D();
+		if (bQuantized)
+		{
+			WriteValue(Data, FFloat16(scale.X));
+			WriteValue(Data, FFloat16(scale.Y));
+			WriteValue(Data, FFloat16(scale.Z));
+		}
+		else
+			WriteValue(Data, scale);
+	}
+}
+
+//Overwrites only the fields in the Mask, the rest of the Transform is left as is
+static void ReadFields(const uint8*& Data, FTransform& Transform, uint8 FieldMask, bool bQuantized)
+{
+	if (FieldMask & TF_Location)
+		Transform.SetLocation(ReadValue<FVector>(Data));
+
+	if (FieldMask & TF_Rotation)
+	{
+		if (bQuantized)
+		{
+			FQuat rotation;
+			rotation.X = ReadValue<int16>(Data) / QuatQuantizeScale;
+			rotation.Y = ReadValue<int16>(Data) / QuatQuantizeScale;
+			rotation.Z = ReadValue<int16>(Data) / QuatQuantizeScale;
+			rotation.W = ReadValue<int16>(Data) / QuatQuantizeScale;
+			Transform.SetRotation(rotation.GetNormalized());
+		}
+		else
+			Transform.SetRotation(ReadValue<FQuat>(Data));
+	}
+
+	if (FieldMask & TF_Scale)
+	{
+		if (bQuantized)
+		{
+			FVector scale;
+			scale.X = ReadValue<FFloat16>(Data).GetFloat();
+			scale.Y = ReadValue<FFloat16>(Data).GetFloat();
+			scale.Z = ReadValue<FFloat16>(Data).GetFloat();
+			Transform.SetScale3D(scale);
+		}
+		else
+			Transform.SetScale3D(ReadValue<FVector>(Data));
+	}
+}
+
+FTransformHistory::FTransformHistory()
+	: Head(0)
+	, Count(0)
+	, Cursor(0)
+	, ArenaUsed(0)
+	, MemoryBudget(1024 * 1024)
+	, QuantizeAfter(16)
+{
+	Operations.SetNumUninitialized(128);
+}
+
+void FTransformHistory::Configure(int32 InMemoryBudget, int32 InMaxOperations, int32 InQuantizeAfter
+                                  , TArray<AActor*>& outReleasedActors)
+{
+	MemoryBudget = FMath::Max(InMemoryBudget, 0);
+	QuantizeAfter = FMath::Max(InQuantizeAfter, 0);
+
+	const int32 maxOperations = FMath::Max(InMaxOperations, 1);
+	while (Count > maxOperations)
+		DropOldest(outReleasedActors);
+
+	if (maxOperations != Operations.Num())
+	{
+		//Linearize the Ring into the new capacity
+		TArray<FOperation> operations;
+		operations.SetNumUninitialized(maxOperations);
+		for (int32 i = 0; i < Count; ++i)
+			operations[i] = GetOperation(i);
+		Operations = MoveTemp(operations);
+		Head = 0;
+	}
+
+	while (Count > 1 && ArenaUsed > MemoryBudget)
+		DropOldest(outReleasedActors);
+
+	QuantizeOldOperations();
+	CompactArena();
+}
+
+void FTransformHistory::RecordTransforms(const TArray<USceneComponent*>& Components
+                                         , const TArray<FTransform>& Before, const TArray<FTransform>& After
+                                         , TArray<AActor*>& outReleasedActors)
+{
+	const int32 num = FMath::Min3(Components.Num(), Before.Num(), After.Num());
+
+	//only the fields that changed for any of the Components are kept
+	uint8 fieldMask = 0;
+	int32 changedCount = 0;
+	for (int32 i = 0; i < num; ++i)
+	{
+		if (!Components[i])
+			continue;
+
+		uint8 componentMask = 0;
+		if (!Before[i].GetLocation().Equals(After[i].GetLocation()))
+			componentMask |= TF_Location;
+		if (!Before[i].GetRotation().Equals(After[i].GetRotation()))
+			componentMask |= TF_Rotation;
+		if (!Before[i].GetScale3D().Equals(After[i].GetScale3D()))
+			componentMask |= TF_Scale;
+
+		if (componentMask)
+		{
+			fieldMask |= componentMask;
+			++changedCount;
+		}
+	}
+
+	if (changedCount == 0)
+		return;
+
+	DiscardRedo(outReleasedActors);
+
+	FOperation operation;
+	operation.Type = ETransformHistoryOperation::Transform;
+	operation.FieldMask = fieldMask;
+	operation.bQuantized = false;
+	operation.Num = changedCount;
+	operation.Offset = Arena.Num();
+	operation.Size = changedCount * GetItemSize(operation.Type, fieldMask, false);
+
+	Arena.AddUninitialized(operation.Size);
+	uint8* data = Arena.GetData() + operation.Offset;
+	for (int32 i = 0; i < num; ++i)
+	{
+		if (!Components[i])
+			continue;
+
+		if (Before[i].GetLocation().Equals(After[i].GetLocation())
+			&& Before[i].GetRotation().Equals(After[i].GetRotation())
+			&& Before[i].GetScale3D().Equals(After[i].GetScale3D()))
+			continue;
+
+		WriteValue(data, FWeakObjectPtr(Components[i]));
+		WriteFields(data, Before[i], fieldMask, false);
+		WriteFields(data, After[i], fieldMask, false);
+	}
+
+	Push(operation, outReleasedActors);
+}
+
+void FTransformHistory::RecordActors(ETransformHistoryOperation Operation, const TArray<AActor*>& Actors
+                                     , TArray<AActor*>& outReleasedActors)
+{
+	check(Operation != ETransformHistoryOperation::Transform);
+
+	int32 actorCount = 0;
+	for (AActor* actor : Actors)
+		if (actor)
+			++actorCount;
+
+	if (actorCount == 0)
+		return;
+
+	DiscardRedo(outReleasedActors);
+
+	FOperation operation;
+	operation.Type = Operation;
+	operation.FieldMask = 0;
+	operation.bQuantized = false;
+	operation.Num = actorCount;
+	operation.Offset = Arena.Num();
+	operation.Size = actorCount * GetItemSize(Operation, 0, false);
+
+	Arena.AddUninitialized(operation.Size);
+	uint8* data = Arena.GetData() + operation.Offset;
+	for (AActor* actor : Actors)
+		if (actor)
+			WriteValue(data, FWeakObjectPtr(actor));
+
+	Push(operation, outReleasedActors);
+}
+
+bool FTransformHistory::Undo(FTransformHistoryStep& outStep)
+{
+	if (!CanUndo())
+		return false;
+
+	--Cursor;
+	GetStep(GetOperation(Cursor), true, outStep);
+	return true;
+}
+
+bool FTransformHistory::Redo(FTransformHistoryStep& outStep)
+{
+	if (!CanRedo())
+		return false;
+
+	GetStep(GetOperation(Cursor), false, outStep);
+	++Cursor;
+	return true;
+}
+
+void FTransformHistory::Reset(TArray<AActor*>& outReleasedActors)
+{
+	while (Count > 0)
+		DropOldest(outReleasedActors);
+	Head = 0;
+	Arena.Empty();
+	ArenaUsed = 0;
+}
+
+void FTransformHistory::Push(const FOperation& Operation, TArray<AActor*>& outReleasedActors)
+{
+	if (Count == Operations.Num())
+		DropOldest(outReleasedActors);
+
+	Operations[(Head + Count) % Operations.Num()] = Operation;
+	++Count;
+	Cursor = Count;
+	ArenaUsed += Operation.Size;
+
+	QuantizeOldOperations();
+
+	//the newest Operation is always kept, even if it alone goes over the Budget
+	while (Count > 1 && ArenaUsed > MemoryBudget)
+		DropOldest(outReleasedActors);
+
+	CompactArena();
+}
+
+void FTransformHistory::DiscardRedo(TArray<AActor*>& outReleasedActors)
+{
+	while (Count > Cursor)
+	{
+		FOperation& operation = GetOperation(Count - 1);
+		Release(operation, false, outReleasedActors);
+
+		//the newest Payload is always the last one of the Arena
+		ArenaUsed -= operation.Size;
+		Arena.SetNum(operation.Offset, false);
+		--Count;
+	}
+}
+
+void FTransformHistory::DropOldest(TArray<AActor*>& outReleasedActors)
+{
+	if (Count == 0)
+		return;
+
+	FOperation& operation = GetOperation(0);
+	Release(operation, Cursor > 0, outReleasedActors);
+	ArenaUsed -= operation.Size;
+
+	Head = (Head + 1) % Operations.Num();
+	--Count;
+	Cursor = FMath::Max(Cursor - 1, 0);
+
+	if (Count == 0)
+	{
+		Arena.Reset();
+		ArenaUsed = 0;
+	}
+}
+
+void FTransformHistory::Release(FOperation& Operation, bool bApplied, TArray<AActor*>& outReleasedActors)
+{
+	//Actors stay Soft-Deleted while applied Deletes & undone Clones can still be restored
+	const bool bSoftDeleted = (Operation.Type == ETransformHistoryOperation::Delete && bApplied)
+		|| (Operation.Type == ETransformHistoryOperation::Clone && !bApplied);
+	if (!bSoftDeleted)
+		return;
+
+	const uint8* data = Arena.GetData() + Operation.Offset;
+	for (int32 i = 0; i < Operation.Num; ++i)
+		if (AActor* actor = Cast<AActor>(ReadValue<FWeakObjectPtr>(data).Get()))
+			outReleasedActors.Add(actor);
+}
+
+void FTransformHistory::QuantizeOldOperations()
+{
+	for (int32 i = Count - 1 - QuantizeAfter; i >= 0; --i)
+	{
+		FOperation& operation = GetOperation(i);
+		if (operation.bQuantized)
+			break; //the older ones were quantized already
+
+		//Clones & Deletes only have the Actors, nothing to quantize
+		operation.bQuantized = true;
+		if (operation.Type != ETransformHistoryOperation::Transform)
+			continue;
+
+		//the quantized Payload is smaller, so it's rewritten in place
+		const uint8* read = Arena.GetData() + operation.Offset;
+		uint8* write = Arena.GetData() + operation.Offset;
+		for (int32 j = 0; j < operation.Num; ++j)
+		{
+			const FWeakObjectPtr component = ReadValue<FWeakObjectPtr>(read);
+			FTransform before, after;
+			ReadFields(read, before, operation.FieldMask, false);
+			ReadFields(read, after, operation.FieldMask, false);
+
+			WriteValue(write, component);
+			WriteFields(write, before, operation.FieldMask, true);
+			WriteFields(write, after, operation.FieldMask, true);
+		}
+
+		const int32 quantizedSize = operation.Num * GetItemSize(operation.Type, operation.FieldMask, true);
+		ArenaUsed -= operation.Size - quantizedSize;
+		operation.Size = quantizedSize;
+	}
+}
+
+void FTransformHistory::CompactArena()
+{
+	if (Arena.Num() < MinArenaSizeToCompact || Arena.Num() - ArenaUsed <= ArenaUsed)
+		return;
+
+	TArray<uint8> arena;
+	arena.Reserve(ArenaUsed);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		FOperation& operation = GetOperation(i);
+		const int32 offset = arena.Num();
+		arena.Append(Arena.GetData() + operation.Offset, operation.Size);
+		operation.Offset = offset;
+	}
+	Arena = MoveTemp(arena);
+}
+
+void FTransformHistory::GetStep(FOperation& Operation, bool bUndo, FTransformHistoryStep& outStep)
+{
+	const uint8* data = Arena.GetData() + Operation.Offset;
+
+	if (Operation.Type != ETransformHistoryOperation::Transform)
+	{
+		//Undoing a Clone or Redoing a Delete Soft-Deletes the Actors, the other way around restores them
+		const bool bDelete = bUndo == (Operation.Type == ETransformHistoryOperation::Clone);
+		TArray<AActor*>& actors = bDelete ? outStep.DeletedActors : outStep.RestoredActors;
+		for (int32 i = 0; i < Operation.Num; ++i)
+			if (AActor* actor = Cast<AActor>(ReadValue<FWeakObjectPtr>(data).Get()))
+				actors.Add(actor);
+		return;
+	}
+
+	outStep.Components.Reserve(outStep.Components.Num() + Operation.Num);
+	outStep.Transforms.Reserve(outStep.Transforms.Num() + Operation.Num);
+	for (int32 i = 0; i < Operation.Num; ++i)
+	{
+		USceneComponent* component = Cast<USceneComponent>(ReadValue<FWeakObjectPtr>(data).Get());
+
+		//the fields that were not recorded are kept as they currently are
+		FTransform before = component ? component->GetComponentTransform() : FTransform::Identity;
+		FTransform after = before;
+		ReadFields(data, before, Operation.FieldMask, Operation.bQuantized);
+		ReadFields(data, after, Operation.FieldMask, Operation.bQuantized);
+
+		if (component)
+		{
+			outStep.Components.Add(component);
+			outStep.Transforms.Add(bUndo ? before : after);
+		}
+	}
+}
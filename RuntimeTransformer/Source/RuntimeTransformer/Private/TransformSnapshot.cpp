@@ -0,0 +1,46 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformSnapshot.h"
+#include "Components/SceneComponent.h"
+
+FTransformSnapshot::FTransformSnapshot()
+{
+	Pivot = FVector::ZeroVector;
+	bValid = false;
+}
+
+void FTransformSnapshot::Capture(const TArray<USceneComponent*>& InComponents, const TArray<FSelectionEntry>& InEntries
+                                 , const FVector& InPivot)
+{
+	check(InComponents.Num() == InEntries.Num());
+	const int32 count = InComponents.Num();
+
+	Components = InComponents;
+	Entries = InEntries;
+	Locations.SetNumUninitialized(count, false);
+	Rotations.SetNumUninitialized(count, false);
+	Scales.SetNumUninitialized(count, false);
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		const FTransform& transform = InComponents[i]->GetComponentTransform();
+		Locations[i] = transform.GetLocation();
+		Rotations[i] = transform.GetRotation();
+		Scales[i] = transform.GetScale3D();
+	}
+
+	Pivot = InPivot;
+	bValid = true;
+}
+
+void FTransformSnapshot::Reset()
+{
+	Components.Reset();
+	Entries.Reset();
+	Locations.Reset();
+	Rotations.Reset();
+	Scales.Reset();
+	Pivot = FVector::ZeroVector;
+	bValid = false;
+}
@@ -0,0 +1,100 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformStreamPacket.h"
+
+//Quantization steps of the Streamed Delta
+static constexpr float TranslationQuantization = 100.f; // 0.01cm
+static constexpr float ScaleQuantization = 1000.f; // 0.001
+
+//Serializes the Axes that are non-zero (after Quantization) as Packed Zig-Zag integers
+static void SerializePackedAxes(FArchive& Ar, FVector& Value, float Quantization)
+{
+	int32 quantized[3] = { 0, 0, 0 };
+	uint8 axisMask = 0;
+
+	if (Ar.IsSaving())
+	{
+		for (int32 axis = 0; axis < 3; ++axis)
+		{
+			quantized[axis] = FMath::RoundToInt(Value[axis] * Quantization);
+			if (quantized[axis] != 0) axisMask |= 1 << axis;
+		}
+	}
+
+	Ar.SerializeBits(&axisMask, 3);
+
+	for (int32 axis = 0; axis < 3; ++axis)
+	{
+		if (!(axisMask & (1 << axis))) continue;
+
+		uint32 zigZag = (static_cast<uint32>(quantized[axis]) << 1) ^ static_cast<uint32>(quantized[axis] >> 31);
+		Ar.SerializeIntPacked(zigZag);
+		quantized[axis] = static_cast<int32>(zigZag >> 1) ^ -static_cast<int32>(zigZag & 1);
+	}
+
+	if (Ar.IsLoading())
+	{
+		for (int32 axis = 0; axis < 3; ++axis)
+			Value[axis] = quantized[axis] / Quantization;
+	}
+}
+
+//Serializes the Axes that are non-zero (after Quantization) as 16 bit integers (clamped)
+static void SerializeShortAxes(FArchive& Ar, FVector& Value, float Quantization)
+{
+	int16 quantized[3] = { 0, 0, 0 };
+	uint8 axisMask = 0;
+
+	if (Ar.IsSaving())
+	{
+		for (int32 axis = 0; axis < 3; ++axis)
+		{
+			quantized[axis] = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Value[axis] * Quantization)
+			                                                  , static_cast<int32>(MIN_int16)
+			                                                  , static_cast<int32>(MAX_int16)));
+			if (quantized[axis] != 0) axisMask |= 1 << axis;
+		}
+	}
+
+	Ar.SerializeBits(&axisMask, 3);
+
+	for (int32 axis = 0; axis < 3; ++axis)
+	{
+		if (axisMask & (1 << axis))
+			Ar << quantized[axis];
+	}
+
+	if (Ar.IsLoading())
+	{
+		for (int32 axis = 0; axis < 3; ++axis)
+			Value[axis] = quantized[axis] / Quantization;
+	}
+}
+
+FTransformStreamPacket::FTransformStreamPacket()
+{
+	Sequence = 0;
+	DragId = 0;
+	AccumulatedDelta = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+}
+
+bool FTransformStreamPacket::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Sequence;
+	Ar << DragId;
+
+	FVector translation = AccumulatedDelta.GetTranslation();
+	FRotator rotation = AccumulatedDelta.GetRotation().Rotator();
+	FVector scale = AccumulatedDelta.GetScale3D();
+
+	SerializePackedAxes(Ar, translation, TranslationQuantization);
+	rotation.SerializeCompressedShort(Ar);
+	SerializeShortAxes(Ar, scale, ScaleQuantization);
+
+	if (Ar.IsLoading())
+		AccumulatedDelta = FTransform(rotation.Quaternion(), translation, scale);
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
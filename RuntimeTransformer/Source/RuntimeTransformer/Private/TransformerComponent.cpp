@@ -3,10 +3,22 @@
 
 #include "TransformerComponent.h"
 #include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "Engine/World.h"
 #include "GameFramework/PlayerController.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "SceneView.h"
+#include "WorldCollision.h"
+#include "Net/UnrealNetwork.h"
+#include "Misc/NetworkGuid.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/NetConnection.h"
+#include "Engine/ActorChannel.h"
+#include "Misc/FileHelper.h"
 
 #include "Kismet/GameplayStatics.h"
+#include "Async/ParallelFor.h"
 
 /* Gizmos */
 #include "Gizmos/BaseGizmo.h"
@@ -17,6 +29,119 @@
 /* Interface */
 #include "FocusableObject.h"
 
+#include "TransformerSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_RuntimeTransformer_Tick, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Update Transform"), STAT_RuntimeTransformer_UpdateTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Apply Delta Transform"), STAT_RuntimeTransformer_ApplyDeltaTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Apply Drag Transform"), STAT_RuntimeTransformer_ApplyDragTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Apply Component Transforms"), STAT_RuntimeTransformer_ApplyComponentTransforms, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Apply Instance Transforms"), STAT_RuntimeTransformer_ApplyInstanceTransforms, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Trace"), STAT_RuntimeTransformer_Trace, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Pick Gizmo Domain"), STAT_RuntimeTransformer_PickGizmoDomain, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Marquee Selection"), STAT_RuntimeTransformer_MarqueeSelection, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Update Gizmo Placement"), STAT_RuntimeTransformer_UpdateGizmoPlacement, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Clone From List"), STAT_RuntimeTransformer_CloneFromList, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Clone Components"), STAT_RuntimeTransformer_CloneComponents, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Clone Batch Chunk"), STAT_RuntimeTransformer_CloneBatchChunk, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Export Layout"), STAT_RuntimeTransformer_ExportLayout, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Read Layout Entries"), STAT_RuntimeTransformer_ReadLayoutEntries, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Multicast Apply Transform"), STAT_RuntimeTransformer_MulticastApplyTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Multicast Stream Transform"), STAT_RuntimeTransformer_MulticastStreamTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Multicast Commit Streamed Transform"), STAT_RuntimeTransformer_MulticastCommitStreamedTransform, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Multicast Deselect All"), STAT_RuntimeTransformer_MulticastDeselectAll, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Multicast Set Selected Components"), STAT_RuntimeTransformer_MulticastSetSelectedComponents, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Replicated Selection"), STAT_RuntimeTransformer_ReplicatedSelection, STATGROUP_RuntimeTransformer);
+DECLARE_CYCLE_STAT(TEXT("Update Observers"), STAT_RuntimeTransformer_UpdateObservers, STATGROUP_RuntimeTransformer);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Selected Components"), STAT_RuntimeTransformer_SelectedComponents, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Components Transformed"), STAT_RuntimeTransformer_ComponentsTransformed, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Instances Transformed"), STAT_RuntimeTransformer_InstancesTransformed, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Trace Hits"), STAT_RuntimeTransformer_TraceHits, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Trace Hits Filtered"), STAT_RuntimeTransformer_TraceHitsFiltered, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Components Reconciled"), STAT_RuntimeTransformer_ComponentsReconciled, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gizmos Spawned"), STAT_RuntimeTransformer_GizmosSpawned, STATGROUP_RuntimeTransformer);
+
+/*
+ * RPCs are counted where they execute: on the Server that is the Server RPCs received and the Multicasts sent,
+ * on the Clients it is the Multicasts and Client RPCs received.
+ * The Bytes are the size of the Parameters (before Net Serialization / Quantization).
+ */
+DECLARE_DWORD_COUNTER_STAT(TEXT("Transform RPCs"), STAT_RuntimeTransformer_TransformRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Stream RPCs"), STAT_RuntimeTransformer_StreamRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Selection RPCs"), STAT_RuntimeTransformer_SelectionRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("State RPCs"), STAT_RuntimeTransformer_StateRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Observer RPCs"), STAT_RuntimeTransformer_ObserverRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Layout RPCs"), STAT_RuntimeTransformer_LayoutRPCs, STATGROUP_RuntimeTransformer);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RPC Parameter Bytes"), STAT_RuntimeTransformer_RPCBytes, STATGROUP_RuntimeTransformer);
+
+#define COUNT_RPC(TypeStat, ParameterBytes) \
+	INC_DWORD_STAT(TypeStat); \
+	INC_DWORD_STAT_BY(STAT_RuntimeTransformer_RPCBytes, ParameterBytes)
+
+//Below this amount of Components, the transforms are computed in a single thread
+static constexpr int32 MinComponentsForParallelTransform = 64;
+
+//Applies the Delta Transform to a World Transform, rotating around the Pivot unless bLocalAxis
+static FTransform ComputeDeltaAppliedTransform(const FTransform& Transform, const FTransform& DeltaTransform
+                                               , const FVector& Pivot, bool bLocalAxis)
+{
+	FQuat deltaRotation = DeltaTransform.GetRotation();
+
+	FVector deltaLocation = Transform.GetLocation() - Pivot;
+
+	//DeltaScale is Unrotated Scale to Get Local Scale since World Scale is not supported
+	FVector deltaScale = Transform.GetRotation().UnrotateVector(DeltaTransform.GetScale3D());
+
+	if (false == bLocalAxis)
+		deltaLocation = deltaRotation.RotateVector(deltaLocation);
+
+	return FTransform(
+		deltaRotation * Transform.GetRotation(),
+		//adding Gizmo Location + prevDeltaLocation 
+		// (i.e. location from Gizmo to Object after optional Rotating)
+		// + deltaTransform Location Offset
+		deltaLocation + Pivot + DeltaTransform.GetLocation(),
+		deltaScale + Transform.GetScale3D());
+}
+
+//Writes the World Transforms of the (ascending) Instances: contiguous runs are updated in a single batch
+static void UpdateInstanceTransforms(UInstancedStaticMeshComponent* Component, const TArray<int32>& Instances
+                                     , const TArray<FTransform>& Transforms)
+{
+	TArray<FTransform> runTransforms;
+	for (int32 runStart = 0; runStart < Instances.Num();)
+	{
+		int32 runEnd = runStart + 1;
+		while (runEnd < Instances.Num() && Instances[runEnd] == Instances[runEnd - 1] + 1)
+			++runEnd;
+
+		if (runEnd - runStart == 1)
+			Component->UpdateInstanceTransform(Instances[runStart], Transforms[runStart], true, false, true);
+		else
+		{
+			runTransforms.Reset(runEnd - runStart);
+			runTransforms.Append(Transforms.GetData() + runStart, runEnd - runStart);
+			Component->BatchUpdateInstancesTransforms(Instances[runStart], runTransforms, true, false, true);
+		}
+		runStart = runEnd;
+	}
+
+	INC_DWORD_STAT_BY(STAT_RuntimeTransformer_InstancesTransformed, Instances.Num());
+
+	//the updates above skip the render state refresh, so it's done once for the whole Component
+	Component->MarkRenderStateDirty();
+}
+
+//Interpolates between two Accumulated Deltas. @see AccumulateDeltaTransform
+static FTransform InterpolateAccumulatedDelta(const FTransform& From, const FTransform& To, float Alpha)
+{
+	return FTransform(
+		FQuat::Slerp(From.GetRotation(), To.GetRotation(), Alpha),
+		FMath::Lerp(From.GetLocation(), To.GetLocation(), Alpha),
+		FMath::Lerp(From.GetScale3D(), To.GetScale3D(), Alpha));
+}
+
 // Sets default values
 UTransformerComponent::UTransformerComponent()
 {
@@ -34,29 +159,188 @@ UTransformerComponent::UTransformerComponent()
 	CloneReplicationCheckFrequency = 0.05f;
 	MinimumCloneReplicationTime = 0.01f;
 
-	bResyncSelection = false;
 	SetIsReplicated(false);
 
+	SelectionTransactionDepth = 0;
+	bGizmoPlacementPending = false;
+	bSelectionSyncPending = false;
+
 	bIgnoreNonReplicatedObjects = false;
+	ReplicatedSelection.Owner = this;
+	bReplicatedSelectionChanged = false;
 
 	ResetDeltaTransform(AccumulatedDeltaTransform);
 	ResetDeltaTransform(NetworkDeltaTransform);
+	ResetDeltaTransform(DragDeltaTransform);
+
+	bStreamTransforms = false;
+	TransformStreamRate = 20.f;
+	StreamSequence = 0;
+	StreamDragId = 0;
+	LastStreamTime = 0.f;
+	ResetDeltaTransform(LastStreamedDelta);
+	LastCommittedSequence = 0;
+	bHasCommittedSequence = false;
+
+	bInterpolateStreamedTransforms = false;
+	bPredictTransforms = false;
+	PredictionLocationTolerance = 0.1f;
+	PredictionAngleTolerance = 0.1f;
+	PredictionScaleTolerance = 0.001f;
+	MaxAcknowledgedComponents = 256;
+
+	LayoutChunkSize = 4096;
+	MaxLayoutChunksPerFrame = 4;
+	MaxLayoutTransferSizeKB = 64 * 1024;
+	OutgoingLayoutOffset = 0;
+	OutgoingLayoutId = 0;
+	IncomingLayoutSize = 0;
+	IncomingLayoutId = 0;
+	bReceivingLayout = false;
 
 	SetTransformationType(CurrentTransformation);
 	SetSpaceType(CurrentSpaceType);
 
 	bTransformUFocusableObjects = true;
+	bPreviewDrags = false;
 	bRotateOnLocalAxis = false;
 	bForceMobility = false;
 	bToggleSelectedInMultiSelection = true;
 	bComponentBased = false;
+	bPrewarmGizmoPool = false;
+	CloneFrameBudgetMs = 0.f;
+	LayoutImportEntriesPerFrame = 512;
+	bAnalyticGizmoPicking = false;
+	bLocalGizmosOnly = false;
+	bSelectInstances = false;
+	bMarqueeRequiresFullyInside = false;
+	StatSelectedCount = 0;
+	bGizmoOnInstance = false;
+	InstanceDragPivot = FVector::ZeroVector;
+	bRecordHistory = false;
+	HistoryMemoryBudgetKB = 1024;
+	MaxHistoryOperations = 128;
+	HistoryQuantizeAfter = 16;
+	MaxHistoryStepObjects = 256;
+	bUseEditLocks = false;
+	bAsyncServerTraces = false;
+	ServerTraceGeneration = 0;
+	bCoalesceServerCommands = false;
+	MaxStateBatchesPerSecond = 30.f;
+	MaxQueuedStateBatches = 16;
+	StateBatchBudget = 0.f;
+	LastStateBatchBudgetTime = 0.f;
+	MaxEditLocks = 0;
+	bReplicateToObservers = false;
+	EditingGroup = NAME_None;
+	MaxObserverRelevancyChecks = 32;
+	MaxObservedComponentsPerUpdate = 256;
+	bObservedStateDirty = false;
+
+	bEventDrivenGizmoUpdates = true;
+	GizmoUpdateLocationThreshold = 0.01f;
+	GizmoUpdateAngleThreshold = 0.01f;
+	bGizmoScaleDirty = true;
+	bGizmoSpaceDirty = true;
+	LastAppliedSpaceType = ESpaceType::ST_None;
+	LastScaleFieldOfView = 0.f;
+	bLastScaleInProgress = false;
+}
+
+void UTransformerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bPrewarmGizmoPool && !IsHeadless())
+	{
+		GetPooledGizmo(ETransformationType::TT_Translation);
+		GetPooledGizmo(ETransformationType::TT_Rotation);
+		GetPooledGizmo(ETransformationType::TT_Scale);
+	}
+
+	TArray<AActor*> releasedActors;
+	History.Configure(HistoryMemoryBudgetKB * 1024, MaxHistoryOperations, HistoryQuantizeAfter, releasedActors);
+	DestroyReleasedActors(releasedActors);
+
+	if (bReplicateToObservers && GetOwnerRole() == ROLE_Authority)
+		if (UTransformerSubsystem* subsystem = GetWorld()->GetSubsystem<UTransformerSubsystem>())
+			subsystem->RegisterTransformer(this);
+
+	InstanceIndexUpdatedHandle = FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.AddUObject(
+		this, &UTransformerComponent::OnInstanceIndexUpdated);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+		this, &UTransformerComponent::OnPostGarbageCollect);
+
+	UpdateComponentTickState();
+}
+
+void UTransformerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (auto& pooledGizmo : GizmoPool)
+	{
+		if (IsValid(pooledGizmo.Value))
+			pooledGizmo.Value->Destroy();
+	}
+	GizmoPool.Empty();
+	Gizmo = nullptr;
+
+	DragPreview.End();
+
+	FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.Remove(InstanceIndexUpdatedHandle);
+	InstanceIndexUpdatedHandle.Reset();
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	PostGarbageCollectHandle.Reset();
+	InstanceDragSnapshots.Empty();
+
+	if (UWorld* world = GetWorld())
+	{
+		world->GetTimerManager().ClearTimer(CloneBatchTimerHandle);
+		world->GetTimerManager().ClearTimer(LayoutImportTimerHandle);
+		world->GetTimerManager().ClearTimer(LayoutTransferTimerHandle);
+	}
+	CloneBatch.Reset();
+	LayoutImport.Reset();
+	OutgoingLayout.Empty();
+	IncomingLayout.Empty();
+	bReceivingLayout = false;
+
+	if (GetOwnerRole() == ROLE_Authority)
+		if (ATransformerLockTable* lockTable = GetLockTable(false))
+			lockTable->GetLocks().ReleaseAll(this);
+	PendingServerTraces.Empty();
+	SubmittedServerTraces.Empty();
+	++ServerTraceGeneration;
+	QueuedStateBatches.Empty();
+
+	if (bReplicateToObservers && GetOwnerRole() == ROLE_Authority)
+	{
+		ForgetObservers();
+		if (UWorld* world = GetWorld())
+			if (UTransformerSubsystem* subsystem = world->GetSubsystem<UTransformerSubsystem>())
+				subsystem->UnregisterTransformer(this);
+	}
+	ObservedEditors.Empty();
+
+	//if the World is going away, so are the Soft-Deleted Actors
+	TArray<AActor*> releasedActors;
+	History.Reset(releasedActors);
+	HistoryTransformStart.Reset();
+	if (EndPlayReason == EEndPlayReason::Destroyed || EndPlayReason == EEndPlayReason::RemovedFromWorld)
+		DestroyReleasedActors(releasedActors);
+
+#if STATS
+	DEC_DWORD_STAT_BY(STAT_RuntimeTransformer_SelectedComponents, StatSelectedCount);
+	StatSelectedCount = 0;
+#endif
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UTransformerComponent::GetLifetimeReplicatedProps(
 	TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	//Fill here if we need to replicate Properties. For now, nothing needs constant replication/check
+	DOREPLIFETIME(UTransformerComponent, ReplicatedSelection);
 }
 
 UObject* UTransformerComponent::GetUFocusable(USceneComponent* Component) const
@@ -69,35 +353,62 @@ UObject* UTransformerComponent::GetUFocusable(USceneComponent* Component) const
 	return nullptr;
 }
 
-void UTransformerComponent::SetTransform(USceneComponent* Component, const FTransform& Transform)
+FSelectionEntry UTransformerComponent::ResolveSelectionEntry(USceneComponent* Component) const
 {
-	if (!Component) return;
+	FSelectionEntry entry;
 	if (UObject* focusableObject = GetUFocusable(Component))
 	{
-		IFocusableObject::Execute_OnNewTransformation(focusableObject, this, Component, Transform, bComponentBased);
-		if (bTransformUFocusableObjects)
-			Component->SetWorldTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+		entry.FocusableObject = focusableObject;
+
+		//only Native implementations of the Interface can be Cast to
+		entry.NativeFocusable = Cast<IFocusableObject>(focusableObject);
+
+		static const FName OnNewTransformationsName = GET_FUNCTION_NAME_CHECKED(IFocusableObject, OnNewTransformations);
+		entry.bBatchedInScript = focusableObject->GetClass()->IsFunctionImplementedInScript(OnNewTransformationsName);
 	}
-	else
-		Component->SetWorldTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	return entry;
+}
+
+void UTransformerComponent::NotifyNewTransformations(const FSelectionEntry& Entry
+                                                     , const TArray<USceneComponent*>& Components
+                                                     , const TArray<FTransform>& Transforms)
+{
+	UObject* focusableObject = Entry.GetFocusable();
+	if (!focusableObject) return;
+
+	IFocusableObject* nativeFocusable = Entry.GetNativeFocusable();
+	if (nativeFocusable && nativeFocusable->NativeOnNewTransformations(this, Components, Transforms, bComponentBased))
+		return;
+
+	if (Entry.bBatchedInScript)
+	{
+		IFocusableObject::Execute_OnNewTransformations(focusableObject, this, Components, Transforms, bComponentBased);
+		return;
+	}
+
+	for (int32 i = 0; i < Components.Num(); ++i)
+		IFocusableObject::Execute_OnNewTransformation(focusableObject, this, Components[i], Transforms[i]
+		                                              , bComponentBased);
 }
 
-void UTransformerComponent::Select(USceneComponent* Component, bool* bImplementsUFocusable)
+void UTransformerComponent::Select(USceneComponent* Component, const FSelectionEntry& Entry)
 {
-	UObject* focusableObject = GetUFocusable(Component);
-	if (focusableObject)
+	UObject* focusableObject = Entry.GetFocusable();
+	if (!focusableObject) return;
+
+	IFocusableObject* nativeFocusable = Entry.GetNativeFocusable();
+	if (!nativeFocusable || !nativeFocusable->NativeFocus(this, Component, bComponentBased))
 		IFocusableObject::Execute_Focus(focusableObject, this, Component, bComponentBased);
-	if (bImplementsUFocusable)
-		*bImplementsUFocusable = !!focusableObject;
 }
 
-void UTransformerComponent::Deselect(USceneComponent* Component, bool* bImplementsUFocusable)
+void UTransformerComponent::Deselect(USceneComponent* Component, const FSelectionEntry& Entry)
 {
-	UObject* focusableObject = GetUFocusable(Component);
-	if (focusableObject)
+	UObject* focusableObject = Entry.GetFocusable();
+	if (!focusableObject) return;
+
+	IFocusableObject* nativeFocusable = Entry.GetNativeFocusable();
+	if (!nativeFocusable || !nativeFocusable->NativeUnfocus(this, Component, bComponentBased))
 		IFocusableObject::Execute_Unfocus(focusableObject, this, Component, bComponentBased);
-	if (bImplementsUFocusable)
-		*bImplementsUFocusable = !!focusableObject;
 }
 
 void UTransformerComponent::FilterHits(TArray<FHitResult>& outHits)
@@ -132,13 +443,16 @@ void UTransformerComponent::FilterHits(TArray<FHitResult>& outHits)
 			}
 
 			Iter.RemoveCurrent();
+			INC_DWORD_STAT(STAT_RuntimeTransformer_TraceHitsFiltered);
 		}
 	}
 }
 
 void UTransformerComponent::SetSpaceType(ESpaceType Type)
 {
+	bObservedStateDirty |= CurrentSpaceType != Type;
 	CurrentSpaceType = Type;
+	bGizmoSpaceDirty = true;
 	SetGizmo();
 }
 
@@ -155,6 +469,36 @@ void UTransformerComponent::ClearDomain()
 	SetDomain(ETransformationDomain::TD_None);
 }
 
+void UTransformerComponent::CancelTransform()
+{
+	if (DragSnapshot.IsValid())
+	{
+		TArray<FTransform> originalTransforms;
+		originalTransforms.SetNumUninitialized(DragSnapshot.Num());
+		for (int32 i = 0; i < DragSnapshot.Num(); ++i)
+			originalTransforms[i] = DragSnapshot.GetTransform(i);
+
+		ApplyComponentTransforms(DragSnapshot.GetComponents(), DragSnapshot.GetEntries(), originalTransforms);
+
+		for (const FInstanceSnapshot& snapshot : InstanceDragSnapshots)
+			if (UInstancedStaticMeshComponent* ism = snapshot.Component.Get())
+				UpdateInstanceTransforms(ism, snapshot.Instances, snapshot.Transforms);
+	}
+
+	//nothing has been sent to the Server yet, so just get rid of what was accumulated
+	ResetDeltaTransform(NetworkDeltaTransform);
+
+	//the others might have previewed part of the Drag, so commit it as an empty Delta to take them back
+	//(before the Domain is cleared, so the Server records nothing for the History)
+	if (bStreamTransforms)
+		CommitDrag();
+
+	ClearDomain();
+
+	if (GetOwnerRole() < ROLE_Authority)
+		ServerClearDomain();
+}
+
 bool UTransformerComponent::GetMouseStartEndPoints(float TraceDistance, FVector& outStartPoint, FVector& outEndPoint)
 {
 	if (APlayerController* PlayerController = GetPlayerController())
@@ -173,7 +517,7 @@ bool UTransformerComponent::GetMouseStartEndPoints(float TraceDistance, FVector&
 UClass* UTransformerComponent::GetGizmoClass(ETransformationType TransformationType) const /* private */
 {
 	//Assign correct Gizmo Class depending on given Transformation
-	switch (CurrentTransformation)
+	switch (TransformationType)
 	{
 	case ETransformationType::TT_Translation: return TranslationGizmoClass;
 	case ETransformationType::TT_Rotation: return RotationGizmoClass;
@@ -190,11 +534,38 @@ void UTransformerComponent::ResetDeltaTransform(FTransform& Transform)
 
 void UTransformerComponent::SetDomain(ETransformationDomain Domain)
 {
+	const bool bWasTransforming = CurrentDomain != ETransformationDomain::TD_None;
+	bObservedStateDirty |= CurrentDomain != Domain;
 	CurrentDomain = Domain;
 
+	//taken first, as it Rebuilds the Roots the History and the Preview below rely on too
+	DragSnapshot.Reset();
+	if (CurrentDomain != ETransformationDomain::TD_None)
+		CaptureDragSnapshot();
+
+	if (IsRecordingHistory())
+	{
+		if (!bWasTransforming && CurrentDomain != ETransformationDomain::TD_None)
+			BeginHistoryTransform();
+		else if (bWasTransforming && CurrentDomain == ETransformationDomain::TD_None)
+			EndHistoryTransform();
+	}
+
+	if (bPreviewDrags && !bWasTransforming && CurrentDomain != ETransformationDomain::TD_None)
+	{
+		TArray<USceneComponent*> components;
+		TArray<FSelectionEntry> entries;
+		GetTransformableComponents(components, entries);
+		DragPreview.Begin(components);
+	}
+	else if (CurrentDomain == ETransformationDomain::TD_None)
+		DragPreview.End();
+
 	if (Gizmo)
 		Gizmo->SetTransformProgressState(CurrentDomain != ETransformationDomain::TD_None
 		                                 , CurrentDomain);
+
+	UpdateComponentTickState();
 }
 
 bool UTransformerComponent::MouseTraceByObjectTypes(float TraceDistance
@@ -253,6 +624,7 @@ bool UTransformerComponent::TraceByObjectTypes(const FVector& StartLocation
                                                , TArray<AActor*> IgnoredActors
                                                , bool bAppendToList)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Trace);
 	if (UWorld* world = GetWorld())
 	{
 		FCollisionObjectQueryParams CollisionObjectQueryParams;
@@ -265,9 +637,24 @@ bool UTransformerComponent::TraceByObjectTypes(const FVector& StartLocation
 		CollisionQueryParams.AddIgnoredActors(IgnoredActors);
 
 		TArray<FHitResult> OutHits;
-		if (world->LineTraceMultiByObjectType(OutHits, StartLocation, EndLocation
-		                                      , CollisionObjectQueryParams, CollisionQueryParams))
+		bool bHit;
+		//Headless has no Gizmo to trace against, so it is always picked analytically
+		if ((bAnalyticGizmoPicking || IsHeadless()) && PickGizmoDomain(StartLocation, EndLocation, IgnoredActors))
+			return true;
+
+		if (bAnalyticGizmoPicking)
+		{
+			FHitResult OutHit;
+			bHit = world->LineTraceSingleByObjectType(OutHit, StartLocation, EndLocation
+			                                          , CollisionObjectQueryParams, CollisionQueryParams);
+			if (bHit) OutHits.Add(OutHit);
+		}
+		else
+			bHit = world->LineTraceMultiByObjectType(OutHits, StartLocation, EndLocation
+			                                         , CollisionObjectQueryParams, CollisionQueryParams);
+		if (bHit)
 		{
+			INC_DWORD_STAT_BY(STAT_RuntimeTransformer_TraceHits, OutHits.Num());
 			FilterHits(OutHits);
 			return HandleTracedObjects(OutHits, bAppendToList);
 		}
@@ -281,15 +668,31 @@ bool UTransformerComponent::TraceByChannel(const FVector& StartLocation
                                            , TArray<AActor*> IgnoredActors
                                            , bool bAppendToList)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Trace);
 	if (UWorld* world = GetWorld())
 	{
 		FCollisionQueryParams CollisionQueryParams;
 		CollisionQueryParams.AddIgnoredActors(IgnoredActors);
 
 		TArray<FHitResult> OutHits;
-		if (world->LineTraceMultiByChannel(OutHits, StartLocation, EndLocation
-		                                   , TraceChannel, CollisionQueryParams))
+		bool bHit;
+		//Headless has no Gizmo to trace against, so it is always picked analytically
+		if ((bAnalyticGizmoPicking || IsHeadless()) && PickGizmoDomain(StartLocation, EndLocation, IgnoredActors))
+			return true;
+
+		if (bAnalyticGizmoPicking)
+		{
+			FHitResult OutHit;
+			bHit = world->LineTraceSingleByChannel(OutHit, StartLocation, EndLocation
+			                                    , TraceChannel, CollisionQueryParams);
+			if (bHit) OutHits.Add(OutHit);
+		}
+		else
+			bHit = world->LineTraceMultiByChannel(OutHits, StartLocation, EndLocation
+			                                   , TraceChannel, CollisionQueryParams);
+		if (bHit)
 		{
+			INC_DWORD_STAT_BY(STAT_RuntimeTransformer_TraceHits, OutHits.Num());
 			FilterHits(OutHits);
 			return HandleTracedObjects(OutHits, bAppendToList);
 		}
@@ -302,15 +705,31 @@ bool UTransformerComponent::TraceByProfile(const FVector& StartLocation
                                            , const FName& ProfileName, TArray<AActor*> IgnoredActors
                                            , bool bAppendToList)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Trace);
 	if (UWorld* world = GetWorld())
 	{
 		FCollisionQueryParams CollisionQueryParams;
 		CollisionQueryParams.AddIgnoredActors(IgnoredActors);
 
 		TArray<FHitResult> OutHits;
-		if (world->LineTraceMultiByProfile(OutHits, StartLocation, EndLocation
-		                                   , ProfileName, CollisionQueryParams))
+		bool bHit;
+		//Headless has no Gizmo to trace against, so it is always picked analytically
+		if ((bAnalyticGizmoPicking || IsHeadless()) && PickGizmoDomain(StartLocation, EndLocation, IgnoredActors))
+			return true;
+
+		if (bAnalyticGizmoPicking)
+		{
+			FHitResult OutHit;
+			bHit = world->LineTraceSingleByProfile(OutHit, StartLocation, EndLocation
+			                                    , ProfileName, CollisionQueryParams);
+			if (bHit) OutHits.Add(OutHit);
+		}
+		else
+			bHit = world->LineTraceMultiByProfile(OutHits, StartLocation, EndLocation
+			                                   , ProfileName, CollisionQueryParams);
+		if (bHit)
 		{
+			INC_DWORD_STAT_BY(STAT_RuntimeTransformer_TraceHits, OutHits.Num());
 			FilterHits(OutHits);
 			return HandleTracedObjects(OutHits, bAppendToList);
 		}
@@ -318,14 +737,232 @@ bool UTransformerComponent::TraceByProfile(const FVector& StartLocation
 	return false;
 }
 
+void UTransformerComponent::BeginMarqueeSelectionByObjectTypes(const FVector2D& ScreenPosition
+                                                               , float Distance
+                                                               , TArray<TEnumAsByte<ECollisionChannel>> CollisionChannels
+                                                               , TArray<AActor*> IgnoredActors
+                                                               , bool bAppendToList)
+{
+	BeginMarqueeSelection_Internal(ScreenPosition, Distance, IgnoredActors, bAppendToList);
+	MarqueeSelection.QueryType = EMarqueeQueryType::MQ_ObjectTypes;
+	for (auto& cc : CollisionChannels)
+		MarqueeSelection.ObjectQueryParams.AddObjectTypesToQuery(cc);
+}
+
+void UTransformerComponent::BeginMarqueeSelectionByChannel(const FVector2D& ScreenPosition
+                                                           , float Distance
+                                                           , TEnumAsByte<ECollisionChannel> TraceChannel
+                                                           , TArray<AActor*> IgnoredActors
+                                                           , bool bAppendToList)
+{
+	BeginMarqueeSelection_Internal(ScreenPosition, Distance, IgnoredActors, bAppendToList);
+	MarqueeSelection.QueryType = EMarqueeQueryType::MQ_Channel;
+	MarqueeSelection.TraceChannel = TraceChannel;
+}
+
+void UTransformerComponent::BeginMarqueeSelectionByProfile(const FVector2D& ScreenPosition
+                                                           , float Distance
+                                                           , const FName& ProfileName
+                                                           , TArray<AActor*> IgnoredActors
+                                                           , bool bAppendToList)
+{
+	BeginMarqueeSelection_Internal(ScreenPosition, Distance, IgnoredActors, bAppendToList);
+	MarqueeSelection.QueryType = EMarqueeQueryType::MQ_Profile;
+	MarqueeSelection.ProfileName = ProfileName;
+}
+
+void UTransformerComponent::BeginMarqueeSelection_Internal(const FVector2D& ScreenPosition, float Distance
+                                                           , const TArray<AActor*>& IgnoredActors, bool bAppendToList)
+{
+	MarqueeSelection.Reset();
+	MarqueeSelection.bActive = true;
+	MarqueeSelection.ScreenStart = ScreenPosition;
+	MarqueeSelection.Distance = Distance;
+	MarqueeSelection.IgnoredActors = IgnoredActors;
+
+	if (false == bAppendToList)
+		DeselectAll();
+}
+
+bool UTransformerComponent::UpdateMarqueeSelection(const FVector2D& ScreenPosition)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MarqueeSelection);
+	if (!MarqueeSelection.bActive) return false;
+
+	FIntRect viewRect;
+	FMatrix viewProjectionMatrix;
+	if (!GetViewProjection(viewRect, viewProjectionMatrix))
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Marquee Selection needs a Local Player Controller with a Viewport!"));
+		return false;
+	}
+
+	//a degenerate Rectangle contains nothing, so everything the Marquee selected is deselected
+	FMarqueeFrustum frustum;
+	TSet<USceneComponent*> inMarquee;
+	if (frustum.Build(MarqueeSelection.ScreenStart, ScreenPosition, viewRect, viewProjectionMatrix
+	                  , MarqueeSelection.Distance))
+		GetComponentsInFrustum(frustum, inMarquee);
+
+	FScopedSelectionTransaction SelectionTransaction(this);
+	TSet<USceneComponent*>& marqueeSelected = MarqueeSelection.MarqueeSelected;
+
+	for (auto it = marqueeSelected.CreateIterator(); it; ++it)
+	{
+		if (inMarquee.Contains(*it)) continue;
+		if (*it)
+			DeselectComponent_Internal(SelectedComponents, *it);
+		it.RemoveCurrent();
+	}
+
+	for (USceneComponent* component : inMarquee)
+	{
+		//Components that are already Selected are left as they are (rather than toggled)
+		if (SelectedComponents.Contains(component)) continue;
+		if (!ShouldSelect(component->GetOwner(), component)) continue;
+
+		AddComponent_Internal(SelectedComponents, component);
+		marqueeSelected.Add(component);
+	}
+
+	UpdateGizmoPlacement();
+	return inMarquee.Num() > 0;
+}
+
+void UTransformerComponent::EndMarqueeSelection()
+{
+	MarqueeSelection.Reset();
+}
+
+bool UTransformerComponent::GetViewProjection(FIntRect& outViewRect, FMatrix& outViewProjectionMatrix) const
+{
+	APlayerController* PlayerController = GetPlayerController();
+	ULocalPlayer* localPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (!localPlayer || !localPlayer->ViewportClient) return false;
+
+	FSceneViewProjectionData projectionData;
+	if (!localPlayer->GetProjectionData(localPlayer->ViewportClient->Viewport, eSSP_FULL, projectionData))
+		return false;
+
+	outViewRect = projectionData.GetConstrainedViewRect();
+	outViewProjectionMatrix = projectionData.ComputeViewProjectionMatrix();
+	return true;
+}
+
+void UTransformerComponent::GetComponentsInFrustum(const FMarqueeFrustum& Frustum
+                                                   , TSet<USceneComponent*>& outComponents)
+{
+	UWorld* world = GetWorld();
+	if (!world) return;
+
+	/* BROAD PHASE: Overlap the Box that encloses the Frustum */
+	FCollisionQueryParams CollisionQueryParams(SCENE_QUERY_STAT(MarqueeSelection), false);
+	CollisionQueryParams.AddIgnoredActors(MarqueeSelection.IgnoredActors);
+	const FCollisionShape box = FCollisionShape::MakeBox(Frustum.BoxExtent);
+
+	TArray<FOverlapResult> overlaps;
+	switch (MarqueeSelection.QueryType)
+	{
+	case EMarqueeQueryType::MQ_ObjectTypes:
+		world->OverlapMultiByObjectType(overlaps, Frustum.BoxCenter, Frustum.BoxRotation
+		                                , MarqueeSelection.ObjectQueryParams, box, CollisionQueryParams);
+		break;
+	case EMarqueeQueryType::MQ_Channel:
+		world->OverlapMultiByChannel(overlaps, Frustum.BoxCenter, Frustum.BoxRotation
+		                             , MarqueeSelection.TraceChannel, box, CollisionQueryParams);
+		break;
+	case EMarqueeQueryType::MQ_Profile:
+		world->OverlapMultiByProfile(overlaps, Frustum.BoxCenter, Frustum.BoxRotation
+		                             , MarqueeSelection.ProfileName, box, CollisionQueryParams);
+		break;
+	default: ;
+	}
+
+	//a Component can overlap more than once (e.g. once per Instance), so gather the unique ones
+	TArray<UPrimitiveComponent*> candidates;
+	TSet<UPrimitiveComponent*> visited;
+	for (const FOverlapResult& overlap : overlaps)
+	{
+		UPrimitiveComponent* primitive = overlap.GetComponent();
+		AActor* actor = overlap.GetActor();
+		if (!primitive || !actor || Cast<ABaseGizmo>(actor))
+			continue;
+
+		//same rules as FilterHits
+		if (bIgnoreNonReplicatedObjects && (!actor->IsSupportedForNetworking()
+			|| (bComponentBased && !primitive->IsSupportedForNetworking())))
+			continue;
+
+		bool bAlreadyVisited;
+		visited.Add(primitive, &bAlreadyVisited);
+		if (!bAlreadyVisited)
+			candidates.Add(primitive);
+	}
+
+	/* NARROW PHASE: only reads the Bounds, so it can be done in parallel */
+	TArray<bool> inside;
+	inside.SetNumZeroed(candidates.Num());
+	const bool bFullyInside = bMarqueeRequiresFullyInside;
+	ParallelFor(candidates.Num(), [&](int32 i)
+	{
+		inside[i] = Frustum.IsInside(candidates[i]->Bounds, bFullyInside);
+	}, candidates.Num() < MinComponentsForParallelTransform);
+
+	for (int32 i = 0; i < candidates.Num(); ++i)
+	{
+		if (!inside[i]) continue;
+
+		USceneComponent* component = bComponentBased
+			                             ? candidates[i]
+			                             : candidates[i]->GetOwner()->GetRootComponent();
+		if (component)
+			outComponents.Add(component);
+	}
+}
+
+bool UTransformerComponent::PickGizmoDomain(const FVector& StartLocation, const FVector& EndLocation
+                                            , const TArray<AActor*>& IgnoredActors)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_PickGizmoDomain);
+	//Assign as None just in case we don't hit the Gizmo
+	ClearDomain();
+
+	FTransform virtualTransform;
+	const bool bVirtual = !Gizmo && IsHeadless() && GetVirtualGizmoTransform(virtualTransform);
+	if (!bVirtual && (!Gizmo || IgnoredActors.Contains(Gizmo))) return false;
+
+	FVector direction = EndLocation - StartLocation;
+	const float length = direction.Size();
+	if (length <= KINDA_SMALL_NUMBER) return false;
+	direction /= length;
+
+	float distance;
+	const ETransformationDomain domain = bVirtual
+		                                     ? GetGizmoDefaults()->PickDomainAt(virtualTransform, StartLocation
+		                                                                        , direction, distance)
+		                                     : Gizmo->PickDomain(StartLocation, direction, distance);
+	if (domain == ETransformationDomain::TD_None || distance > length)
+		return false;
+
+	SetDomain(domain);
+	if (Gizmo)
+		Gizmo->SetTransformProgressState(true, CurrentDomain);
+	return true;
+}
+
 void UTransformerComponent::TickComponent(float DeltaTime, enum ELevelTick TickType,
                                           FActorComponentTickFunction* ThisTickFunction)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Tick);
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	InterpolateStreamedDrags(DeltaTime);
+
 	if (!Gizmo) return;
 
-	if (APlayerController* PlayerController = GetPlayerController())
+	//Mouse only needs to be checked if there is a Transform in Progress
+	APlayerController* PlayerController = GetPlayerController();
+	if (PlayerController && (CurrentDomain != ETransformationDomain::TD_None || !bEventDrivenGizmoUpdates))
 	{
 		FVector worldLocation, worldDirection;
 		if (PlayerController->IsLocalController() && PlayerController->PlayerCameraManager)
@@ -336,28 +973,177 @@ void UTransformerComponent::TickComponent(float DeltaTime, enum ELevelTick TickT
 					PlayerController->PlayerCameraManager->GetActorForwardVector()
 					, worldLocation, worldDirection);
 
-				NetworkDeltaTransform = FTransform(
-					deltaTransform.GetRotation() * NetworkDeltaTransform.GetRotation(),
-					deltaTransform.GetLocation() + NetworkDeltaTransform.GetLocation(),
-					deltaTransform.GetScale3D() + NetworkDeltaTransform.GetScale3D());
+				AccumulateDeltaTransform(NetworkDeltaTransform, deltaTransform);
+				StreamTransform();
 			}
 		}
 	}
 
-	//Only consider Local View
-	if (APlayerController* LocalPlayerController = UGameplayStatics::GetPlayerController(this, 0))
+	//UpdateTransform could have cleared the Gizmo (e.g. a Focusable deselecting itself)
+	if (!Gizmo) return;
+
+	//Only consider Local View: this Transformer's own (e.g. in Split-Screen), else the first Local Player's
+	APlayerController* LocalPlayerController = PlayerController && PlayerController->IsLocalController()
+		                                           ? PlayerController
+		                                           : UGameplayStatics::GetPlayerController(this, 0);
+	if (LocalPlayerController)
+	{
+		if (APlayerCameraManager* CameraManager = LocalPlayerController->PlayerCameraManager)
+		{
+			const FVector cameraLocation = CameraManager->GetCameraLocation();
+			const FVector cameraForward = CameraManager->GetActorForwardVector();
+			const float fieldOfView = CameraManager->GetFOVAngle();
+
+			if (!bEventDrivenGizmoUpdates || IsGizmoScaleDirty(cameraLocation, cameraForward, fieldOfView))
+				Gizmo->ScaleGizmoScene(cameraLocation, cameraForward, fieldOfView);
+		}
+	}
+
+	if (!bEventDrivenGizmoUpdates || IsGizmoSpaceDirty())
+		ApplyGizmoSpace();
+}
+
+void UTransformerComponent::UpdateComponentTickState()
+{
+	if (bEventDrivenGizmoUpdates)
+		SetComponentTickEnabled(NeedsTick());
+	else if (!IsComponentTickEnabled())
+		SetComponentTickEnabled(true);
+}
+
+bool UTransformerComponent::NeedsTick() const
+{
+	//without a Gizmo, dragging (the only Tick work left) needs the Local Mouse
+	return Gizmo || (CurrentDomain != ETransformationDomain::TD_None && !IsHeadless())
+		|| IsInterpolatingStreamedDrags();
+}
+
+bool UTransformerComponent::IsHeadless() const
+{
+	if (!bLocalGizmosOnly) return false;
+	APlayerController* PlayerController = GetPlayerController();
+	return !PlayerController || !PlayerController->IsLocalController();
+}
+
+const ABaseGizmo* UTransformerComponent::GetGizmoDefaults() const
+{
+	UClass* gizmoClass = GetGizmoClass(CurrentTransformation);
+	return gizmoClass ? gizmoClass->GetDefaultObject<ABaseGizmo>() : nullptr;
+}
+
+bool UTransformerComponent::GetVirtualGizmoTransform(FTransform& outTransform) const
+{
+	const ABaseGizmo* gizmo = GetGizmoDefaults();
+	if (!gizmo) return false;
+
+	//same Placement as UpdateGizmoPlacement
+	FTransform placement = FTransform::Identity;
+	if (!SelectedComponents.IsEmpty())
 	{
-		if (LocalPlayerController->PlayerCameraManager)
+		USceneComponent* placedComponent = nullptr;
+		switch (GizmoPlacement)
 		{
-			Gizmo->ScaleGizmoScene(LocalPlayerController->PlayerCameraManager->GetCameraLocation()
-			                       , LocalPlayerController->PlayerCameraManager->GetActorForwardVector()
-			                       , LocalPlayerController->PlayerCameraManager->GetFOVAngle());
+		case EGizmoPlacement::GP_OnFirstSelection:
+			placedComponent = SelectedComponents.First();
+			break;
+		case EGizmoPlacement::GP_OnLastSelection:
+			placedComponent = SelectedComponents.Last();
+			break;
+		default: ;
 		}
+		if (placedComponent)
+			placement = placedComponent->GetComponentTransform();
+	}
+	else
+	{
+		UInstancedStaticMeshComponent* ism;
+		int32 instance;
+		if (!GetGizmoInstance(ism, instance) || !ism->GetInstanceTransform(instance, placement, true))
+			return false;
+	}
+
+	//same Space as ApplyGizmoSpace
+	const bool bWorldSpace = gizmo->GetEffectiveSpace(CurrentSpaceType) == ESpaceType::ST_World;
+	outTransform = FTransform(bWorldSpace ? FQuat::Identity : placement.GetRotation(), placement.GetLocation());
+	return true;
+}
+
+bool UTransformerComponent::GetTransformPivot(FVector& outPivot) const
+{
+	if (Gizmo)
+	{
+		outPivot = Gizmo->GetActorLocation();
+		return true;
+	}
+
+	FTransform virtualTransform;
+	if (!IsHeadless() || !GetVirtualGizmoTransform(virtualTransform)) return false;
+	outPivot = virtualTransform.GetLocation();
+	return true;
+}
+
+bool UTransformerComponent::IsGizmoScaleDirty(const FVector& CameraLocation, const FVector& CameraForward
+                                              , float FieldOfView)
+{
+	const FTransform& gizmoTransform = Gizmo->GetActorTransform();
+	const bool bInProgress = Gizmo->GetTransformProgressState();
+	const float angleThreshold = FMath::DegreesToRadians(GizmoUpdateAngleThreshold);
+
+	const bool bDirty = bGizmoScaleDirty
+		|| bInProgress != bLastScaleInProgress
+		|| !FMath::IsNearlyEqual(FieldOfView, LastScaleFieldOfView, GizmoUpdateAngleThreshold)
+		|| !CameraLocation.Equals(LastScaleCameraLocation, GizmoUpdateLocationThreshold)
+		|| FVector::DotProduct(CameraForward, LastScaleCameraForward) < FMath::Cos(angleThreshold)
+		|| !gizmoTransform.GetLocation().Equals(LastScaleGizmoTransform.GetLocation(), GizmoUpdateLocationThreshold)
+		|| gizmoTransform.GetRotation().AngularDistance(LastScaleGizmoTransform.GetRotation()) > angleThreshold
+		|| !gizmoTransform.GetScale3D().Equals(LastScaleGizmoTransform.GetScale3D(), KINDA_SMALL_NUMBER);
+
+	if (bDirty)
+	{
+		LastScaleCameraLocation = CameraLocation;
+		LastScaleCameraForward = CameraForward;
+		LastScaleFieldOfView = FieldOfView;
+		LastScaleGizmoTransform = gizmoTransform;
+		bLastScaleInProgress = bInProgress;
+		bGizmoScaleDirty = false;
 	}
+	return bDirty;
+}
+
+bool UTransformerComponent::IsGizmoSpaceDirty() const
+{
+	if (bGizmoSpaceDirty || LastAppliedSpaceType != CurrentSpaceType)
+		return true;
 
+	USceneComponent* parent = Gizmo->GetRootComponent() ? Gizmo->GetRootComponent()->GetAttachParent() : nullptr;
+	if (parent != LastSpaceParent.Get())
+		return true;
+
+	//World Space needs to be reapplied if the parent rotated
+	return parent && !parent->GetComponentQuat().Equals(LastSpaceParentRotation, KINDA_SMALL_NUMBER);
+}
+
+void UTransformerComponent::ApplyGizmoSpace()
+{
+	if (!Gizmo) return;
 
 	Gizmo->UpdateGizmoSpace(CurrentSpaceType);
-	//ToDo: change when this is called to improve performance when a gizmo is there without doing anything
+
+	USceneComponent* parent = Gizmo->GetRootComponent() ? Gizmo->GetRootComponent()->GetAttachParent() : nullptr;
+
+	//a Gizmo placed on an Instance has no parent to take the Local Space from, so use the Instance's rotation
+	UInstancedStaticMeshComponent* instanceComponent;
+	int32 instance;
+	FTransform instanceTransform;
+	if (!parent && bGizmoOnInstance && CurrentSpaceType == ESpaceType::ST_Local
+		&& GetGizmoInstance(instanceComponent, instance)
+		&& instanceComponent->GetInstanceTransform(instance, instanceTransform, true))
+		Gizmo->SetActorRotation(instanceTransform.GetRotation());
+
+	LastAppliedSpaceType = CurrentSpaceType;
+	LastSpaceParent = parent;
+	LastSpaceParentRotation = parent ? parent->GetComponentQuat() : FQuat::Identity;
+	bGizmoSpaceDirty = false;
 }
 
 APlayerController* UTransformerComponent::GetPlayerController() const
@@ -370,6 +1156,7 @@ FTransform UTransformerComponent::UpdateTransform(const FVector& LookingVector
                                                   , const FVector& RayOrigin
                                                   , const FVector& RayDirection)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_UpdateTransform);
 	FTransform deltaTransform;
 	deltaTransform.SetScale3D(FVector::ZeroVector);
 
@@ -392,72 +1179,394 @@ FTransform UTransformerComponent::UpdateTransform(const FVector& LookingVector
 		                                            , calcDeltaTransform, CurrentDomain, *snappingValue);
 	//GetSnapped Transform Modifies Accumulated Delta Transform by how much Snapping Occurred
 
-	ApplyDeltaTransform(deltaTransform);
+	//the Snapshot is invalidated when the Selection changes, so take a new one from the current transforms
+	if (!DragSnapshot.IsValid())
+		CaptureDragSnapshot();
+
+	AccumulateDeltaTransform(DragDeltaTransform, deltaTransform);
+	ApplyDragTransform();
 	return deltaTransform;
 }
 
 void UTransformerComponent::ApplyDeltaTransform(const FTransform& DeltaTransform)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ApplyDeltaTransform);
+	FVector gizmoLocation;
+	if (!GetTransformPivot(gizmoLocation)) return;
+
 	bool* snappingEnabled = SnappingEnabled.Find(CurrentTransformation);
 	float* snappingValue = SnappingValues.Find(CurrentTransformation);
+	const bool bSnapping = snappingEnabled && *snappingEnabled && snappingValue;
+	const float snapping = bSnapping ? *snappingValue : 0.f;
 
-	for (auto& sc : SelectedComponents)
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	GetTransformableComponents(components, entries);
+
+	const ABaseGizmo* gizmo = Gizmo ? Gizmo : GetGizmoDefaults();
+	const ETransformationDomain domain = CurrentDomain;
+	const bool bLocalAxis = bRotateOnLocalAxis;
+
+	/* COMPUTE STAGE: only reads the Component Transforms, so it can be done in parallel */
+	TArray<FTransform> newTransforms;
+	newTransforms.SetNumUninitialized(components.Num());
+
+	ParallelFor(components.Num(), [&](int32 i)
 	{
-		if (!sc) continue;
-		if (bForceMobility || sc->Mobility == EComponentMobility::Type::Movable)
-		{
-			const FTransform& componentTransform = sc->GetComponentTransform();
+		const FTransform& componentTransform = components[i]->GetComponentTransform();
 
-			FQuat deltaRotation = DeltaTransform.GetRotation();
+		FTransform newTransform = ComputeDeltaAppliedTransform(componentTransform, DeltaTransform
+		                                                       , gizmoLocation, bLocalAxis);
 
-			FVector deltaLocation = componentTransform.GetLocation()
-				- Gizmo->GetActorLocation();
+		/* SNAPPING LOGIC PER COMPONENT */
+		if (bSnapping)
+			newTransform = gizmo->GetSnappedTransformPerComponent(componentTransform
+			                                                      , newTransform, domain, snapping);
 
-			//DeltaScale is Unrotated Scale to Get Local Scale since World Scale is not supported
-			FVector deltaScale = componentTransform.GetRotation()
-			                                       .UnrotateVector(DeltaTransform.GetScale3D());
+		newTransforms[i] = newTransform;
+	}, components.Num() < MinComponentsForParallelTransform);
 
+	/* APPLY STAGE: done in the Game Thread */
+	ApplyComponentTransforms(components, entries, newTransforms);
 
-			if (false == bRotateOnLocalAxis)
-				deltaLocation = deltaRotation.RotateVector(deltaLocation);
+	ApplyDeltaTransformToInstances(DeltaTransform);
+}
+
+void UTransformerComponent::ApplyDeltaTransformToInstances(const FTransform& DeltaTransform)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ApplyInstanceTransforms);
+	FVector gizmoLocation;
+	if (SelectedInstances.Num() == 0 || !GetTransformPivot(gizmoLocation)) return;
 
-			FTransform newTransform(
-				deltaRotation * componentTransform.GetRotation(),
-				//adding Gizmo Location + prevDeltaLocation 
-				// (i.e. location from Gizmo to Object after optional Rotating)
-				// + deltaTransform Location Offset
-				deltaLocation + Gizmo->GetActorLocation() + DeltaTransform.GetLocation(),
-				deltaScale + componentTransform.GetScale3D());
+	bool* snappingEnabled = SnappingEnabled.Find(CurrentTransformation);
+	float* snappingValue = SnappingValues.Find(CurrentTransformation);
+	const bool bSnapping = snappingEnabled && *snappingEnabled && snappingValue;
+	const float snapping = bSnapping ? *snappingValue : 0.f;
 
+	const ABaseGizmo* gizmo = Gizmo ? Gizmo : GetGizmoDefaults();
+	const ETransformationDomain domain = CurrentDomain;
+	const bool bLocalAxis = bRotateOnLocalAxis;
 
-			/* SNAPPING LOGIC PER COMPONENT */
-			if (snappingEnabled && *snappingEnabled && snappingValue)
-				newTransform = Gizmo->GetSnappedTransformPerComponent(componentTransform
-				                                                      , newTransform, CurrentDomain, *snappingValue);
+	TArray<int32> instances;
+	TArray<FTransform> newTransforms;
 
-			sc->SetMobility(EComponentMobility::Type::Movable);
-			SetTransform(sc, newTransform);
+	for (auto it = SelectedInstances.CreateIterator(); it; ++it)
+	{
+		UInstancedStaticMeshComponent* ism = it.Key().Get();
+		if (!ism)
+		{
+			it.RemoveCurrent();
+			continue;
 		}
-		else
+
+		if (!CanTransform(ism))
 		{
 			UE_LOG(LogRuntimeTransformer, Warning,
-			       TEXT("Transform will not affect Component [%s] as it is NOT Moveable!"), *sc->GetName());
+			       TEXT("Transform will not affect the Instances of [%s] as it is NOT Moveable!"), *ism->GetName());
+			continue;
 		}
+
+		if (ism->Mobility != EComponentMobility::Type::Movable)
+			ism->SetMobility(EComponentMobility::Type::Movable);
+
+		//drop the Instances that were removed from the Component since they were selected
+		FInstanceSet& instanceSet = it.Value();
+		instanceSet.GetInstances(instances);
+		const int32 instanceCount = ism->GetInstanceCount();
+		while (instances.Num() > 0 && instances.Last() >= instanceCount)
+			instanceSet.Remove(instances.Pop(false));
+
+		/* COMPUTE STAGE */
+		newTransforms.SetNumUninitialized(instances.Num());
+		ParallelFor(instances.Num(), [&](int32 i)
+		{
+			FTransform instanceTransform;
+			ism->GetInstanceTransform(instances[i], instanceTransform, true);
+
+			FTransform newTransform = ComputeDeltaAppliedTransform(instanceTransform, DeltaTransform
+			                                                       , gizmoLocation, bLocalAxis);
+			if (bSnapping)
+				newTransform = gizmo->GetSnappedTransformPerComponent(instanceTransform
+				                                                      , newTransform, domain, snapping);
+			newTransforms[i] = newTransform;
+		}, instances.Num() < MinComponentsForParallelTransform);
+
+		/* APPLY STAGE */
+		UpdateInstanceTransforms(ism, instances, newTransforms);
+
+		if (instanceSet.IsEmpty())
+			it.RemoveCurrent();
 	}
+
+	//the Gizmo is not attached to the Instance, so it needs to be moved along with it
+	if (bGizmoOnInstance)
+		PlaceGizmoOnInstance();
 }
 
-bool UTransformerComponent::HandleTracedObjects(const TArray<FHitResult>& HitResults
-                                                , bool bAppendToList)
+void UTransformerComponent::GetTransformableComponents(TArray<USceneComponent*>& outComponents
+                                                       , TArray<FSelectionEntry>& outEntries) const
 {
-	//Assign as None just in case we don't hit Any Gizmos
-	ClearDomain();
-
-	//Search for our Gizmo (if Valid) First before Selecting any item
-	if (Gizmo)
+	outComponents.Reset(SelectedComponents.Num());
+	outEntries.Reset(SelectedComponents.Num());
+	SelectedComponents.ForEachEntry([&](USceneComponent* sc, const FSelectionEntry& entry)
 	{
-		for (auto& hitResult : HitResults)
+		if (!CanTransform(sc))
 		{
-			if (Gizmo == hitResult.GetActor()) //check if it's OUR gizmo
+			UE_LOG(LogRuntimeTransformer, Warning,
+			       TEXT("Transform will not affect Component [%s] as it is NOT Moveable!"), *sc->GetName());
+			return;
+		}
+
+		//the component will already be moved along with its selected ancestor (a Root has none, so no need to walk up).
+		//Walked for the rest, as the ancestor might not be transformable
+		if (!SelectedComponents.IsRoot(sc) && IsTransformedByAncestor(sc)) return;
+
+		outComponents.Add(sc);
+		outEntries.Add(entry);
+	});
+}
+
+bool UTransformerComponent::CanTransform(const USceneComponent* Component) const
+{
+	return bForceMobility || Component->Mobility == EComponentMobility::Type::Movable;
+}
+
+bool UTransformerComponent::IsTransformedByAncestor(const USceneComponent* Component) const
+{
+	for (USceneComponent* parent = Component->GetAttachParent(); parent; parent = parent->GetAttachParent())
+	{
+		if (SelectedComponents.Contains(parent) && CanTransform(parent))
+			return true;
+	}
+	return false;
+}
+
+void UTransformerComponent::ApplyComponentTransforms(const TArray<USceneComponent*>& Components
+                                                     , const TArray<FSelectionEntry>& Entries
+                                                     , const TArray<FTransform>& Transforms)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ApplyComponentTransforms);
+	check(Components.Num() == Transforms.Num() && Components.Num() == Entries.Num());
+	INC_DWORD_STAT_BY(STAT_RuntimeTransformer_ComponentsTransformed, Components.Num());
+
+	//the Components of each UFocusable are gathered so that it's notified once, rather than once per Component
+	struct FFocusableTransforms
+	{
+		const FSelectionEntry* Entry;
+		TArray<USceneComponent*> Components;
+		TArray<FTransform> Transforms;
+	};
+	TArray<FFocusableTransforms> focusables;
+	TMap<UObject*, int32> focusableIndex;
+
+	for (int32 i = 0; i < Components.Num(); ++i)
+	{
+		USceneComponent* component = Components[i];
+		if (!component) continue;
+
+		//only write the mobility if it actually changes
+		if (component->Mobility != EComponentMobility::Type::Movable)
+			component->SetMobility(EComponentMobility::Type::Movable);
+
+		if (UObject* focusableObject = Entries[i].GetFocusable())
+		{
+			int32 index;
+			if (int32* foundIndex = focusableIndex.Find(focusableObject))
+				index = *foundIndex;
+			else
+			{
+				index = focusables.AddDefaulted();
+				focusables[index].Entry = &Entries[i];
+				focusableIndex.Add(focusableObject, index);
+			}
+			focusables[index].Components.Add(component);
+			focusables[index].Transforms.Add(Transforms[i]);
+			continue;
+		}
+
+		SetComponentTransform(component, Transforms[i]);
+	}
+
+	//the UFocusables are notified before their Components are moved (if they are moved at all)
+	for (const FFocusableTransforms& focusable : focusables)
+	{
+		NotifyNewTransformations(*focusable.Entry, focusable.Components, focusable.Transforms);
+
+		if (!bTransformUFocusableObjects) continue;
+
+		for (int32 i = 0; i < focusable.Components.Num(); ++i)
+		{
+			USceneComponent* component = focusable.Components[i];
+			if (!IsValid(component)) continue; //the UFocusable might have destroyed it
+
+			SetComponentTransform(component, focusable.Transforms[i]);
+		}
+	}
+}
+
+void UTransformerComponent::SetComponentTransform(USceneComponent* Component, const FTransform& Transform)
+{
+	if (DragPreview.IsActive() && DragPreview.Contains(Component))
+	{
+		FDragPreview::MoveComponent(Component, Transform);
+		return;
+	}
+
+	// defer the overlap updates so that the transform results in a single update for the component and its children
+	FScopedMovementUpdate scopedMovement(Component, EScopedUpdate::DeferredUpdates);
+	Component->SetWorldTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void UTransformerComponent::CaptureDragSnapshot()
+{
+	//the Snapshot is kept for the whole Drag, so it must not be taken from stale Roots
+	//(Selected Components might have been re-attached since they were Selected)
+	SelectedComponents.RebuildRoots();
+
+	FVector pivot;
+	if (!GetTransformPivot(pivot)) return;
+
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	GetTransformableComponents(components, entries);
+
+	DragSnapshot.Capture(components, entries, pivot);
+	CaptureInstanceDragSnapshot(pivot);
+	ResetDeltaTransform(DragDeltaTransform);
+}
+
+void UTransformerComponent::ApplyDragTransform()
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ApplyDragTransform);
+	const ABaseGizmo* gizmo = Gizmo ? Gizmo : GetGizmoDefaults();
+	if (!gizmo || !DragSnapshot.IsValid()) return;
+
+	bool* snappingEnabled = SnappingEnabled.Find(CurrentTransformation);
+	float* snappingValue = SnappingValues.Find(CurrentTransformation);
+	const bool bSnapping = snappingEnabled && *snappingEnabled && snappingValue;
+	const float snapping = bSnapping ? *snappingValue : 0.f;
+
+	const ETransformationDomain domain = CurrentDomain;
+	const bool bLocalAxis = bRotateOnLocalAxis;
+	const int32 count = DragSnapshot.Num();
+
+	TArray<FTransform> newTransforms;
+	newTransforms.SetNumUninitialized(count);
+
+	ParallelFor(count, [&](int32 i)
+	{
+		FTransform newTransform = DragSnapshot.ComputeTransform(i, DragDeltaTransform, bLocalAxis);
+
+		/* SNAPPING LOGIC PER COMPONENT */
+		if (bSnapping)
+			newTransform = gizmo->GetSnappedTransformPerComponent(DragSnapshot.GetTransform(i)
+			                                                      , newTransform, domain, snapping);
+		newTransforms[i] = newTransform;
+	}, count < MinComponentsForParallelTransform);
+
+	ApplyComponentTransforms(DragSnapshot.GetComponents(), DragSnapshot.GetEntries(), newTransforms);
+
+	ApplyInstanceDragTransform();
+}
+
+void UTransformerComponent::CaptureInstanceDragSnapshot(const FVector& Pivot)
+{
+	InstanceDragSnapshots.Reset();
+	InstanceDragPivot = Pivot;
+
+	for (auto& pair : SelectedInstances)
+	{
+		UInstancedStaticMeshComponent* ism = pair.Key.Get();
+		if (!ism) continue;
+
+		if (!CanTransform(ism))
+		{
+			UE_LOG(LogRuntimeTransformer, Warning,
+			       TEXT("Transform will not affect the Instances of [%s] as it is NOT Moveable!"), *ism->GetName());
+			continue;
+		}
+
+		if (ism->Mobility != EComponentMobility::Type::Movable)
+			ism->SetMobility(EComponentMobility::Type::Movable);
+
+		FInstanceSnapshot& snapshot = InstanceDragSnapshots.AddDefaulted_GetRef();
+		snapshot.Component = ism;
+		pair.Value.GetInstances(snapshot.Instances);
+
+		//drop the Instances that were removed from the Component since they were selected
+		const int32 instanceCount = ism->GetInstanceCount();
+		while (snapshot.Instances.Num() > 0 && snapshot.Instances.Last() >= instanceCount)
+			snapshot.Instances.Pop(false);
+
+		snapshot.Transforms.SetNumUninitialized(snapshot.Instances.Num());
+		for (int32 i = 0; i < snapshot.Instances.Num(); ++i)
+			ism->GetInstanceTransform(snapshot.Instances[i], snapshot.Transforms[i], true);
+	}
+}
+
+void UTransformerComponent::ApplyInstanceDragTransform()
+{
+	if (InstanceDragSnapshots.Num() == 0) return;
+
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ApplyInstanceTransforms);
+	const ABaseGizmo* gizmo = Gizmo ? Gizmo : GetGizmoDefaults();
+
+	bool* snappingEnabled = SnappingEnabled.Find(CurrentTransformation);
+	float* snappingValue = SnappingValues.Find(CurrentTransformation);
+	const bool bSnapping = gizmo && snappingEnabled && *snappingEnabled && snappingValue;
+	const float snapping = bSnapping ? *snappingValue : 0.f;
+
+	const ETransformationDomain domain = CurrentDomain;
+	const bool bLocalAxis = bRotateOnLocalAxis;
+
+	TArray<FTransform> newTransforms;
+	for (const FInstanceSnapshot& snapshot : InstanceDragSnapshots)
+	{
+		UInstancedStaticMeshComponent* ism = snapshot.Component.Get();
+		if (!ism) continue;
+
+		//computed from the Transforms at the start of the Drag, like the Components
+		const int32 count = snapshot.Instances.Num();
+		newTransforms.SetNumUninitialized(count);
+		ParallelFor(count, [&](int32 i)
+		{
+			const FTransform& startTransform = snapshot.Transforms[i];
+			FTransform newTransform = ComputeDeltaAppliedTransform(startTransform, DragDeltaTransform
+			                                                       , InstanceDragPivot, bLocalAxis);
+			if (bSnapping)
+				newTransform = gizmo->GetSnappedTransformPerComponent(startTransform, newTransform, domain, snapping);
+			newTransforms[i] = newTransform;
+		}, count < MinComponentsForParallelTransform);
+
+		UpdateInstanceTransforms(ism, snapshot.Instances, newTransforms);
+	}
+
+	//the Gizmo is not attached to the Instance, so it needs to be moved along with it
+	if (bGizmoOnInstance)
+		PlaceGizmoOnInstance();
+}
+
+void UTransformerComponent::AccumulateDeltaTransform(FTransform& outAccumulatedTransform
+                                                     , const FTransform& DeltaTransform)
+{
+	outAccumulatedTransform = FTransform(
+		DeltaTransform.GetRotation() * outAccumulatedTransform.GetRotation(),
+		DeltaTransform.GetLocation() + outAccumulatedTransform.GetLocation(),
+		DeltaTransform.GetScale3D() + outAccumulatedTransform.GetScale3D());
+}
+
+bool UTransformerComponent::HandleTracedObjects(const TArray<FHitResult>& HitResults
+                                                , bool bAppendToList)
+{
+	//Assign as None just in case we don't hit Any Gizmos
+	ClearDomain();
+
+	//Search for our Gizmo (if Valid) First before Selecting any item
+	if (Gizmo)
+	{
+		for (auto& hitResult : HitResults)
+		{
+			if (Gizmo == hitResult.GetActor()) //check if it's OUR gizmo
 			{
 				//Check which Domain of Gizmo was Hit from the Test
 				if (USceneComponent* componentHit = Cast<USceneComponent>(hitResult.Component))
@@ -478,6 +1587,15 @@ bool UTransformerComponent::HandleTracedObjects(const TArray<FHitResult>& HitRes
 		if (Cast<ABaseGizmo>(hits.GetActor()))
 			continue; //ignore other Gizmos.
 
+		if (bSelectInstances && hits.Item != INDEX_NONE)
+		{
+			if (UInstancedStaticMeshComponent* ism = Cast<UInstancedStaticMeshComponent>(hits.GetComponent()))
+			{
+				SelectInstance(ism, hits.Item, bAppendToList);
+				return true;
+			}
+		}
+
 		if (bComponentBased)
 			SelectComponent(Cast<USceneComponent>(hits.GetComponent()), bAppendToList);
 		else
@@ -491,6 +1609,7 @@ bool UTransformerComponent::HandleTracedObjects(const TArray<FHitResult>& HitRes
 
 void UTransformerComponent::SetComponentBased(bool bIsComponentBased)
 {
+	FScopedSelectionTransaction SelectionTransaction(this);
 	auto selectedComponents = DeselectAll();
 	bComponentBased = bIsComponentBased;
 	if (bComponentBased)
@@ -521,6 +1640,7 @@ void UTransformerComponent::SetTransformationType(ETransformationType Transforma
 
 
 	CurrentTransformation = TransformationType;
+	bObservedStateDirty = true;
 
 	//Clear the Accumulated tranform when we have a new Transformation
 	ResetDeltaTransform(AccumulatedDeltaTransform);
@@ -541,14 +1661,14 @@ void UTransformerComponent::SetSnappingValue(ETransformationType TransformationT
 void UTransformerComponent::GetSelectedComponents(TArray<class USceneComponent*>& outComponentList
                                                   , USceneComponent*& outGizmoPlacedComponent) const
 {
-	outComponentList = SelectedComponents;
+	outComponentList = SelectedComponents.ToArray();
 	if (Gizmo)
 		outGizmoPlacedComponent = Gizmo->GetParentComponent();
 }
 
 TArray<USceneComponent*> UTransformerComponent::GetSelectedComponents() const
 {
-	return SelectedComponents;
+	return SelectedComponents.ToArray();
 }
 
 void UTransformerComponent::CloneSelected(bool bSelectNewClones
@@ -559,15 +1679,77 @@ void UTransformerComponent::CloneSelected(bool bSelectNewClones
 		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Cloning in a Non-Authority! Please use the Clone RPCs instead"));
 	}
 
+	const TArray<USceneComponent*> selectedComponents = SelectedComponents.ToArray();
 
-	auto CloneComponents = CloneFromList(SelectedComponents);
+	//the Clone Hierarchy Phase trusts the Roots, which go stale if Selected Components were re-attached
+	SelectedComponents.RebuildRoots();
 
-	if (bSelectNewClones)
-		SelectMultipleComponents(CloneComponents, bAppendToList);
+	//the Instance Clones deselect the current Selection (if not appending), so the rest must append to them
+	if (HasSelectedInstances())
+	{
+		CloneSelectedInstances(bSelectNewClones, bAppendToList);
+		bAppendToList = true;
+	}
+
+	if (selectedComponents.Num() == 0) return;
+
+	if (bComponentBased)
+	{
+		auto CloneComponents = CloneFromList(selectedComponents);
+
+		if (bSelectNewClones)
+			SelectMultipleComponents(CloneComponents, bAppendToList);
+		return;
+	}
+
+	TArray<AActor*> actors;
+	actors.Reserve(selectedComponents.Num());
+	for (USceneComponent* sc : selectedComponents)
+		if (AActor* owner = sc->GetOwner())
+			actors.Add(owner);
+
+	BeginCloneBatch(actors, bSelectNewClones, bAppendToList);
+}
+
+void UTransformerComponent::CloneSelectedInstances(bool bSelectNewClones, bool bAppendToList)
+{
+	TArray<TPair<UInstancedStaticMeshComponent*, TArray<int32>>> clones;
+	TArray<int32> instances;
+	TArray<FTransform> transforms;
+
+	for (auto& pair : SelectedInstances)
+	{
+		UInstancedStaticMeshComponent* ism = pair.Key.Get();
+		if (!ism) continue;
+
+		pair.Value.GetInstances(instances);
+		transforms.Reset(instances.Num());
+		for (int32 instance : instances)
+		{
+			FTransform instanceTransform;
+			if (ism->GetInstanceTransform(instance, instanceTransform, false))
+				transforms.Add(instanceTransform);
+		}
+
+		//a single call (and render state refresh) for all the Instances of the Component
+		clones.Emplace(ism, ism->AddInstances(transforms, true));
+	}
+
+	if (!bSelectNewClones) return;
+
+	FScopedSelectionTransaction SelectionTransaction(this);
+	if (false == bAppendToList)
+		DeselectAll();
+	for (auto& clone : clones)
+	{
+		for (int32 instance : clone.Value)
+			SelectInstance(clone.Key, instance, true);
+	}
 }
 
 TArray<class USceneComponent*> UTransformerComponent::CloneFromList(const TArray<USceneComponent*>& ComponentList)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_CloneFromList);
 	TArray<class USceneComponent*> outClones;
 	if (bComponentBased)
 	{
@@ -598,193 +1780,796 @@ TArray<class USceneComponent*> UTransformerComponent::CloneFromList(const TArray
 
 TArray<class USceneComponent*> UTransformerComponent::CloneActors(const TArray<AActor*>& Actors)
 {
-	TArray<class USceneComponent*> outClones;
-
-	UWorld* world = GetWorld();
-	if (!world) return outClones;
+	FCloneBatch batch;
+	batch.Init(Actors, false, false);
+	CloneBatchChunk(batch, batch.Num());
+	return batch.GetCloneRoots();
+}
 
-	TSet<AActor*> actorsProcessed;
-	TArray<AActor*> actorsToSelect;
-	for (auto& templateActor : Actors)
-	{
-		if (!templateActor) continue;
-		bool bAlreadyProcessed;
-		actorsProcessed.Add(templateActor, &bAlreadyProcessed);
-		if (bAlreadyProcessed) continue;
+void UTransformerComponent::BeginCloneBatch(const TArray<AActor*>& Actors, bool bSelectNewClones
+                                            , bool bAppendToList)
+{
+	if (CloneBatch.IsActive())
+		FlushCloneBatch();
 
-		FTransform spawnTransform;
-		FActorSpawnParameters spawnParams;
+	CloneBatch.Init(Actors, bSelectNewClones, bAppendToList);
+	RunCloneBatch();
+}
 
-		spawnParams.Template = templateActor;
-		if (templateActor)
-			templateActor->bNetStartup = false;
+void UTransformerComponent::BeginSpawnBatch(const TArray<UClass*>& Classes, const TArray<FTransform>& Transforms)
+{
+	if (CloneBatch.IsActive())
+		FlushCloneBatch();
 
-		if (AActor* actor = world->SpawnActor(templateActor->GetClass()
-		                                      , &spawnTransform, spawnParams))
-		{
-			outClones.Add(actor->GetRootComponent());
-		}
-	}
-	return outClones;
+	CloneBatch.InitSpawns(Classes, Transforms, false, false);
+	RunCloneBatch();
 }
 
-TArray<class USceneComponent*> UTransformerComponent::CloneComponents(const TArray<class USceneComponent*>& Components)
+void UTransformerComponent::RunCloneBatch()
 {
-	TArray<class USceneComponent*> outClones;
+	if (CloneFrameBudgetMs > 0.f)
+		ProcessCloneBatch();
+	else
+		FlushCloneBatch();
+}
 
-	UWorld* world = GetWorld();
-	if (!world) return outClones;
+void UTransformerComponent::ProcessCloneBatch()
+{
+	CloneBatchTimerHandle.Invalidate();
+	if (!CloneBatch.IsActive()) return;
 
-	TMap<USceneComponent*, USceneComponent*> OcCc; //Original component - Clone component
-	TMap<USceneComponent*, USceneComponent*> CcOp; //Clone component - Original parent
+	const double budget = CloneFrameBudgetMs / 1000.0;
+	const double startTime = FPlatformTime::Seconds();
+	double elapsed = 0.0;
 
-	//clone components phase
-	for (auto& templateComponent : Components)
+	//at least one chunk is processed per frame, so that the Batch always moves forward
+	do
 	{
-		if (!templateComponent) continue;
-		AActor* owner = templateComponent->GetOwner();
-		if (!owner) continue;
+		const int32 remaining = CloneBatch.Num() - CloneBatch.NextTemplate;
 
-		if (USceneComponent* clone = Cast<USceneComponent>(
-			StaticDuplicateObject(templateComponent, owner)))
-		{
-			clone->OnComponentCreated();
+		//until the time a Clone takes is known, do a single one
+		const int32 count = CloneBatch.AverageCloneTime > 0.0
+			                    ? FMath::Clamp(FMath::FloorToInt((budget - elapsed) / CloneBatch.AverageCloneTime)
+			                                   , 1, remaining)
+			                    : 1;
 
-			clone->RegisterComponent();
-			clone->SetRelativeTransform(templateComponent->GetRelativeTransform());
+		const double chunkStartTime = FPlatformTime::Seconds();
+		CloneBatchChunk(CloneBatch, count);
+		const double cloneTime = FMath::Max((FPlatformTime::Seconds() - chunkStartTime) / count, 1e-6);
 
-			outClones.Add(clone);
-			//Add to these two maps for reparenting in next phase
-			OcCc.Add(templateComponent, clone); //Original component - Clone component
+		CloneBatch.AverageCloneTime = CloneBatch.AverageCloneTime > 0.0
+			                              ? (CloneBatch.AverageCloneTime + cloneTime) * 0.5
+			                              : cloneTime;
 
-			if (templateComponent == owner->GetRootComponent())
-				CcOp.Add(clone, owner->GetRootComponent());
-				//this will cause a loop in the maps, so we must check for this!
-			else
-				CcOp.Add(clone, templateComponent->GetAttachParent()); //Clone component - Original parent
-		}
+		elapsed = FPlatformTime::Seconds() - startTime;
 	}
+	while (!CloneBatch.IsDone() && elapsed < budget);
+
+	OnCloneBatchProgress.Broadcast(CloneBatch.NextTemplate, CloneBatch.Num());
+
+	if (CloneBatch.IsDone())
+		CompleteCloneBatch();
+	else if (UWorld* world = GetWorld())
+		CloneBatchTimerHandle = world->GetTimerManager().SetTimerForNextTick(
+			this, &UTransformerComponent::ProcessCloneBatch);
+}
+
+void UTransformerComponent::FlushCloneBatch()
+{
+	if (UWorld* world = GetWorld())
+		world->GetTimerManager().ClearTimer(CloneBatchTimerHandle);
+
+	if (!CloneBatch.IsActive()) return;
 
-	TArray<USceneComponent*> componentsToSelect;
-	//reparenting phase
-	FAttachmentTransformRules attachmentRule(EAttachmentRule::KeepWorld, false);
-	for (auto& cp : CcOp)
+	CloneBatchChunk(CloneBatch, CloneBatch.Num() - CloneBatch.NextTemplate);
+	OnCloneBatchProgress.Broadcast(CloneBatch.NextTemplate, CloneBatch.Num());
+	CompleteCloneBatch();
+}
+
+//The Component of the Clone that was cloned from the Template Component (same name). Falls back to the Clone Root
+static USceneComponent* FindClonedComponent(AActor* Clone, const USceneComponent* TemplateComponent)
+{
+	TInlineComponentArray<USceneComponent*> components(Clone);
+	for (USceneComponent* component : components)
 	{
-		//original parent
-		USceneComponent* parent = cp.Value;
+		if (component->GetFName() == TemplateComponent->GetFName())
+			return component;
+	}
+	return Clone->GetRootComponent();
+}
+
+void UTransformerComponent::CloneBatchChunk(FCloneBatch& Batch, int32 Count)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_CloneBatchChunk);
+	const int32 first = Batch.NextTemplate;
+	const int32 last = FMath::Min(first + Count, Batch.Num());
+	Batch.NextTemplate = last;
 
-		AActor* actorOwner = cp.Value->GetOwner();
+	UWorld* world = GetWorld();
+	if (!world) return;
 
-		//find if we cloned the original parent
-		USceneComponent** cloneParent = OcCc.Find(parent);
+	//Identity, so that the Clone Root keeps the Template Root Transform
+	const FTransform spawnTransform;
 
-		if (cloneParent)
+	/* SPAWN STAGE: construct all the Clones of the chunk, without finishing them */
+	for (int32 i = first; i < last; ++i)
+	{
+		if (Batch.IsSpawnBatch())
 		{
-			if (*cloneParent != cp.Key) //make sure comp is not its own parent
-				parent = *cloneParent;
+			FActorSpawnParameters spawnParams;
+			spawnParams.bDeferConstruction = true;
+			Batch.Clones[i] = world->SpawnActor(Batch.SpawnClasses[i], &Batch.SpawnTransforms[i], spawnParams);
+			continue;
 		}
-		else
-		{
-			//couldn't find its parent, so find the parent of the parent and see if it's in the list.
-			//repeat until found or root is reached
-			while (1)
-			{
-				//if parent is root, then no need to find parents above it. (none)
-				//attach to original parent, since there are no cloned parents.
-				if (parent == actorOwner->GetRootComponent())
-				{
-					parent = cp.Value;
-					break;
-				}
 
-				//check if parents have been cloned
-				cloneParent = OcCc.Find(parent->GetAttachParent());
-				if (cloneParent)
-				{
-					//attach to cloned parent if found
-					parent = *cloneParent;
-					break;
-				}
-				parent = parent->GetAttachParent(); //move up in the hierarchy
-			}
-		}
+		AActor* templateActor = Batch.Templates[i];
+		if (!IsValid(templateActor)) continue;
 
-		cp.Key->AttachToComponent(parent, attachmentRule);
+		FActorSpawnParameters spawnParams;
+		spawnParams.Template = templateActor;
+		spawnParams.bDeferConstruction = true;
+		templateActor->bNetStartup = false;
 
-		//Selecting childs and parents can cause weird issues 
-		// so only select the topmost clones (those that do not have cloned parents!)
-		//only select those that have an "original parent". 
-		//if ((parent == cp.Value 
-		//	|| parent == actorOwner->GetRootComponent())) 
-		//	//check if the parent of the cloned is original (means it's topmost)
-		//	outParents.Add(cp.Key);
+		Batch.Clones[i] = world->SpawnActor(templateActor->GetClass(), &spawnTransform, spawnParams);
 	}
 
-	return outClones;
-}
+	/* ATTACH STAGE: a Clone whose Template is attached to another Template goes to that Template's Clone */
+	for (int32 i = first; i < last; ++i)
+	{
+		AActor* clone = Batch.Clones[i];
+		if (!clone || !Batch.Templates[i]) continue;
 
-void UTransformerComponent::SelectComponent(class USceneComponent* Component
-                                            , bool bAppendToList)
-{
-	if (!Component) return;
+		USceneComponent* cloneRoot = clone->GetRootComponent();
+		USceneComponent* templateRoot = Batch.Templates[i]->GetRootComponent();
+		USceneComponent* templateParent = templateRoot ? templateRoot->GetAttachParent() : nullptr;
+		if (!cloneRoot || !templateParent) continue;
 
-	if (ShouldSelect(Component->GetOwner(), Component))
+		//Parent-first order, so the Clone of the Parent (if any) has already been spawned
+		const int32 parentIndex = Batch.FindTemplate(templateParent->GetOwner());
+		if (parentIndex == INDEX_NONE || !Batch.Clones[parentIndex]) continue;
+
+		USceneComponent* cloneParent = FindClonedComponent(Batch.Clones[parentIndex], templateParent);
+		const FName socketName = templateRoot->GetAttachSocketName();
+
+		//the Relative Transform was copied from the Template, so it's already relative to the (cloned) parent
+		if (cloneRoot->IsRegistered())
+			cloneRoot->AttachToComponent(cloneParent, FAttachmentTransformRules::KeepRelativeTransform, socketName);
+		else
+			cloneRoot->SetupAttachment(cloneParent, socketName);
+	}
+
+	/* FINISH STAGE: run the Construction & BeginPlay of the chunk, Parent-first */
+	for (int32 i = first; i < last; ++i)
 	{
-		if (false == bAppendToList)
-			DeselectAll();
-		AddComponent_Internal(SelectedComponents, Component);
-		UpdateGizmoPlacement();
+		if (AActor* clone = Batch.Clones[i])
+			clone->FinishSpawning(Batch.IsSpawnBatch() ? Batch.SpawnTransforms[i] : spawnTransform);
 	}
 }
 
-void UTransformerComponent::SelectActor(AActor* Actor
-                                        , bool bAppendToList)
+void UTransformerComponent::CompleteCloneBatch()
 {
-	if (!Actor) return;
+	TArray<USceneComponent*> clones = CloneBatch.GetCloneRoots();
+	const bool bSelectNewClones = CloneBatch.bSelectNewClones;
+	const bool bAppendToList = CloneBatch.bAppendToList;
+	CloneBatch.Reset();
 
-	if (ShouldSelect(Actor, Actor->GetRootComponent()))
+	if (IsRecordingHistory())
 	{
-		if (false == bAppendToList)
-			DeselectAll();
-		AddComponent_Internal(SelectedComponents, Actor->GetRootComponent());
-		UpdateGizmoPlacement();
+		TArray<AActor*> cloneActors;
+		cloneActors.Reserve(clones.Num());
+		for (USceneComponent* clone : clones)
+			if (clone)
+				cloneActors.Add(clone->GetOwner());
+
+		TArray<AActor*> releasedActors;
+		History.RecordActors(ETransformHistoryOperation::Clone, cloneActors, releasedActors);
+		DestroyReleasedActors(releasedActors);
 	}
+
+	if (bSelectNewClones)
+		SelectMultipleComponents(clones, bAppendToList);
+
+	if (CurrentDomain != ETransformationDomain::TD_None && Gizmo)
+		Gizmo->SetTransformProgressState(true, CurrentDomain);
+
+	OnCloneBatchCompleted.Broadcast(clones);
 }
 
-void UTransformerComponent::SelectMultipleComponents(const TArray<USceneComponent*>& Components
-                                                     , bool bAppendToList)
+void UTransformerComponent::ExportLayout(const TArray<USceneComponent*>& Components, TArray<uint8>& outData) const
 {
-	bool bValidList = false;
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ExportLayout);
 
-	for (auto& c : Components)
+	//Ancestors first, so that placing them on Import doesn't move the descendants placed before
+	TArray<TPair<int32, USceneComponent*>> sortedComponents;
+	sortedComponents.Reserve(Components.Num());
+	for (USceneComponent* component : Components)
 	{
-		if (!c) continue;
-		if (!ShouldSelect(c->GetOwner(), c)) continue;
+		if (!IsValid(component)) continue;
 
-		if (false == bAppendToList)
-		{
-			DeselectAll();
-			bAppendToList = true;
-			//only run once. This is not place outside in case a list is empty or contains only invalid components
-		}
-		bValidList = true;
-		AddComponent_Internal(SelectedComponents, c);
+		int32 depth = 0;
+		for (USceneComponent* parent = component->GetAttachParent(); parent; parent = parent->GetAttachParent())
+			++depth;
+		sortedComponents.Emplace(depth, component);
 	}
+	sortedComponents.StableSort([](const TPair<int32, USceneComponent*>& A, const TPair<int32, USceneComponent*>& B)
+	{
+		return A.Key < B.Key;
+	});
 
-	if (bValidList) UpdateGizmoPlacement();
+	TArray<FLayoutEntry> entries;
+	entries.Reserve(sortedComponents.Num());
+	for (const TPair<int32, USceneComponent*>& sortedComponent : sortedComponents)
+	{
+		USceneComponent* component = sortedComponent.Value;
+		FLayoutEntry& entry = entries.AddDefaulted_GetRef();
+
+#if WITH_EDITOR
+		//so that a Layout saved in PIE can be loaded in any other PIE instance (or a packaged game)
+		entry.Path = FSoftObjectPath(UWorld::RemovePIEPrefix(component->GetPathName()));
+#else
+		entry.Path = FSoftObjectPath(component);
+#endif
+
+		//the Actors loaded with the Level are found again, the ones Spawned at runtime might have to be Spawned
+		AActor* owner = component->GetOwner();
+		if (!bComponentBased && owner && owner->GetRootComponent() == component
+			&& !owner->HasAnyFlags(RF_WasLoaded))
+			entry.ActorClass = FSoftClassPath(owner->GetClass());
+
+		entry.Transform = component->GetComponentTransform();
+	}
+
+	FLayoutWriter::Write(entries, outData);
 }
 
-void UTransformerComponent::SelectMultipleActors(const TArray<AActor*>& Actors
-                                                 , bool bAppendToList)
+void UTransformerComponent::ExportSelectedLayout(TArray<uint8>& outData) const
 {
-	bool bValidList = false;
-	for (auto& a : Actors)
-	{
-		if (!a) continue;
-		if (!ShouldSelect(a, a->GetRootComponent())) continue;
+	ExportLayout(SelectedComponents.ToArray(), outData);
+}
 
-		if (false == bAppendToList)
-		{
+bool UTransformerComponent::SaveLayoutToFile(const FString& FilePath
+                                             , const TArray<USceneComponent*>& Components) const
+{
+	TArray<uint8> data;
+	ExportLayout(Components, data);
+	return FFileHelper::SaveArrayToFile(data, *FilePath);
+}
+
+bool UTransformerComponent::ImportLayout(const TArray<uint8>& Data)
+{
+	TUniquePtr<FLayoutImport> import = MakeUnique<FLayoutImport>();
+	if (!import->OpenData(TArray<uint8>(Data)))
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Data is not a valid Layout!"));
+		return false;
+	}
+
+	BeginLayoutImport(MoveTemp(import));
+	return true;
+}
+
+bool UTransformerComponent::LoadLayoutFromFile(const FString& FilePath)
+{
+	TUniquePtr<FLayoutImport> import = MakeUnique<FLayoutImport>();
+	if (!import->OpenFile(FilePath))
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("%s is not a valid Layout File!"), *FilePath);
+		return false;
+	}
+
+	BeginLayoutImport(MoveTemp(import));
+	return true;
+}
+
+void UTransformerComponent::BeginLayoutImport(TUniquePtr<FLayoutImport>&& Import)
+{
+	if (LayoutImport)
+		FlushLayoutImport();
+
+	LayoutImport = MoveTemp(Import);
+
+	if (LayoutImportEntriesPerFrame > 0)
+		ProcessLayoutImport();
+	else
+		FlushLayoutImport();
+}
+
+void UTransformerComponent::ProcessLayoutImport()
+{
+	LayoutImportTimerHandle.Invalidate();
+	if (!LayoutImport) return;
+
+	ReadLayoutEntries(LayoutImportEntriesPerFrame);
+
+	if (LayoutImport->Reader.IsDone() || LayoutImport->Reader.IsError())
+		CompleteLayoutImport();
+	else if (UWorld* world = GetWorld())
+		LayoutImportTimerHandle = world->GetTimerManager().SetTimerForNextTick(
+			this, &UTransformerComponent::ProcessLayoutImport);
+}
+
+void UTransformerComponent::FlushLayoutImport()
+{
+	if (UWorld* world = GetWorld())
+		world->GetTimerManager().ClearTimer(LayoutImportTimerHandle);
+
+	if (!LayoutImport) return;
+
+	ReadLayoutEntries(LayoutImport->Reader.Num() - LayoutImport->Reader.NumRead());
+	CompleteLayoutImport();
+}
+
+void UTransformerComponent::ReadLayoutEntries(int32 Count)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ReadLayoutEntries);
+
+#if WITH_EDITOR
+	UWorld* world = GetWorld();
+	const bool bPlayInEditor = world && world->IsPlayInEditor();
+#endif
+
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	TArray<FTransform> transforms;
+	FLayoutEntry layoutEntry;
+	for (int32 i = 0; i < Count && LayoutImport->Reader.ReadEntry(layoutEntry); ++i)
+	{
+#if WITH_EDITOR
+		if (bPlayInEditor)
+			layoutEntry.Path.FixupForPIE();
+#endif
+
+		USceneComponent* component = Cast<USceneComponent>(layoutEntry.Path.ResolveObject());
+
+		//an Actor Spawned at runtime can get the name a different one had when the Layout was Exported
+		AActor* owner = component ? component->GetOwner() : nullptr;
+		if (owner && layoutEntry.ActorClass.IsValid() && FSoftClassPath(owner->GetClass()) != layoutEntry.ActorClass)
+			component = nullptr;
+
+		if (IsValid(component))
+		{
+			if (!CanTransform(component)) continue;
+
+			const FSelectionEntry* entry = SelectedComponents.FindEntry(component);
+			components.Add(component);
+			entries.Add(entry ? *entry : ResolveSelectionEntry(component));
+			transforms.Add(layoutEntry.Transform);
+		}
+		else if (layoutEntry.ActorClass.IsValid())
+		{
+			LayoutImport->SpawnClasses.Add(layoutEntry.ActorClass);
+			LayoutImport->SpawnTransforms.Add(layoutEntry.Transform);
+		}
+	}
+
+	if (components.Num() > 0)
+	{
+		ApplyComponentTransforms(components, entries, transforms);
+		LayoutImport->NumPlaced += components.Num();
+
+		//the Drag in progress (if any) continues from the Imported Transforms
+		DragSnapshot.Reset();
+		UpdateGizmoPlacement();
+	}
+}
+
+void UTransformerComponent::CompleteLayoutImport()
+{
+	const TUniquePtr<FLayoutImport> import = MoveTemp(LayoutImport);
+
+	if (import->Reader.IsError())
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Layout is corrupt! Imported %d of its %d Entries")
+		       , import->Reader.NumRead(), import->Reader.Num());
+
+	//the Server Spawns the Replicated Actors, so a Client only Spawns the ones that are not
+	const bool bAuthority = GetOwnerRole() == ROLE_Authority;
+
+	TArray<UClass*> classes;
+	TArray<FTransform> transforms;
+	for (int32 i = 0; i < import->SpawnClasses.Num(); ++i)
+	{
+		UClass* actorClass = import->SpawnClasses[i].TryLoadClass<AActor>();
+		if (!actorClass || (!bAuthority && actorClass->GetDefaultObject<AActor>()->GetIsReplicated())) continue;
+
+		classes.Add(actorClass);
+		transforms.Add(import->SpawnTransforms[i]);
+	}
+
+	OnLayoutImported.Broadcast(import->NumPlaced, classes.Num());
+
+	if (classes.Num() > 0)
+		BeginSpawnBatch(classes, transforms);
+}
+
+TArray<class USceneComponent*> UTransformerComponent::CloneComponents(const TArray<class USceneComponent*>& Components
+                                                                      , TArray<class USceneComponent*>* outTopmostClones)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_CloneComponents);
+	TArray<class USceneComponent*> outClones;
+
+	UWorld* world = GetWorld();
+	if (!world) return outClones;
+
+	TSet<USceneComponent*> templates;
+	templates.Reserve(Components.Num());
+	bool bTemplatesSelected = true;
+	for (auto& templateComponent : Components)
+	{
+		if (templateComponent && templateComponent->GetOwner())
+		{
+			templates.Add(templateComponent);
+			bTemplatesSelected &= SelectedComponents.Contains(templateComponent);
+		}
+	}
+
+	/* 
+	 * HIERARCHY PHASE: find the nearest Template Ancestor of every Template.
+	 * Memoized for every Component walked, so each level of the hierarchy is only walked once
+	 */
+	TMap<const USceneComponent*, USceneComponent*> nearestTemplateAncestor; //Component - nearest Template above it
+	nearestTemplateAncestor.Reserve(templates.Num());
+	TArray<const USceneComponent*, TInlineAllocator<16>> chain;
+	for (USceneComponent* templateComponent : templates)
+	{
+		//if all the Templates are Selected, a Selection Root can't have any Template above it
+		if (bTemplatesSelected && SelectedComponents.IsRoot(templateComponent))
+		{
+			nearestTemplateAncestor.Add(templateComponent, nullptr);
+			continue;
+		}
+
+		USceneComponent* nearest = nullptr;
+		for (USceneComponent* parent = templateComponent->GetAttachParent(); parent; parent = parent->GetAttachParent())
+		{
+			if (templates.Contains(parent))
+			{
+				nearest = parent;
+				break;
+			}
+			if (USceneComponent** known = nearestTemplateAncestor.Find(parent))
+			{
+				//parent is not a template, so its nearest template ancestor is ours as well
+				nearest = *known;
+				break;
+			}
+			chain.Add(parent);
+		}
+
+		for (const USceneComponent* walked : chain)
+			nearestTemplateAncestor.Add(walked, nearest);
+		nearestTemplateAncestor.Add(templateComponent, nearest);
+		chain.Reset();
+	}
+
+	//Topological (Parent-first) order, so that a Template is always cloned after its nearest Template Ancestor
+	TArray<USceneComponent*> orderedTemplates;
+	orderedTemplates.Reserve(templates.Num());
+	TSet<const USceneComponent*> ordered;
+	ordered.Reserve(templates.Num());
+	TArray<USceneComponent*, TInlineAllocator<16>> pending;
+	for (USceneComponent* templateComponent : templates)
+	{
+		for (USceneComponent* current = templateComponent; current && !ordered.Contains(current);
+		     current = nearestTemplateAncestor.FindRef(current))
+			pending.Add(current);
+
+		for (int32 i = pending.Num() - 1; i >= 0; --i)
+		{
+			ordered.Add(pending[i]);
+			orderedTemplates.Add(pending[i]);
+		}
+		pending.Reset();
+	}
+
+	/*
+	 * CLONE PHASE: the Clones are attached before being registered (so they only register once).
+	 * A Clone goes to the Clone of its nearest Template Ancestor. If it has none, it's a Topmost Clone 
+	 * and goes to the original parent (or the Owner Root if it's the Root itself)
+	 */
+	TMap<const USceneComponent*, USceneComponent*> clones; //Template - Clone
+	clones.Reserve(orderedTemplates.Num());
+	outClones.Reserve(orderedTemplates.Num());
+	for (USceneComponent* templateComponent : orderedTemplates)
+	{
+		AActor* owner = templateComponent->GetOwner();
+
+		USceneComponent* clone = Cast<USceneComponent>(StaticDuplicateObject(templateComponent, owner));
+		if (!clone) continue;
+
+		USceneComponent* ancestor = nearestTemplateAncestor.FindRef(templateComponent);
+		USceneComponent** ancestorClone = ancestor ? clones.Find(ancestor) : nullptr;
+
+		USceneComponent* parent; // the clone's parent
+		USceneComponent* templateParent; // the component in the template hierarchy in the parent's place
+		if (ancestorClone)
+		{
+			parent = *ancestorClone;
+			templateParent = ancestor;
+		}
+		else
+		{
+			parent = templateComponent->GetAttachParent();
+			if (!parent) parent = owner->GetRootComponent();
+			templateParent = parent;
+		}
+
+		//sockets only apply if the parent is the direct attach parent
+		const FName socketName = (templateComponent->GetAttachParent() == templateParent)
+			                         ? templateComponent->GetAttachSocketName()
+			                         : NAME_None;
+
+		//Keep the World Transform of the Template
+		const FTransform relativeTransform = templateComponent->GetComponentTransform()
+			.GetRelativeTransform(templateParent->GetSocketTransform(socketName));
+
+		clone->SetupAttachment(parent, socketName);
+		clone->SetRelativeTransform(relativeTransform);
+		clone->OnComponentCreated();
+		clone->RegisterComponent();
+
+		clones.Add(templateComponent, clone);
+		outClones.Add(clone);
+
+		if (outTopmostClones && !ancestorClone)
+			outTopmostClones->Add(clone);
+	}
+
+	return outClones;
+}
+
+bool UTransformerComponent::Undo()
+{
+	if (GetOwnerRole() < ROLE_Authority)
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Undo in a Non-Authority! Please use ServerUndo instead"));
+		return false;
+	}
+
+	//the Drag in progress would be left working off Transforms that are no longer there
+	if (CurrentDomain != ETransformationDomain::TD_None)
+		return false;
+
+	FTransformHistoryStep step;
+	if (!History.Undo(step))
+		return false;
+
+	MulticastHistoryStep(step);
+	return true;
+}
+
+bool UTransformerComponent::Redo()
+{
+	if (GetOwnerRole() < ROLE_Authority)
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Redo in a Non-Authority! Please use ServerRedo instead"));
+		return false;
+	}
+
+	//@see Undo
+	if (CurrentDomain != ETransformationDomain::TD_None)
+		return false;
+
+	FTransformHistoryStep step;
+	if (!History.Redo(step))
+		return false;
+
+	MulticastHistoryStep(step);
+	return true;
+}
+
+void UTransformerComponent::MulticastHistoryStep(const FTransformHistoryStep& Step)
+{
+	if (Step.IsEmpty()) return;
+
+	const int32 maxObjects = FMath::Max(1, MaxHistoryStepObjects);
+	const int32 numTransforms = FMath::Min(Step.Components.Num(), Step.Transforms.Num());
+	if (Step.DeletedActors.Num() + Step.RestoredActors.Num() + numTransforms <= maxObjects)
+	{
+		MulticastApplyHistoryStep(Step);
+		return;
+	}
+
+	//the Deletes go first and the Restores before the Transforms, as when applied in one Step
+	FTransformHistoryStep chunk;
+	auto sendChunk = [this, &chunk]()
+	{
+		MulticastApplyHistoryStep(chunk);
+		chunk = FTransformHistoryStep();
+	};
+
+	for (int32 i = 0; i < Step.DeletedActors.Num(); i += maxObjects)
+	{
+		const int32 count = FMath::Min(maxObjects, Step.DeletedActors.Num() - i);
+		chunk.DeletedActors.Append(Step.DeletedActors.GetData() + i, count);
+		sendChunk();
+	}
+
+	for (int32 i = 0; i < Step.RestoredActors.Num(); i += maxObjects)
+	{
+		const int32 count = FMath::Min(maxObjects, Step.RestoredActors.Num() - i);
+		chunk.RestoredActors.Append(Step.RestoredActors.GetData() + i, count);
+		sendChunk();
+	}
+
+	for (int32 i = 0; i < numTransforms; i += maxObjects)
+	{
+		const int32 count = FMath::Min(maxObjects, numTransforms - i);
+		chunk.Components.Append(Step.Components.GetData() + i, count);
+		chunk.Transforms.Append(Step.Transforms.GetData() + i, count);
+		sendChunk();
+	}
+}
+
+void UTransformerComponent::ClearHistory()
+{
+	TArray<AActor*> releasedActors;
+	History.Reset(releasedActors);
+	DestroyReleasedActors(releasedActors);
+}
+
+bool UTransformerComponent::IsRecordingHistory() const
+{
+	return bRecordHistory && GetOwnerRole() == ROLE_Authority;
+}
+
+void UTransformerComponent::BeginHistoryTransform()
+{
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	GetTransformableComponents(components, entries);
+	HistoryTransformStart.Capture(components, entries, FVector::ZeroVector);
+}
+
+void UTransformerComponent::EndHistoryTransform()
+{
+	if (!HistoryTransformStart.IsValid()) return;
+
+	const TArray<USceneComponent*>& components = HistoryTransformStart.GetComponents();
+	TArray<FTransform> before, after;
+	before.Reserve(components.Num());
+	after.Reserve(components.Num());
+	for (int32 i = 0; i < components.Num(); ++i)
+	{
+		before.Add(HistoryTransformStart.GetTransform(i));
+		after.Add(IsValid(components[i]) ? components[i]->GetComponentTransform() : before.Last());
+	}
+
+	TArray<AActor*> releasedActors;
+	History.RecordTransforms(components, before, after, releasedActors);
+	DestroyReleasedActors(releasedActors);
+	HistoryTransformStart.Reset();
+}
+
+void UTransformerComponent::DestroyReleasedActors(const TArray<AActor*>& ReleasedActors)
+{
+	for (AActor* actor : ReleasedActors)
+	{
+		if (IsValid(actor))
+			actor->Destroy();
+	}
+}
+
+void UTransformerComponent::SetActorSoftDeleted(AActor* Actor, bool bSoftDeleted)
+{
+	if (!IsValid(Actor)) return;
+	Actor->SetActorHiddenInGame(bSoftDeleted);
+	Actor->SetActorEnableCollision(!bSoftDeleted);
+}
+
+void UTransformerComponent::ApplyHistoryStep(const FTransformHistoryStep& Step)
+{
+	FScopedSelectionTransaction SelectionTransaction(this);
+
+	for (AActor* actor : Step.DeletedActors)
+	{
+		if (!IsValid(actor)) continue;
+
+		//a Soft-Deleted Actor can't stay Selected
+		TArray<USceneComponent*> actorComponents;
+		actor->GetComponents(actorComponents);
+		for (USceneComponent* component : actorComponents)
+		{
+			if (SelectedComponents.Contains(component))
+				DeselectComponent_Internal(SelectedComponents, component);
+		}
+		SetActorSoftDeleted(actor, true);
+	}
+
+	for (AActor* actor : Step.RestoredActors)
+		SetActorSoftDeleted(actor, false);
+
+	//all the Transforms of the Step in one batch
+	const int32 num = FMath::Min(Step.Components.Num(), Step.Transforms.Num());
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	TArray<FTransform> transforms;
+	components.Reserve(num);
+	entries.Reserve(num);
+	transforms.Reserve(num);
+	for (int32 i = 0; i < num; ++i)
+	{
+		USceneComponent* component = Step.Components[i];
+		if (!IsValid(component)) continue;
+
+		const FSelectionEntry* entry = SelectedComponents.FindEntry(component);
+		components.Add(component);
+		entries.Add(entry ? *entry : ResolveSelectionEntry(component));
+		transforms.Add(Step.Transforms[i]);
+	}
+
+	if (components.Num() > 0)
+		ApplyComponentTransforms(components, entries, transforms);
+
+	DragSnapshot.Reset();
+	UpdateGizmoPlacement();
+}
+
+void UTransformerComponent::SelectComponent(class USceneComponent* Component
+                                            , bool bAppendToList)
+{
+	if (!Component) return;
+
+	if (ShouldSelect(Component->GetOwner(), Component))
+	{
+		FScopedSelectionTransaction SelectionTransaction(this);
+		if (false == bAppendToList)
+			DeselectAll();
+		AddComponent_Internal(SelectedComponents, Component);
+		UpdateGizmoPlacement();
+	}
+}
+
+void UTransformerComponent::SelectActor(AActor* Actor
+                                        , bool bAppendToList)
+{
+	if (!Actor) return;
+
+	if (ShouldSelect(Actor, Actor->GetRootComponent()))
+	{
+		FScopedSelectionTransaction SelectionTransaction(this);
+		if (false == bAppendToList)
+			DeselectAll();
+		AddComponent_Internal(SelectedComponents, Actor->GetRootComponent());
+		UpdateGizmoPlacement();
+	}
+}
+
+void UTransformerComponent::SelectMultipleComponents(const TArray<USceneComponent*>& Components
+                                                     , bool bAppendToList)
+{
+	FScopedSelectionTransaction SelectionTransaction(this);
+	bool bValidList = false;
+
+	for (auto& c : Components)
+	{
+		if (!c) continue;
+		if (!ShouldSelect(c->GetOwner(), c)) continue;
+
+		if (false == bAppendToList)
+		{
+			DeselectAll();
+			bAppendToList = true;
+			//only run once. This is not place outside in case a list is empty or contains only invalid components
+		}
+		bValidList = true;
+		AddComponent_Internal(SelectedComponents, c);
+	}
+
+	if (bValidList) UpdateGizmoPlacement();
+}
+
+void UTransformerComponent::SelectMultipleActors(const TArray<AActor*>& Actors
+                                                 , bool bAppendToList)
+{
+	FScopedSelectionTransaction SelectionTransaction(this);
+	bool bValidList = false;
+	for (auto& a : Actors)
+	{
+		if (!a) continue;
+		if (!ShouldSelect(a, a->GetRootComponent())) continue;
+
+		if (false == bAppendToList)
+		{
 			DeselectAll();
 			bAppendToList = true;
 			//only run once. This is not place outside in case a list is empty or contains only invalid components
@@ -811,15 +2596,21 @@ void UTransformerComponent::DeselectActor(AActor* Actor)
 
 TArray<USceneComponent*> UTransformerComponent::DeselectAll(bool bDestroyDeselected)
 {
-	TArray<USceneComponent*> componentsToDeselect = SelectedComponents;
+	FScopedSelectionTransaction SelectionTransaction(this);
+
+	TArray<USceneComponent*> componentsToDeselect = SelectedComponents.ToArray();
 	for (auto& i : componentsToDeselect)
-		DeselectComponent(i);
-	//calling internal so as not to modify SelectedComponents until the last bit!
+		DeselectComponent_Internal(SelectedComponents, i);
 	SelectedComponents.Empty();
+	if (GetOwnerRole() == ROLE_Authority)
+		ReplicatedSelection.Reset(); //drops the entries of Components the GC already collected
+	DragSnapshot.Reset();
+	DeselectAllInstances(bDestroyDeselected);
 	UpdateGizmoPlacement();
 
 	if (bDestroyDeselected)
 	{
+		TArray<AActor*> softDeletedActors;
 		for (auto& c : componentsToDeselect)
 		{
 			if (!IsValid(c)) continue; //a component that was in the same actor destroyed will be pending kill
@@ -828,103 +2619,437 @@ TArray<USceneComponent*> UTransformerComponent::DeselectAll(bool bDestroyDeselec
 				//We destroy the actor if no components are left to destroy, or the system is currently ActorBased
 				if (bComponentBased && actor->GetComponents().Num() > 1)
 					c->DestroyComponent(true);
+				//Soft-Deleted on every machine (this runs through the Multicast), but only recorded in the Server
+				else if (bRecordHistory)
+				{
+					SetActorSoftDeleted(actor, true);
+					softDeletedActors.AddUnique(actor);
+				}
 				else
 					actor->Destroy();
 			}
 		}
+
+		if (IsRecordingHistory())
+		{
+			TArray<AActor*> releasedActors;
+			History.RecordActors(ETransformHistoryOperation::Delete, softDeletedActors, releasedActors);
+			DestroyReleasedActors(releasedActors);
+		}
 	}
 
 	return componentsToDeselect;
 }
 
-void UTransformerComponent::AddComponent_Internal(TArray<USceneComponent*>& OutComponentList
-                                                  , USceneComponent* Component)
+void UTransformerComponent::SelectInstance(UInstancedStaticMeshComponent* Component, int32 InstanceIndex
+                                           , bool bAppendToList)
 {
-	//if (!Component) return; //assumes that previous have checked, since this is Internal.
+	if (!Component || !Component->IsValidInstance(InstanceIndex)) return;
 
-	int32 Index = OutComponentList.Find(Component);
-
-	if (INDEX_NONE == Index) //Component is not in list
+	if (ShouldSelect(Component->GetOwner(), Component))
 	{
-		OutComponentList.Emplace(Component);
-		bool bImplementsInterface;
-		Select(OutComponentList.Last(), &bImplementsInterface);
-		OnComponentSelectionChange(Component, true, bImplementsInterface);
+		FScopedSelectionTransaction SelectionTransaction(this);
+		if (false == bAppendToList)
+			DeselectAll();
+
+		FInstanceSet& instanceSet = SelectedInstances.FindOrAdd(Component);
+		const bool bFirstInstance = instanceSet.IsEmpty();
+		if (instanceSet.Add(InstanceIndex))
+		{
+			LastInstanceComponent = Component;
+			DragSnapshot.Reset();
+			if (bFirstInstance)
+				OnInstanceComponentSelectionChange(Component, true);
+		}
+		else if (bToggleSelectedInMultiSelection)
+			DeselectInstance(Component, InstanceIndex);
+		UpdateGizmoPlacement();
 	}
-	else if (bToggleSelectedInMultiSelection)
-		DeselectComponentAtIndex_Internal(OutComponentList, Index);
 }
 
-void UTransformerComponent::DeselectComponent_Internal(TArray<USceneComponent*>& OutComponentList
-                                                       , USceneComponent* Component)
+void UTransformerComponent::DeselectInstance(UInstancedStaticMeshComponent* Component, int32 InstanceIndex)
 {
-	//if (!Component) return; //assumes that previous have checked, since this is Internal.
+	FInstanceSet* instanceSet = SelectedInstances.Find(Component);
+	if (!instanceSet || !instanceSet->Remove(InstanceIndex)) return;
 
-	int32 Index = OutComponentList.Find(Component);
-	if (INDEX_NONE != Index)
-		DeselectComponentAtIndex_Internal(OutComponentList, Index);
+	DragSnapshot.Reset();
+	if (instanceSet->IsEmpty())
+	{
+		SelectedInstances.Remove(Component);
+		OnInstanceComponentSelectionChange(Component, false);
+	}
+	UpdateGizmoPlacement();
 }
 
-void UTransformerComponent::DeselectComponentAtIndex_Internal(
-	TArray<USceneComponent*>& OutComponentList
-	, int32 Index)
+TArray<int32> UTransformerComponent::GetSelectedInstances(UInstancedStaticMeshComponent* Component) const
 {
-	//if (!Component) return; //assumes that previous have checked, since this is Internal.
-	if (OutComponentList.IsValidIndex(Index))
+	TArray<int32> instances;
+	if (const FInstanceSet* instanceSet = SelectedInstances.Find(Component))
+		instanceSet->GetInstances(instances);
+	return instances;
+}
+
+void UTransformerComponent::DeselectAllInstances(bool bRemoveInstances)
+{
+	if (SelectedInstances.Num() == 0) return;
+
+	//taken out first, as removing the Instances reports their new Indices (@see OnInstanceIndexUpdated)
+	TMap<TWeakObjectPtr<UInstancedStaticMeshComponent>, FInstanceSet> deselectedInstances = MoveTemp(SelectedInstances);
+	SelectedInstances.Reset();
+	LastInstanceComponent.Reset();
+	DragSnapshot.Reset();
+
+	TArray<int32> instances;
+	for (auto& pair : deselectedInstances)
 	{
-		USceneComponent* Component = OutComponentList[Index];
-		bool bImplementsInterface;
-		Deselect(Component, &bImplementsInterface);
-		OutComponentList.RemoveAt(Index);
-		OnComponentSelectionChange(Component, false, bImplementsInterface);
+		UInstancedStaticMeshComponent* ism = pair.Key.Get();
+		if (!ism) continue;
+
+		OnInstanceComponentSelectionChange(ism, false);
+		if (bRemoveInstances)
+		{
+			pair.Value.GetInstances(instances);
+			ism->RemoveInstances(instances);
+		}
 	}
 }
 
-void UTransformerComponent::SetGizmo()
+void UTransformerComponent::OnPostGarbageCollect()
+{
+	SelectedComponents.PruneCollected();
+}
+
+void UTransformerComponent::OnInstanceIndexUpdated(UInstancedStaticMeshComponent* Component
+                                                   , TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates)
 {
-	//If there are selected components, then we see whether we need to create a new gizmo.
-	if (SelectedComponents.Num() > 0)
+	FInstanceSet* instanceSet = SelectedInstances.Find(Component);
+	if (!instanceSet) return;
+
+	//applied in order, as each Update is relative to the Indices left by the previous ones
+	using EUpdateType = FInstancedStaticMeshDelegates::EInstanceIndexUpdateType;
+	bool bChanged = false;
+	for (const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData& update : IndexUpdates)
 	{
-		bool bCreateGizmo = true;
-		if (Gizmo)
+		switch (update.Type)
 		{
-			if (CurrentTransformation == Gizmo->GetGizmoType())
+		case EUpdateType::Removed:
+			bChanged |= instanceSet->Remove(update.Index);
+			break;
+		case EUpdateType::Relocated:
+			if (instanceSet->Contains(update.OldIndex))
 			{
-				bCreateGizmo = false; // do not create gizmo if there is already a matching gizmo
-			}
-			else
-			{
-				// Destroy the current gizmo as the transformation types do not match
-				Gizmo->Destroy();
+				instanceSet->Relocate(update.OldIndex, update.Index);
+				bChanged = true;
 			}
+			break;
+		case EUpdateType::Cleared:
+		case EUpdateType::Destroyed:
+			bChanged |= !instanceSet->IsEmpty();
+			instanceSet->Empty();
+			break;
+		default:
+			break;
 		}
+	}
+
+	if (!bChanged) return;
+
+	DragSnapshot.Reset();
+	if (instanceSet->IsEmpty())
+	{
+		SelectedInstances.Remove(Component);
+		OnInstanceComponentSelectionChange(Component, false);
+	}
+	UpdateGizmoPlacement();
+}
+
+void UTransformerComponent::OnInstanceComponentSelectionChange(UInstancedStaticMeshComponent* Component
+                                                               , bool bSelected)
+{
+	const FSelectionEntry* selectedEntry = SelectedComponents.FindEntry(Component);
+	const FSelectionEntry entry = selectedEntry ? *selectedEntry : ResolveSelectionEntry(Component);
+	if (bSelected)
+		Select(Component, entry);
+	else
+		Deselect(Component, entry);
+	OnComponentSelectionChange(Component, bSelected, entry.FocusableObject.IsValid());
+}
 
-		if (bCreateGizmo)
+bool UTransformerComponent::GetGizmoInstance(UInstancedStaticMeshComponent*& outComponent
+                                             , int32& outInstance) const
+{
+	outComponent = LastInstanceComponent.Get();
+	const FInstanceSet* instanceSet = outComponent ? SelectedInstances.Find(outComponent) : nullptr;
+
+	//the Last Component has no Instances left, so fall back to any other
+	if (!instanceSet)
+	{
+		for (auto& pair : SelectedInstances)
 		{
-			if (UWorld* world = GetWorld())
+			if (pair.Key.IsValid() && !pair.Value.IsEmpty())
 			{
-				UClass* GizmoClass = GetGizmoClass(CurrentTransformation);
-				if (GizmoClass)
-				{
-					Gizmo = Cast<ABaseGizmo>(world->SpawnActor(GizmoClass));
-					Gizmo->OnGizmoStateChange.AddDynamic(this, &UTransformerComponent::OnGizmoStateChanged);
-				}
+				outComponent = pair.Key.Get();
+				instanceSet = &pair.Value;
+				break;
 			}
 		}
 	}
-	//Since there are no selected components, we must destroy any gizmos present
-	else
+	if (!instanceSet) return false;
+
+	outInstance = instanceSet->GetLastAdded();
+	if (outInstance == INDEX_NONE)
+		outInstance = instanceSet->First();
+	return outInstance != INDEX_NONE;
+}
+
+void UTransformerComponent::PlaceGizmoOnInstance()
+{
+	UInstancedStaticMeshComponent* ism;
+	int32 instance;
+	FTransform instanceTransform;
+	if (!Gizmo || !GetGizmoInstance(ism, instance) || !ism->GetInstanceTransform(instance, instanceTransform, true))
+		return;
+
+	//a pooled Gizmo might still be attached to a Component it was placed on before
+	if (Gizmo->GetAttachParentActor())
+	{
+		Gizmo->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+		Gizmo->NotifyAttachmentChanged();
+	}
+	bGizmoOnInstance = true;
+
+	Gizmo->SetActorLocation(instanceTransform.GetLocation());
+	bGizmoScaleDirty = true;
+	bGizmoSpaceDirty = true;
+}
+
+void UTransformerComponent::BeginSelectionTransaction()
+{
+	++SelectionTransactionDepth;
+}
+
+void UTransformerComponent::EndSelectionTransaction()
+{
+	if (SelectionTransactionDepth <= 0)
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("EndSelectionTransaction called without a matching BeginSelectionTransaction!"));
+		return;
+	}
+
+	if (--SelectionTransactionDepth > 0) return; //only commit on the outermost transaction
+
+	if (bGizmoPlacementPending)
+	{
+		bGizmoPlacementPending = false;
+		UpdateGizmoPlacement();
+	}
+
+	if (bSelectionSyncPending)
+	{
+		bSelectionSyncPending = false;
+		ReplicateSelection();
+	}
+}
+
+void UTransformerComponent::AddComponent_Internal(FSelectionSet& OutComponentList
+                                                  , USceneComponent* Component, bool bCheckLock)
+{
+	//if (!Component) return; //assumes that previous have checked, since this is Internal.
+
+	if (OutComponentList.Contains(Component))
+	{
+		if (bToggleSelectedInMultiSelection)
+			DeselectComponent_Internal(OutComponentList, Component);
+		return;
+	}
+
+	if (bCheckLock && AcquireLock(Component) != ESelectionRejectReason::SR_None)
+		return;
+
+	//resolved once here, so that nothing has to be looked up again while the Component stays selected
+	const FSelectionEntry entry = ResolveSelectionEntry(Component);
+	OutComponentList.Add(Component, entry);
+	if (GetOwnerRole() == ROLE_Authority)
+		ReplicatedSelection.Add(Component);
+	DragSnapshot.Reset();
+	Select(Component, entry);
+	OnComponentSelectionChange(Component, true, entry.FocusableObject.IsValid());
+}
+
+UObject* UTransformerComponent::GetLockObject(USceneComponent* Component) const
+{
+	if (!Component) return nullptr;
+	if (bComponentBased) return Component;
+	return Component->GetOwner() ? static_cast<UObject*>(Component->GetOwner()) : Component;
+}
+
+ATransformerLockTable* UTransformerComponent::GetLockTable(bool bSpawnIfMissing) const
+{
+	UWorld* world = GetWorld();
+	UTransformerSubsystem* subsystem = world ? world->GetSubsystem<UTransformerSubsystem>() : nullptr;
+	return subsystem ? subsystem->GetLockTable(bSpawnIfMissing) : nullptr;
+}
+
+APlayerState* UTransformerComponent::GetLockHolder(USceneComponent* Component) const
+{
+	const ATransformerLockTable* lockTable = GetLockTable(false);
+	return lockTable ? lockTable->GetLocks().GetHolder(GetLockObject(Component)) : nullptr;
+}
+
+ESelectionRejectReason UTransformerComponent::AcquireLock(USceneComponent* Component)
+{
+	if (!bUseEditLocks) return ESelectionRejectReason::SR_None;
+
+	APlayerController* playerController = GetPlayerController();
+	APlayerState* playerState = playerController ? playerController->PlayerState : nullptr;
+
+	ESelectionRejectReason reason = ESelectionRejectReason::SR_None;
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		if (ATransformerLockTable* lockTable = GetLockTable(true))
+			reason = lockTable->GetLocks().Acquire(GetLockObject(Component), this, playerState, MaxEditLocks);
+	}
+	//the Server has the final say, this only saves the round trip for Objects already locked by someone else
+	else if (const ATransformerLockTable* lockTable = GetLockTable(false))
+	{
+		APlayerState* holder = lockTable->GetLocks().GetHolder(GetLockObject(Component));
+		if (holder && holder != playerState)
+			reason = ESelectionRejectReason::SR_LockedByOther;
+	}
+
+	if (reason != ESelectionRejectReason::SR_None)
+	{
+		if (GetOwnerRole() == ROLE_Authority && playerController && !playerController->IsLocalController())
+			ClientSelectionRejected(Component, reason);
+		else
+			OnSelectionRejected.Broadcast(Component, reason);
+	}
+	return reason;
+}
+
+void UTransformerComponent::ReleaseLock(USceneComponent* Component)
+{
+	if (!bUseEditLocks) return;
+
+	if (ATransformerLockTable* lockTable = GetLockTable(false))
+		lockTable->GetLocks().Release(GetLockObject(Component), this);
+}
+
+void UTransformerComponent::DeselectComponent_Internal(FSelectionSet& OutComponentList
+                                                       , USceneComponent* Component)
+{
+	//if (!Component) return; //assumes that previous have checked, since this is Internal.
+
+	if (const FSelectionEntry* foundEntry = OutComponentList.FindEntry(Component))
+	{
+		//copied, since the Entry goes away with the Component
+		const FSelectionEntry entry = *foundEntry;
+		Deselect(Component, entry);
+		OutComponentList.Remove(Component);
+		if (GetOwnerRole() == ROLE_Authority)
+		{
+			ReplicatedSelection.Remove(Component);
+			ReplicateSelection();
+			ReleaseLock(Component);
+		}
+		DragSnapshot.Reset();
+		OnComponentSelectionChange(Component, false, entry.FocusableObject.IsValid());
+	}
+}
+
+void UTransformerComponent::SetGizmo()
+{
+	ABaseGizmo* newGizmo = nullptr;
+
+	//If there are selected components, then we need the gizmo that matches the current transformation.
+	//Unless Headless, where the Selection is kept without Gizmos
+	if ((!SelectedComponents.IsEmpty() || HasSelectedInstances()) && !IsHeadless())
+	{
+		if (Gizmo && CurrentTransformation == Gizmo->GetGizmoType())
+			newGizmo = Gizmo; // there is already a matching gizmo
+		else
+			newGizmo = GetPooledGizmo(CurrentTransformation);
+	}
+	//Since there are no selected components, no gizmo should be active
+
+	if (newGizmo == Gizmo) return;
+
+	// Deactivate (rather than Destroy) the current gizmo so that it can be reused
+	if (Gizmo)
+		Gizmo->SetGizmoActive(false);
+
+	Gizmo = newGizmo;
+
+	if (Gizmo)
+	{
+		Gizmo->SetGizmoActive(true);
+
+		//the Gizmo is picked analytically, so it doesn't need to be in the Physics Scene
+		if (bAnalyticGizmoPicking)
+			Gizmo->SetActorEnableCollision(false);
+	}
+
+	bGizmoScaleDirty = true;
+	bGizmoSpaceDirty = true;
+	UpdateComponentTickState();
+}
+
+ABaseGizmo* UTransformerComponent::GetPooledGizmo(ETransformationType TransformationType)
+{
+	UClass* GizmoClass = GetGizmoClass(TransformationType);
+	if (!GizmoClass) return nullptr;
+
+	ABaseGizmo*& pooledGizmo = GizmoPool.FindOrAdd(TransformationType);
+	if (IsValid(pooledGizmo))
+	{
+		if (pooledGizmo->GetClass() == GizmoClass)
+			return pooledGizmo;
+
+		// the Gizmo Class was changed, so the pooled gizmo is no longer usable
+		pooledGizmo->Destroy();
+	}
+	pooledGizmo = nullptr;
+
+	if (UWorld* world = GetWorld())
 	{
-		if (Gizmo)
+		pooledGizmo = Cast<ABaseGizmo>(world->SpawnActor(GizmoClass));
+		if (pooledGizmo)
 		{
-			Gizmo->Destroy();
-			Gizmo = nullptr;
+			INC_DWORD_STAT(STAT_RuntimeTransformer_GizmosSpawned);
+			pooledGizmo->OnGizmoStateChange.AddDynamic(this, &UTransformerComponent::OnGizmoStateChanged);
+			pooledGizmo->SetGizmoActive(false);
 		}
 	}
+	return pooledGizmo;
+}
+
+void UTransformerComponent::UpdateSelectionStats()
+{
+#if STATS
+	const int32 selectedCount = SelectedComponents.Num();
+	if (selectedCount > StatSelectedCount)
+		INC_DWORD_STAT_BY(STAT_RuntimeTransformer_SelectedComponents, selectedCount - StatSelectedCount);
+	else if (selectedCount < StatSelectedCount)
+		DEC_DWORD_STAT_BY(STAT_RuntimeTransformer_SelectedComponents, StatSelectedCount - selectedCount);
+	StatSelectedCount = selectedCount;
+#endif
 }
 
 void UTransformerComponent::UpdateGizmoPlacement()
 {
+	//defer until the Selection Transaction ends, so that the gizmo is placed only once
+	if (SelectionTransactionDepth > 0)
+	{
+		bGizmoPlacementPending = true;
+		return;
+	}
+
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_UpdateGizmoPlacement);
+
+	//the Selection only changes through here (once per Transaction), so keep the Selected count in sync
+	UpdateSelectionStats();
+	bObservedStateDirty = true;
+
 	SetGizmo();
 	//means that there are no active gizmos (no selections) so nothing to do in this func
 	if (!Gizmo) return;
@@ -934,7 +3059,7 @@ void UTransformerComponent::UpdateGizmoPlacement()
 	switch (GizmoPlacement)
 	{
 	case EGizmoPlacement::GP_OnFirstSelection:
-		ComponentToAttachTo = SelectedComponents[0];
+		ComponentToAttachTo = SelectedComponents.First();
 		break;
 	case EGizmoPlacement::GP_OnLastSelection:
 		ComponentToAttachTo = SelectedComponents.Last();
@@ -946,16 +3071,23 @@ void UTransformerComponent::UpdateGizmoPlacement()
 	{
 		Gizmo->AttachToComponent(ComponentToAttachTo
 		                         , FAttachmentTransformRules::SnapToTargetIncludingScale);
+		Gizmo->NotifyAttachmentChanged();
+		bGizmoOnInstance = false;
+	}
+	else if (HasSelectedInstances())
+	{
+		//Instances are not Components, so the Gizmo is placed on them (and moved along) rather than attached
+		PlaceGizmoOnInstance();
 	}
 	else
 	{
 		//	Gizmo->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 	}
 
-	Gizmo->UpdateGizmoSpace(CurrentSpaceType);
+	bGizmoScaleDirty = true;
+	ApplyGizmoSpace();
 }
 
-
 ///////////////////////// NETWORKING ////////////////////////////////////////////////////////////////////////
 
 
@@ -1075,7 +3207,6 @@ void UTransformerComponent::ReplicateServerTraceResults(bool bTraceSuccessful, b
 		if (!bTraceSuccessful && !bAppendToList)
 			DeselectAll(false);
 		MulticastSetDomain(CurrentDomain);
-		MulticastSetSelectedComponents(SelectedComponents);
 	}
 }
 
@@ -1084,9 +3215,9 @@ void UTransformerComponent::LogSelectedComponents()
 	UE_LOG(LogRuntimeTransformer, Log, TEXT("******************** SELECTED COMPONENTS LOG START ********************"));
 	UE_LOG(LogRuntimeTransformer, Log, TEXT("   * Selected Component Count: %d"), SelectedComponents.Num());
 	UE_LOG(LogRuntimeTransformer, Log, TEXT("   * -------------------------------- "));
-	for (int32 i = 0; i < SelectedComponents.Num(); ++i)
+	int32 i = 0;
+	for (USceneComponent* cmp : SelectedComponents)
 	{
-		USceneComponent* cmp = SelectedComponents[i];
 		FString message = "Component: ";
 		if (cmp)
 		{
@@ -1099,120 +3230,750 @@ void UTransformerComponent::LogSelectedComponents()
 		else
 			message += TEXT("[INVALID]");
 
-		UE_LOG(LogRuntimeTransformer, Log, TEXT("   * [%d] %s"), i, *message);
+		UE_LOG(LogRuntimeTransformer, Log, TEXT("   * [%d] %s"), i++, *message);
 	}
 
 	UE_LOG(LogRuntimeTransformer, Log, TEXT("******************** SELECTED COMPONENTS LOG END   ********************"));
 }
 
-bool UTransformerComponent::ServerTraceByObjectTypes_Validate(
-	const FVector& StartLocation, const FVector& EndLocation
-	, const TArray<TEnumAsByte<ECollisionChannel>>& CollisionChannels
-	, bool bAppendToList)
+bool UTransformerComponent::ServerTraceByObjectTypes_Validate(
+	const FVector& StartLocation, const FVector& EndLocation
+	, const TArray<TEnumAsByte<ECollisionChannel>>& CollisionChannels
+	, bool bAppendToList)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerTraceByObjectTypes_Implementation(
+	const FVector& StartLocation, const FVector& EndLocation
+	, const TArray<TEnumAsByte<ECollisionChannel>>& CollisionChannels
+	, bool bAppendToList)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, 2 * sizeof(FVector) + CollisionChannels.Num() + sizeof(bool));
+	FlushServerStateBatches(true);
+
+	FServerTraceRequest request;
+	request.QueryType = FServerTraceRequest::EQueryType::ObjectTypes;
+	request.StartLocation = StartLocation;
+	request.EndLocation = EndLocation;
+	for (auto& cc : CollisionChannels)
+		request.ObjectQueryParams.AddObjectTypesToQuery(cc);
+	request.CollisionChannels = CollisionChannels;
+	request.bAppendToList = bAppendToList;
+	if (QueueServerTrace(request)) return;
+
+	RunServerTrace(request);
+}
+
+
+bool UTransformerComponent::ServerTraceByChannel_Validate(
+	const FVector& StartLocation, const FVector& EndLocation
+	, ECollisionChannel TraceChannel, bool bAppendToList)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerTraceByChannel_Implementation(
+	const FVector& StartLocation, const FVector& EndLocation
+	, ECollisionChannel TraceChannel, bool bAppendToList)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, 2 * sizeof(FVector) + sizeof(uint8) + sizeof(bool));
+	FlushServerStateBatches(true);
+
+	FServerTraceRequest request;
+	request.QueryType = FServerTraceRequest::EQueryType::Channel;
+	request.StartLocation = StartLocation;
+	request.EndLocation = EndLocation;
+	request.TraceChannel = TraceChannel;
+	request.bAppendToList = bAppendToList;
+	if (QueueServerTrace(request)) return;
+
+	RunServerTrace(request);
+}
+
+
+bool UTransformerComponent::ServerTraceByProfile_Validate(const FVector& StartLocation
+                                                          , const FVector& EndLocation, const FName& ProfileName,
+                                                          bool bAppendToList)
+{
+	return true;
+}
+
+
+void UTransformerComponent::ServerTraceByProfile_Implementation(
+	const FVector& StartLocation, const FVector& EndLocation
+	, const FName& ProfileName, bool bAppendToList)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, 2 * sizeof(FVector) + sizeof(FName) + sizeof(bool));
+	FlushServerStateBatches(true);
+
+	FServerTraceRequest request;
+	request.QueryType = FServerTraceRequest::EQueryType::Profile;
+	request.StartLocation = StartLocation;
+	request.EndLocation = EndLocation;
+	request.ProfileName = ProfileName;
+	request.bAppendToList = bAppendToList;
+	if (QueueServerTrace(request)) return;
+
+	RunServerTrace(request);
+}
+
+void UTransformerComponent::FinishServerTrace(bool bTraceSuccessful, bool bAppendToList)
+{
+	if (!bTraceSuccessful && !bAppendToList)
+		//check whether trace was successful and we're not doing multi selection
+		DeselectAll(false);
+
+	MulticastSetDomain(CurrentDomain);
+}
+
+bool UTransformerComponent::QueueServerTrace(const FServerTraceRequest& Request)
+{
+	if (!bAsyncServerTraces) return false;
+
+	UWorld* world = GetWorld();
+	UTransformerSubsystem* subsystem = world ? world->GetSubsystem<UTransformerSubsystem>() : nullptr;
+	if (!subsystem) return false;
+
+	//a click that replaces the Selection makes an older one still waiting (that also did) pointless.
+	//Appending clicks each add to the Selection, so none of them can be dropped
+	if (!Request.bAppendToList && PendingServerTraces.Num() > 0 && !PendingServerTraces.Last().bAppendToList)
+		PendingServerTraces.Last() = Request;
+	else
+		PendingServerTraces.Add(Request);
+	subsystem->QueueServerTrace(this);
+	return true;
+}
+
+void UTransformerComponent::SubmitPendingServerTrace()
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Trace);
+	if (PendingServerTraces.Num() == 0) return;
+
+	const FServerTraceRequest request = PendingServerTraces[0];
+	PendingServerTraces.RemoveAt(0, 1, false);
+
+	UWorld* world = GetWorld();
+	if (!world) return;
+
+	//the rest wait for another turn
+	if (PendingServerTraces.Num() > 0)
+		if (UTransformerSubsystem* subsystem = world->GetSubsystem<UTransformerSubsystem>())
+			subsystem->QueueServerTrace(this);
+
+	const TArray<AActor*> ignoredActors = GetIgnoredActorsForServerTrace();
+
+	if (bAnalyticGizmoPicking || IsHeadless())
+	{
+		//no need to wait for the Trace if the Gizmo is picked
+		if (PickGizmoDomain(request.StartLocation, request.EndLocation, ignoredActors))
+		{
+			FScopedSelectionTransaction SelectionTransaction(this);
+			FinishServerTrace(true, request.bAppendToList);
+			return;
+		}
+	}
+
+	FCollisionQueryParams collisionQueryParams;
+	collisionQueryParams.AddIgnoredActors(ignoredActors);
+
+	//like the Synchronous Traces, only the closest Hit is needed when the Gizmo is picked analytically
+	const EAsyncTraceType traceType = bAnalyticGizmoPicking ? EAsyncTraceType::Single : EAsyncTraceType::Multi;
+
+	SubmittedServerTraces.Add(request);
+	FTraceDelegate traceDelegate = FTraceDelegate::CreateUObject(this
+	                                                             , &UTransformerComponent::OnServerTraceCompleted
+	                                                             , request.bAppendToList, ServerTraceGeneration);
+	switch (request.QueryType)
+	{
+	case FServerTraceRequest::EQueryType::ObjectTypes:
+		world->AsyncLineTraceByObjectType(traceType, request.StartLocation, request.EndLocation
+		                                  , request.ObjectQueryParams, collisionQueryParams, &traceDelegate);
+		break;
+	case FServerTraceRequest::EQueryType::Channel:
+		world->AsyncLineTraceByChannel(traceType, request.StartLocation, request.EndLocation
+		                               , request.TraceChannel, collisionQueryParams
+		                               , FCollisionResponseParams::DefaultResponseParam, &traceDelegate);
+		break;
+	case FServerTraceRequest::EQueryType::Profile:
+		world->AsyncLineTraceByProfile(traceType, request.StartLocation, request.EndLocation
+		                               , request.ProfileName, collisionQueryParams, &traceDelegate);
+		break;
+	}
+}
+
+void UTransformerComponent::OnServerTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum
+                                                   , bool bAppendToList, uint32 Generation)
+{
+	//already done right away, when the Traces were Resolved
+	if (Generation != ServerTraceGeneration) return;
+
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_Trace);
+	if (SubmittedServerTraces.Num() > 0)
+		SubmittedServerTraces.RemoveAt(0, 1, false);
+
+	FScopedSelectionTransaction SelectionTransaction(this);
+
+	bool bTraceSuccessful = false;
+	if (TraceDatum.OutHits.Num() > 0)
+	{
+		TArray<FHitResult> hits = MoveTemp(TraceDatum.OutHits);
+		INC_DWORD_STAT_BY(STAT_RuntimeTransformer_TraceHits, hits.Num());
+		FilterHits(hits);
+		bTraceSuccessful = HandleTracedObjects(hits, bAppendToList);
+	}
+
+	FinishServerTrace(bTraceSuccessful, bAppendToList);
+}
+
+void UTransformerComponent::RunServerTrace(const FServerTraceRequest& Request)
+{
+	FScopedSelectionTransaction SelectionTransaction(this);
+
+	const TArray<AActor*> ignoredActors = GetIgnoredActorsForServerTrace();
+	bool bTraceSuccessful = false;
+	switch (Request.QueryType)
+	{
+	case FServerTraceRequest::EQueryType::ObjectTypes:
+		bTraceSuccessful = TraceByObjectTypes(Request.StartLocation, Request.EndLocation, Request.CollisionChannels
+		                                      , ignoredActors, Request.bAppendToList);
+		break;
+	case FServerTraceRequest::EQueryType::Channel:
+		bTraceSuccessful = TraceByChannel(Request.StartLocation, Request.EndLocation, Request.TraceChannel
+		                                  , ignoredActors, Request.bAppendToList);
+		break;
+	case FServerTraceRequest::EQueryType::Profile:
+		bTraceSuccessful = TraceByProfile(Request.StartLocation, Request.EndLocation, Request.ProfileName
+		                                  , ignoredActors, Request.bAppendToList);
+		break;
+	}
+
+	FinishServerTrace(bTraceSuccessful, Request.bAppendToList);
+}
+
+void UTransformerComponent::ResolveServerTraces()
+{
+	if (SubmittedServerTraces.Num() == 0 && PendingServerTraces.Num() == 0) return;
+
+	TArray<FServerTraceRequest> requests = MoveTemp(SubmittedServerTraces);
+	requests.Append(MoveTemp(PendingServerTraces));
+	SubmittedServerTraces.Reset();
+	PendingServerTraces.Reset();
+
+	//the Async Traces still in flight are done below instead
+	++ServerTraceGeneration;
+
+	FScopedSelectionTransaction SelectionTransaction(this);
+	for (const FServerTraceRequest& request : requests)
+		RunServerTrace(request);
+}
+
+bool UTransformerComponent::ServerClearDomain_Validate()
+{
+	return true;
+}
+
+void UTransformerComponent::ServerClearDomain_Implementation()
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, 0);
+	ResolveServerTraces();
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_Domain, bCoalesced))
+		batch->SetDomain(ETransformationDomain::TD_None);
+	else if (!bCoalesced)
+		MulticastClearDomain();
+}
+
+void UTransformerComponent::MulticastClearDomain_Implementation()
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, 0);
+	ClearDomain();
+}
+
+bool UTransformerComponent::ServerApplyTransform_Validate(const FTransform& DeltaTransform)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerApplyTransform_Implementation(const FTransform& DeltaTransform)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, sizeof(FTransform));
+	ResolveServerTraces();
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_DeltaTransform, bCoalesced))
+		batch->AddDeltaTransform(DeltaTransform);
+	else if (!bCoalesced)
+		MulticastApplyTransform(DeltaTransform);
+}
+
+void UTransformerComponent::MulticastApplyTransform_Implementation(const FTransform& DeltaTransform)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MulticastApplyTransform);
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, sizeof(FTransform));
+	if (GetPlayerController() && !GetPlayerController()->IsLocalController()) //only apply to others
+		ApplyDeltaTransform(DeltaTransform);
+}
+
+
+void UTransformerComponent::ReplicateFinishTransform()
+{
+	//the Transform goes first, so the Server has it applied by the time the Domain is cleared (and the History records it)
+	if (bStreamTransforms || bPredictTransforms)
+		CommitDrag();
+	else
+		ServerApplyTransform(NetworkDeltaTransform);
+	ResetDeltaTransform(NetworkDeltaTransform);
+	ServerClearDomain();
+}
+
+void UTransformerComponent::CommitDrag()
+{
+	//the Server's (e.g. a Listen Server's own) Drags are authoritative already
+	if (bPredictTransforms && GetOwnerRole() < ROLE_Authority)
+	{
+		//Ids wrap around, so never keep enough Predictions for an Id to be reused while waiting
+		if (PredictedDrags.Num() >= 128)
+			PredictedDrags.RemoveAt(0);
+
+		FPredictedDragState& prediction = PredictedDrags.AddDefaulted_GetRef();
+		prediction.DragId = StreamDragId;
+
+		TArray<USceneComponent*> components;
+		TArray<FSelectionEntry> entries;
+		GetTransformableComponents(components, entries);
+		for (USceneComponent* component : components)
+			prediction.Transforms.Add(component, component->GetComponentTransform());
+
+		TArray<int32> instances;
+		for (auto& pair : SelectedInstances)
+		{
+			UInstancedStaticMeshComponent* ism = pair.Key.Get();
+			if (!ism) continue;
+
+			TMap<int32, FTransform>& instanceTransforms = prediction.InstanceTransforms.Add(ism);
+			pair.Value.GetInstances(instances);
+			for (int32 instance : instances)
+			{
+				FTransform transform;
+				if (ism->GetInstanceTransform(instance, transform, true))
+					instanceTransforms.Add(instance, transform);
+			}
+		}
+	}
+
+	ServerCommitStreamedTransform(NetworkDeltaTransform, StreamSequence, StreamDragId);
+	++StreamDragId;
+	ResetDeltaTransform(LastStreamedDelta);
+}
+
+void UTransformerComponent::StreamTransform()
+{
+	if (!bStreamTransforms || CurrentDomain == ETransformationDomain::TD_None) return;
+
+	UWorld* world = GetWorld();
+	if (!world) return;
+
+	const float currentTime = world->GetTimeSeconds();
+	if (currentTime - LastStreamTime < 1.f / FMath::Max(TransformStreamRate, 1.f))
+		return;
+
+	//nothing moved since the last packet
+	if (NetworkDeltaTransform.Equals(LastStreamedDelta, 0.f))
+		return;
+
+	FTransformStreamPacket packet;
+	packet.Sequence = ++StreamSequence;
+	packet.DragId = StreamDragId;
+	packet.AccumulatedDelta = NetworkDeltaTransform;
+
+	ServerStreamTransform(packet);
+
+	LastStreamTime = currentTime;
+	LastStreamedDelta = NetworkDeltaTransform;
+}
+
+bool UTransformerComponent::ServerStreamTransform_Validate(const FTransformStreamPacket& Packet)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerStreamTransform_Implementation(const FTransformStreamPacket& Packet)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StreamRPCs, sizeof(FTransformStreamPacket));
+	ResolveServerTraces();
+	MulticastStreamTransform(Packet);
+}
+
+void UTransformerComponent::MulticastStreamTransform_Implementation(const FTransformStreamPacket& Packet)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MulticastStreamTransform);
+	COUNT_RPC(STAT_RuntimeTransformer_StreamRPCs, sizeof(FTransformStreamPacket));
+	if (GetPlayerController() && !GetPlayerController()->IsLocalController()) //only apply to others
+	{
+		//left over of a Drag that has already been Committed
+		if (bHasCommittedSequence
+			&& !FTransformStreamPacket::IsNewerSequence(Packet.Sequence, LastCommittedSequence))
+			return;
+
+		FStreamedDragState* dragState = StreamedDrags.Find(Packet.DragId);
+		if (dragState && !FTransformStreamPacket::IsNewerSequence(Packet.Sequence, dragState->LastSequence))
+			return; //out of order
+
+		ApplyStreamedDelta(Packet.DragId, Packet.Sequence, Packet.AccumulatedDelta
+		                   , ShouldInterpolateStreamedDrags());
+	}
+}
+
+bool UTransformerComponent::ServerCommitStreamedTransform_Validate(const FTransform& FinalDeltaTransform
+                                                                   , uint16 LastSequence, uint8 DragId)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerCommitStreamedTransform_Implementation(const FTransform& FinalDeltaTransform
+                                                                         , uint16 LastSequence, uint8 DragId)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, sizeof(FTransform) + sizeof(uint16) + sizeof(uint8));
+	ResolveServerTraces();
+	FlushServerStateBatches(true);
+	MulticastCommitStreamedTransform(FinalDeltaTransform, LastSequence, DragId);
+
+	//the Multicast has been applied here by now
+	if (bPredictTransforms && GetPlayerController() && !GetPlayerController()->IsLocalController())
+		AcknowledgeDrag(DragId);
+}
+
+void UTransformerComponent::MulticastCommitStreamedTransform_Implementation(const FTransform& FinalDeltaTransform
+                                                                            , uint16 LastSequence, uint8 DragId)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MulticastCommitStreamedTransform);
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, sizeof(FTransform) + sizeof(uint16) + sizeof(uint8));
+	if (GetPlayerController() && !GetPlayerController()->IsLocalController()) //only apply to others
+	{
+		ApplyStreamedDelta(DragId, LastSequence, FinalDeltaTransform, false);
+		StreamedDrags.Remove(DragId);
+
+		//Drags older than this one that never got Committed (shouldn't happen as Commits are Reliable) are stale too
+		for (auto it = StreamedDrags.CreateIterator(); it; ++it)
+		{
+			if (!FTransformStreamPacket::IsNewerSequence(it.Value().LastSequence, LastSequence))
+				it.RemoveCurrent();
+		}
+
+		LastCommittedSequence = LastSequence;
+		bHasCommittedSequence = true;
+		UpdateComponentTickState();
+	}
+}
+
+void UTransformerComponent::AcknowledgeDrag(uint8 DragId)
+{
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	GetTransformableComponents(components, entries);
+	if (components.Num() > MaxAcknowledgedComponents)
+		components.SetNum(MaxAcknowledgedComponents);
+
+	TArray<FTransform> transforms;
+	transforms.Reserve(components.Num());
+	for (USceneComponent* component : components)
+		transforms.Add(component->GetComponentTransform());
+
+	//the Instances share the same cap, after the Components
+	int32 remaining = MaxAcknowledgedComponents - components.Num();
+	TArray<FAcknowledgedInstances> acknowledgedInstances;
+	for (auto& pair : SelectedInstances)
+	{
+		UInstancedStaticMeshComponent* ism = pair.Key.Get();
+		if (!ism || remaining <= 0) continue;
+
+		FAcknowledgedInstances& acknowledged = acknowledgedInstances.AddDefaulted_GetRef();
+		acknowledged.Component = ism;
+		pair.Value.GetInstances(acknowledged.Instances);
+		if (acknowledged.Instances.Num() > remaining)
+			acknowledged.Instances.SetNum(remaining);
+		remaining -= acknowledged.Instances.Num();
+
+		acknowledged.Transforms.SetNumUninitialized(acknowledged.Instances.Num());
+		for (int32 i = 0; i < acknowledged.Instances.Num(); ++i)
+			ism->GetInstanceTransform(acknowledged.Instances[i], acknowledged.Transforms[i], true);
+	}
+
+	ClientAcknowledgeDrag(DragId, components, transforms, acknowledgedInstances);
+}
+
+void UTransformerComponent::ClientAcknowledgeDrag_Implementation(uint8 DragId
+                                                                 , const TArray<USceneComponent*>& Components
+                                                                 , const TArray<FTransform>& Transforms
+                                                                 , const TArray<FAcknowledgedInstances>& Instances)
+{
+	int32 instanceCount = 0;
+	for (const FAcknowledgedInstances& acknowledged : Instances)
+		instanceCount += acknowledged.Instances.Num();
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, sizeof(uint8)
+	          + Components.Num() * (sizeof(USceneComponent*) + sizeof(FTransform))
+	          + Instances.Num() * sizeof(USceneComponent*) + instanceCount * (sizeof(int32) + sizeof(FTransform)));
+
+	//Acknowledgements arrive in order, so the Predictions before this one have been Acknowledged already
+	const int32 index = PredictedDrags.IndexOfByPredicate([DragId](const FPredictedDragState& Prediction)
+	{
+		return Prediction.DragId == DragId;
+	});
+	if (index == INDEX_NONE) return;
+
+	const FPredictedDragState prediction = MoveTemp(PredictedDrags[index]);
+	PredictedDrags.RemoveAt(0, index + 1);
+
+	const float angleTolerance = FMath::DegreesToRadians(PredictionAngleTolerance);
+	auto isWithinTolerance = [this, angleTolerance](const FTransform& Predicted, const FTransform& Server)
+	{
+		return Predicted.GetLocation().Equals(Server.GetLocation(), PredictionLocationTolerance)
+			&& Predicted.GetRotation().AngularDistance(Server.GetRotation()) <= angleTolerance
+			&& Predicted.GetScale3D().Equals(Server.GetScale3D(), PredictionScaleTolerance);
+	};
+
+	//the corrections are applied in one batch, like any other Transform (so the Focusable Objects are notified)
+	TArray<USceneComponent*> components;
+	TArray<FSelectionEntry> entries;
+	TArray<FTransform> transforms;
+
+	const int32 count = FMath::Min(Components.Num(), Transforms.Num());
+	for (int32 i = 0; i < count; ++i)
+	{
+		USceneComponent* component = Components[i];
+		const FTransform* predictedTransform = component ? prediction.Transforms.Find(component) : nullptr;
+		if (!predictedTransform || isWithinTolerance(*predictedTransform, Transforms[i])) continue;
+
+		//keep whatever it was moved since (e.g. by a later Drag), on top of the Server's Transform
+		const FTransform movedSince = component->GetComponentTransform().GetRelativeTransform(*predictedTransform);
+		const FSelectionEntry* entry = SelectedComponents.FindEntry(component);
+		components.Add(component);
+		entries.Add(entry ? *entry : ResolveSelectionEntry(component));
+		transforms.Add(movedSince * Transforms[i]);
+	}
+
+	bool bReconciled = components.Num() > 0;
+	if (bReconciled)
+	{
+		ApplyComponentTransforms(components, entries, transforms);
+		INC_DWORD_STAT_BY(STAT_RuntimeTransformer_ComponentsReconciled, components.Num());
+	}
+
+	TArray<int32> instances;
+	for (const FAcknowledgedInstances& acknowledged : Instances)
+	{
+		UInstancedStaticMeshComponent* ism = acknowledged.Component;
+		const TMap<int32, FTransform>* predictedInstances = ism ? prediction.InstanceTransforms.Find(ism) : nullptr;
+		if (!predictedInstances) continue;
+
+		//the Server sends them in ascending order, which the batched update relies on
+		instances.Reset();
+		transforms.Reset();
+		const int32 instanceCount = FMath::Min(acknowledged.Instances.Num(), acknowledged.Transforms.Num());
+		for (int32 i = 0; i < instanceCount; ++i)
+		{
+			const int32 instance = acknowledged.Instances[i];
+			const FTransform* predictedTransform = predictedInstances->Find(instance);
+			FTransform currentTransform;
+			if (!predictedTransform || isWithinTolerance(*predictedTransform, acknowledged.Transforms[i])
+				|| !ism->GetInstanceTransform(instance, currentTransform, true))
+				continue;
+
+			instances.Add(instance);
+			transforms.Add(currentTransform.GetRelativeTransform(*predictedTransform) * acknowledged.Transforms[i]);
+		}
+
+		if (instances.Num() == 0) continue;
+		UpdateInstanceTransforms(ism, instances, transforms);
+		INC_DWORD_STAT_BY(STAT_RuntimeTransformer_ComponentsReconciled, instances.Num());
+		bReconciled = true;
+	}
+
+	if (bReconciled)
+	{
+		//the Drag in progress (if any) continues from the corrected Transforms
+		DragSnapshot.Reset();
+		bGizmoScaleDirty = true;
+	}
+}
+
+void UTransformerComponent::SendLayoutToClient(const TArray<uint8>& Data)
+{
+	APlayerController* playerController = GetPlayerController();
+	if (GetOwnerRole() != ROLE_Authority || !playerController || playerController->IsLocalController())
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("A Layout can only be sent by the Server to a Remote Client!"));
+		return;
+	}
+
+	if (Data.Num() == 0) return;
+
+	OutgoingLayout = Data;
+	OutgoingLayoutOffset = 0;
+	++OutgoingLayoutId;
+
+	if (UWorld* world = GetWorld())
+		world->GetTimerManager().ClearTimer(LayoutTransferTimerHandle);
+	SendLayoutChunks();
+}
+
+void UTransformerComponent::SendLayoutChunks()
 {
-	return true;
-}
+	LayoutTransferTimerHandle.Invalidate();
+	if (OutgoingLayout.Num() == 0) return;
 
-void UTransformerComponent::ServerTraceByObjectTypes_Implementation(
-	const FVector& StartLocation, const FVector& EndLocation
-	, const TArray<TEnumAsByte<ECollisionChannel>>& CollisionChannels
-	, bool bAppendToList)
-{
-	bool bTraceSuccessful = TraceByObjectTypes(StartLocation, EndLocation, CollisionChannels
-	                                           , GetIgnoredActorsForServerTrace(), bAppendToList);
+	AActor* owner = GetOwner();
+	UNetConnection* connection = owner ? owner->GetNetConnection() : nullptr;
+	if (!connection)
+	{
+		OutgoingLayout.Empty();
+		OutgoingLayoutOffset = 0;
+		return;
+	}
+	UActorChannel* channel = connection->FindActorChannelRef(owner);
 
-	if (!bTraceSuccessful && !bAppendToList)
-		//check whether trace was successful and we're not doing multi selection
-		DeselectAll(false);
+	const int32 chunkSize = FMath::Max(LayoutChunkSize, 1);
+	TArray<uint8> chunk;
+	for (int32 i = 0; i < MaxLayoutChunksPerFrame && OutgoingLayoutOffset < OutgoingLayout.Num(); ++i)
+	{
+		//an overflowing Reliable Buffer closes the Connection, so wait for the chunks sent to be Acked first
+		if (!connection->IsNetReady(false) || (channel && channel->NumOutRec >= RELIABLE_BUFFER / 2))
+			break;
 
-	MulticastSetDomain(CurrentDomain);
-	MulticastSetSelectedComponents(SelectedComponents);
-}
+		const int32 size = FMath::Min(chunkSize, OutgoingLayout.Num() - OutgoingLayoutOffset);
+		chunk.Reset(size);
+		chunk.Append(OutgoingLayout.GetData() + OutgoingLayoutOffset, size);
 
+		COUNT_RPC(STAT_RuntimeTransformer_LayoutRPCs, sizeof(uint8) + sizeof(int32) + size);
+		ClientReceiveLayoutChunk(OutgoingLayoutId, OutgoingLayout.Num(), chunk);
+		OutgoingLayoutOffset += size;
+	}
 
-bool UTransformerComponent::ServerTraceByChannel_Validate(
-	const FVector& StartLocation, const FVector& EndLocation
-	, ECollisionChannel TraceChannel, bool bAppendToList)
-{
-	return true;
+	if (OutgoingLayoutOffset >= OutgoingLayout.Num())
+	{
+		OutgoingLayout.Empty();
+		OutgoingLayoutOffset = 0;
+	}
+	else if (UWorld* world = GetWorld())
+		LayoutTransferTimerHandle = world->GetTimerManager().SetTimerForNextTick(
+			this, &UTransformerComponent::SendLayoutChunks);
 }
 
-void UTransformerComponent::ServerTraceByChannel_Implementation(
-	const FVector& StartLocation, const FVector& EndLocation
-	, ECollisionChannel TraceChannel, bool bAppendToList)
+void UTransformerComponent::ClientReceiveLayoutChunk_Implementation(uint8 TransferId, int32 TotalSize
+                                                                    , const TArray<uint8>& Chunk)
 {
-	bool bTraceSuccessful = TraceByChannel(StartLocation, EndLocation, TraceChannel
-	                                       , GetIgnoredActorsForServerTrace(), bAppendToList);
+	COUNT_RPC(STAT_RuntimeTransformer_LayoutRPCs, sizeof(uint8) + sizeof(int32) + Chunk.Num());
 
-	if (!bTraceSuccessful && !bAppendToList)
-		//check whether trace was successful and we're not doing multi selection
-		DeselectAll(false);
+	if (TransferId != IncomingLayoutId)
+	{
+		IncomingLayoutId = TransferId;
+		bReceivingLayout = TotalSize > 0 && TotalSize / 1024 < MaxLayoutTransferSizeKB;
+		if (!bReceivingLayout)
+		{
+			UE_LOG(LogRuntimeTransformer, Warning, TEXT("Dropping a Layout of %d bytes!"), TotalSize);
+			IncomingLayout.Empty();
+			return;
+		}
 
-	MulticastSetDomain(CurrentDomain);
-	MulticastSetSelectedComponents(SelectedComponents);
-}
+		IncomingLayout.Reset(TotalSize);
+		IncomingLayoutSize = TotalSize;
+	}
 
+	//the rest of a Transfer that was dropped
+	if (!bReceivingLayout) return;
 
-bool UTransformerComponent::ServerTraceByProfile_Validate(const FVector& StartLocation
-                                                          , const FVector& EndLocation, const FName& ProfileName,
-                                                          bool bAppendToList)
-{
-	return true;
-}
+	if (TotalSize != IncomingLayoutSize || IncomingLayout.Num() + Chunk.Num() > IncomingLayoutSize)
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Received a Layout chunk that doesn't fit! Dropping the Layout"));
+		IncomingLayout.Empty();
+		bReceivingLayout = false;
+		return;
+	}
 
+	IncomingLayout.Append(Chunk);
+	if (IncomingLayout.Num() < IncomingLayoutSize) return;
 
-void UTransformerComponent::ServerTraceByProfile_Implementation(
-	const FVector& StartLocation, const FVector& EndLocation
-	, const FName& ProfileName, bool bAppendToList)
+	bReceivingLayout = false;
+	TUniquePtr<FLayoutImport> import = MakeUnique<FLayoutImport>();
+	if (import->OpenData(MoveTemp(IncomingLayout)))
+		BeginLayoutImport(MoveTemp(import));
+	else
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Received a Layout that is not valid!"));
+	IncomingLayout.Reset();
+}
+
+void UTransformerComponent::ApplyStreamedDelta(uint8 DragId, uint16 Sequence, const FTransform& AccumulatedDelta
+                                               , bool bInterpolate)
 {
-	bool bTraceSuccessful = TraceByProfile(StartLocation, EndLocation, ProfileName
-	                                       , GetIgnoredActorsForServerTrace(), bAppendToList);
+	FStreamedDragState* dragState = StreamedDrags.Find(DragId);
+	if (!dragState)
+	{
+		dragState = &StreamedDrags.Add(DragId);
+		ResetDeltaTransform(dragState->AppliedDelta);
+	}
 
-	if (!bTraceSuccessful && !bAppendToList)
-		//check whether trace was successful and we're not doing multi selection
-		DeselectAll(false);
+	dragState->LastSequence = Sequence;
+	dragState->TargetDelta = AccumulatedDelta;
 
-	MulticastSetDomain(CurrentDomain);
-	MulticastSetSelectedComponents(SelectedComponents);
-}
+	if (bInterpolate)
+	{
+		//from wherever the previous Interpolation got to. @see InterpolateStreamedDrags
+		dragState->StartDelta = dragState->AppliedDelta;
+		dragState->InterpolationAlpha = 0.f;
+		UpdateComponentTickState();
+		return;
+	}
 
-bool UTransformerComponent::ServerClearDomain_Validate()
-{
-	return true;
-}
+	ApplyDeltaTransform(GetDeltaBetween(dragState->AppliedDelta, AccumulatedDelta));
 
-void UTransformerComponent::ServerClearDomain_Implementation()
-{
-	MulticastClearDomain();
+	dragState->AppliedDelta = AccumulatedDelta;
+	dragState->InterpolationAlpha = 1.f;
 }
 
-void UTransformerComponent::MulticastClearDomain_Implementation()
+bool UTransformerComponent::ShouldInterpolateStreamedDrags() const
 {
-	ClearDomain();
+	return bInterpolateStreamedTransforms && GetNetMode() != NM_DedicatedServer;
 }
 
-bool UTransformerComponent::ServerApplyTransform_Validate(const FTransform& DeltaTransform)
+bool UTransformerComponent::IsInterpolatingStreamedDrags() const
 {
-	return true;
+	for (auto& dragPair : StreamedDrags)
+		if (dragPair.Value.InterpolationAlpha < 1.f)
+			return true;
+	return false;
 }
 
-void UTransformerComponent::ServerApplyTransform_Implementation(const FTransform& DeltaTransform)
+void UTransformerComponent::InterpolateStreamedDrags(float DeltaTime)
 {
-	MulticastApplyTransform(DeltaTransform);
-}
+	if (!IsInterpolatingStreamedDrags()) return;
 
-void UTransformerComponent::MulticastApplyTransform_Implementation(const FTransform& DeltaTransform)
-{
-	if (GetPlayerController() && !GetPlayerController()->IsLocalController()) //only apply to others
-		ApplyDeltaTransform(DeltaTransform);
-}
+	//over the time until the next Packet is due
+	const float alphaStep = DeltaTime * FMath::Max(TransformStreamRate, 1.f);
 
+	for (auto& dragPair : StreamedDrags)
+	{
+		FStreamedDragState& dragState = dragPair.Value;
+		if (dragState.InterpolationAlpha >= 1.f) continue;
 
-void UTransformerComponent::ReplicateFinishTransform()
+		dragState.InterpolationAlpha = FMath::Min(dragState.InterpolationAlpha + alphaStep, 1.f);
+		const FTransform interpolatedDelta = InterpolateAccumulatedDelta(dragState.StartDelta
+		                                                                 , dragState.TargetDelta
+		                                                                 , dragState.InterpolationAlpha);
+
+		ApplyDeltaTransform(GetDeltaBetween(dragState.AppliedDelta, interpolatedDelta));
+		dragState.AppliedDelta = interpolatedDelta;
+	}
+
+	if (!IsInterpolatingStreamedDrags())
+		UpdateComponentTickState();
+}
+
+FTransform UTransformerComponent::GetDeltaBetween(const FTransform& From, const FTransform& To)
 {
-	ServerClearDomain();
-	ServerApplyTransform(NetworkDeltaTransform);
-	ResetDeltaTransform(NetworkDeltaTransform);
+	return FTransform(
+		To.GetRotation() * From.GetRotation().Inverse(),
+		To.GetLocation() - From.GetLocation(),
+		To.GetScale3D() - From.GetScale3D());
 }
 
 bool UTransformerComponent::ServerDeselectAll_Validate(bool bDestroySelected)
@@ -1222,11 +3983,19 @@ bool UTransformerComponent::ServerDeselectAll_Validate(bool bDestroySelected)
 
 void UTransformerComponent::ServerDeselectAll_Implementation(bool bDestroySelected)
 {
-	MulticastDeselectAll(bDestroySelected);
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, sizeof(bool));
+	ResolveServerTraces();
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_DeselectAll, bCoalesced))
+		batch->DeselectAll(bDestroySelected);
+	else if (!bCoalesced)
+		MulticastDeselectAll(bDestroySelected);
 }
 
 void UTransformerComponent::MulticastDeselectAll_Implementation(bool bDestroySelected)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MulticastDeselectAll);
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, sizeof(bool));
 	DeselectAll(bDestroySelected);
 }
 
@@ -1237,11 +4006,17 @@ bool UTransformerComponent::ServerSetSpaceType_Validate(ESpaceType Space)
 
 void UTransformerComponent::ServerSetSpaceType_Implementation(ESpaceType Space)
 {
-	MulticastSetSpaceType(Space);
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ESpaceType));
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_SpaceType, bCoalesced))
+		batch->SetSpaceType(Space);
+	else if (!bCoalesced)
+		MulticastSetSpaceType(Space);
 }
 
 void UTransformerComponent::MulticastSetSpaceType_Implementation(ESpaceType Space)
 {
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ESpaceType));
 	SetSpaceType(Space);
 }
 
@@ -1253,11 +4028,17 @@ bool UTransformerComponent::ServerSetTransformationType_Validate(ETransformation
 
 void UTransformerComponent::ServerSetTransformationType_Implementation(ETransformationType Transformation)
 {
-	MulticastSetTransformationType(Transformation);
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ETransformationType));
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_TransformationType, bCoalesced))
+		batch->SetTransformationType(Transformation);
+	else if (!bCoalesced)
+		MulticastSetTransformationType(Transformation);
 }
 
 void UTransformerComponent::MulticastSetTransformationType_Implementation(ETransformationType Transformation)
 {
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ETransformationType));
 	SetTransformationType(Transformation);
 }
 
@@ -1268,11 +4049,18 @@ bool UTransformerComponent::ServerSetComponentBased_Validate(bool bIsComponentBa
 
 void UTransformerComponent::ServerSetComponentBased_Implementation(bool bIsComponentBased)
 {
-	MulticastSetComponentBased(bIsComponentBased);
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(bool));
+	ResolveServerTraces();
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_ComponentBased, bCoalesced))
+		batch->SetComponentBased(bIsComponentBased);
+	else if (!bCoalesced)
+		MulticastSetComponentBased(bIsComponentBased);
 }
 
 void UTransformerComponent::MulticastSetComponentBased_Implementation(bool bIsComponentBased)
 {
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(bool));
 	SetComponentBased(bIsComponentBased);
 }
 
@@ -1283,11 +4071,17 @@ bool UTransformerComponent::ServerSetRotateOnLocalAxis_Validate(bool bRotateLoca
 
 void UTransformerComponent::ServerSetRotateOnLocalAxis_Implementation(bool bRotateLocalAxis)
 {
-	MulticastSetRotateOnLocalAxis(bRotateLocalAxis);
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(bool));
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_RotateOnLocalAxis, bCoalesced))
+		batch->SetRotateOnLocalAxis(bRotateLocalAxis);
+	else if (!bCoalesced)
+		MulticastSetRotateOnLocalAxis(bRotateLocalAxis);
 }
 
 void UTransformerComponent::MulticastSetRotateOnLocalAxis_Implementation(bool bRotateLocalAxis)
 {
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(bool));
 	SetRotateOnLocalAxis(bRotateLocalAxis);
 }
 
@@ -1301,6 +4095,9 @@ bool UTransformerComponent::ServerCloneSelected_Validate(bool bSelectNewClones,
 void UTransformerComponent::ServerCloneSelected_Implementation(bool bSelectNewClones
                                                                , bool bAppendToList)
 {
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, 2 * sizeof(bool));
+	ResolveServerTraces();
+	FlushServerStateBatches(true);
 	if (bComponentBased)
 	{
 		UE_LOG(LogRuntimeTransformer, Warning,
@@ -1309,73 +4106,420 @@ void UTransformerComponent::ServerCloneSelected_Implementation(bool bSelectNewCl
 		return;
 	}
 
-	auto ComponentListCopy = GetSelectedComponents();
+	TArray<AActor*> actors;
+	actors.Reserve(SelectedComponents.Num());
+	for (USceneComponent* sc : SelectedComponents)
+		if (AActor* owner = sc->GetOwner())
+			actors.Add(owner);
 
-	//just create 'em, not select 'em (we select 'em later)
-	auto CloneList = CloneFromList(ComponentListCopy);
+	//the clones go into the Replicated Selection once the Batch completes. A client won't be able to resolve them
+	//until they replicate there, at which point they get selected (no need to wait or poll for them here)
+	BeginCloneBatch(actors, bSelectNewClones, bAppendToList);
+}
 
-	//if we have to select the new clones, multicast for these new objects
-	if (bSelectNewClones)
+bool UTransformerComponent::ServerSetDomain_Validate(ETransformationDomain Domain)
+{
+	return true;
+}
+
+void UTransformerComponent::ServerSetDomain_Implementation(ETransformationDomain Domain)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ETransformationDomain));
+	ResolveServerTraces();
+	bool bCoalesced;
+	if (FTransformerStateBatch* batch = GetServerStateBatch(FTransformerStateBatch::SB_Domain, bCoalesced))
+		batch->SetDomain(Domain);
+	else if (!bCoalesced)
+		MulticastSetDomain(Domain);
+}
+
+void UTransformerComponent::MulticastSetDomain_Implementation(ETransformationDomain Domain)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, sizeof(ETransformationDomain));
+	SetDomain(Domain);
+}
+
+bool UTransformerComponent::ServerUndo_Validate()
+{
+	return true;
+}
+
+void UTransformerComponent::ServerUndo_Implementation()
+{
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, 0);
+	ResolveServerTraces();
+	FlushServerStateBatches(true);
+	Undo();
+}
+
+bool UTransformerComponent::ServerRedo_Validate()
+{
+	return true;
+}
+
+void UTransformerComponent::ServerRedo_Implementation()
+{
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs, 0);
+	ResolveServerTraces();
+	FlushServerStateBatches(true);
+	Redo();
+}
+
+void UTransformerComponent::MulticastApplyHistoryStep_Implementation(const FTransformHistoryStep& Step)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_TransformRPCs
+	          , Step.Components.GetTypeSize() * Step.Components.Num()
+	          + Step.Transforms.GetTypeSize() * Step.Transforms.Num()
+	          + Step.DeletedActors.GetTypeSize() * (Step.DeletedActors.Num() + Step.RestoredActors.Num()));
+	ApplyHistoryStep(Step);
+}
+
+void UTransformerComponent::ClientSelectionRejected_Implementation(USceneComponent* Component
+                                                                   , ESelectionRejectReason Reason)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, sizeof(FNetworkGUID) + sizeof(ESelectionRejectReason));
+	if (Component && SelectedComponents.Contains(Component))
+	{
+		FScopedSelectionTransaction SelectionTransaction(this);
+		DeselectComponent_Internal(SelectedComponents, Component);
+		UpdateGizmoPlacement();
+	}
+	OnSelectionRejected.Broadcast(Component, Reason);
+}
+
+void UTransformerComponent::ClientObserveEditor_Implementation(const FObservedEditorUpdate& Update)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_ObserverRPCs, Update.GetParameterSize());
+	FObservedEditorState* observed = ObservedEditors.FindByPredicate([&Update](const FObservedEditorState& Entry)
 	{
-		SelectMultipleComponents(CloneList, bAppendToList);
-		UnreplicatedComponentClones = CloneList;
+		return Entry.Editor == Update.Editor;
+	});
 
-		//Timer to loop until all Unreplicated Actors have finished replicating!
-		if (UWorld* world = GetWorld())
+	if (!observed)
+		observed = &ObservedEditors.AddDefaulted_GetRef();
+	Update.ApplyTo(*observed);
+
+	OnObservedEditorChanged.Broadcast(Update.Editor);
+}
+
+void UTransformerComponent::ClientForgetEditor_Implementation(APlayerState* Editor)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_ObserverRPCs, sizeof(FNetworkGUID));
+	ObservedEditors.RemoveAllSwap([Editor](const FObservedEditorState& Entry)
+	{
+		return Entry.Editor == Editor;
+	});
+	OnObservedEditorChanged.Broadcast(Editor);
+}
+
+void UTransformerComponent::SetEditingGroup(FName Group)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("[%s] The Editing Group can only be set by the Server!")
+		       , *GetNameSafe(GetOwner()));
+		return;
+	}
+	EditingGroup = Group;
+}
+
+APlayerState* UTransformerComponent::GetObservedEditor(USceneComponent* Component) const
+{
+	if (!Component) return nullptr;
+	for (const FObservedEditorState& observed : ObservedEditors)
+	{
+		if (observed.Components.Contains(Component))
+			return observed.Editor;
+	}
+	return nullptr;
+}
+
+void UTransformerComponent::UpdateObservers(const TArray<TWeakObjectPtr<UTransformerComponent>>& Transformers
+                                            , bool bUpdateInterest)
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_UpdateObservers);
+
+	const APlayerController* playerController = GetPlayerController();
+	APlayerState* editor = playerController ? playerController->PlayerState : nullptr;
+	//Observers would have no way to tell the Editors apart
+	if (!editor) return;
+
+	//the Observers that just became interested, which get the State regardless of it having changed
+	TArray<UTransformerComponent*, TInlineAllocator<8>> caughtUp;
+	if (bUpdateInterest)
+	{
+		Observers.RemoveAllSwap([](const TWeakObjectPtr<UTransformerComponent>& Observer)
+		{
+			return !Observer.IsValid();
+		});
+
+		for (const TWeakObjectPtr<UTransformerComponent>& transformer : Transformers)
 		{
-			if (!CheckUnrepTimerHandle.IsValid())
-				world->GetTimerManager().SetTimer(CheckUnrepTimerHandle, this
-				                                  , &UTransformerComponent::CheckUnreplicatedActors
-				                                  , CloneReplicationCheckFrequency, true, 0.0f);
+			UTransformerComponent* observer = transformer.Get();
+			if (!observer || observer == this) continue;
+
+			const bool bInterested = observer->IsInterestedIn(this);
+			const int32 index = Observers.IndexOfByKey(observer);
+			if (bInterested && index == INDEX_NONE)
+			{
+				Observers.Add(observer);
+				caughtUp.Add(observer);
+			}
+			else if (!bInterested && index != INDEX_NONE)
+			{
+				Observers.RemoveAtSwap(index, 1, false);
+				observer->ClientForgetEditor(editor);
+			}
 		}
 	}
+
+	if (!bObservedStateDirty && caughtUp.Num() == 0) return;
+
+	FObservedEditorUpdate update;
+	GetObservedUpdate(update);
+
+	//the ones catching up get the whole Selection
+	if (caughtUp.Num() > 0)
+	{
+		TArray<USceneComponent*> selected = SelectedComponents.ToArray();
+		update.bReset = true;
+		for (UTransformerComponent* observer : caughtUp)
+			SendObservedUpdate(observer, update, selected, TArray<USceneComponent*>());
+		update.bReset = false;
+	}
+
+	if (!bObservedStateDirty) return;
+	bObservedStateDirty = false;
+
+	//the rest only what changed since they were last sent it
+	TArray<USceneComponent*> added, removed;
+	TSet<TWeakObjectPtr<USceneComponent>> current;
+	current.Reserve(SelectedComponents.Num());
+	for (USceneComponent* component : SelectedComponents)
+	{
+		current.Add(component);
+		if (!ObservedComponents.Contains(component))
+			added.Add(component);
+	}
+	for (const TWeakObjectPtr<USceneComponent>& component : ObservedComponents)
+	{
+		//the ones that are gone are dropped by the Observers themselves
+		if (component.IsValid() && !current.Contains(component))
+			removed.Add(component.Get());
+	}
+	ObservedComponents = MoveTemp(current);
+
+	for (const TWeakObjectPtr<UTransformerComponent>& observer : Observers)
+	{
+		if (observer.IsValid() && !caughtUp.Contains(observer.Get()))
+			SendObservedUpdate(observer.Get(), update, added, removed);
+	}
 }
 
-void UTransformerComponent::CheckUnreplicatedActors()
+void UTransformerComponent::SendObservedUpdate(UTransformerComponent* Observer, const FObservedEditorUpdate& Update
+                                               , const TArray<USceneComponent*>& Added
+                                               , const TArray<USceneComponent*>& Removed)
 {
-	int32 RemoveCount = 0;
-	float timeElapsed = GetOwner()->GetWorldTimerManager().GetTimerElapsed(CheckUnrepTimerHandle);
-	for (auto& c : UnreplicatedComponentClones)
+	const int32 maxComponents = FMath::Max(1, MaxObservedComponentsPerUpdate);
+	int32 addedIndex = 0;
+	int32 removedIndex = 0;
+
+	FObservedEditorUpdate chunk = Update;
+	do
 	{
-		// rather than calling "IsSupportedForNetworking" (which returns true all the time)
-		// call HasActorBegunPlay (which means we are sure the BeginPlay for AActor has finished completely.
-		// and so we can safely send this reference over the network.
-		if (c && c->HasBegunPlay() && c->IsSupportedForNetworking() &&
-			timeElapsed > MinimumCloneReplicationTime) // Make sure there's a minimum time...
-			++RemoveCount;
+		chunk.RemovedComponents.Reset();
+		const int32 removedCount = FMath::Min(maxComponents, Removed.Num() - removedIndex);
+		chunk.RemovedComponents.Append(Removed.GetData() + removedIndex, removedCount);
+		removedIndex += removedCount;
+
+		chunk.AddedComponents.Reset();
+		const int32 addedCount = FMath::Min(maxComponents - removedCount, Added.Num() - addedIndex);
+		chunk.AddedComponents.Append(Added.GetData() + addedIndex, addedCount);
+		addedIndex += addedCount;
+
+		Observer->ClientObserveEditor(chunk);
+		chunk.bReset = false;
 	}
+	while (addedIndex < Added.Num() || removedIndex < Removed.Num());
+}
+
+bool UTransformerComponent::IsInterestedIn(const UTransformerComponent* Editor) const
+{
+	if (!bReplicateToObservers || !Editor) return false;
+
+	if (EditingGroup != NAME_None && EditingGroup == Editor->EditingGroup)
+		return true;
 
-	// Remove with performance (Swapping). We don't care about the order in this case
-	// since the role of this is to check that all unreplicated components have been replicated.
-	UnreplicatedComponentClones.RemoveAtSwap(0, RemoveCount);
+	APlayerController* playerController = GetPlayerController();
+	if (!playerController) return false;
 
-	// check if all clones have been replicated
-	if (UnreplicatedComponentClones.Num() == 0)
+	FVector viewLocation;
+	FRotator viewRotation;
+	playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+	const AActor* viewTarget = playerController->GetViewTarget();
+
+	int32 checks = 0;
+	const AActor* lastActor = nullptr;
+	for (USceneComponent* component : Editor->SelectedComponents)
 	{
-		//stop calling this if no more unreplicated actors
-		GetOwner()->GetWorldTimerManager().ClearTimer(CheckUnrepTimerHandle);
+		const AActor* actor = component ? component->GetOwner() : nullptr;
+		//Components of the same Actor are usually next to each other in the Selection
+		if (!actor || actor == lastActor) continue;
+		lastActor = actor;
 
-		UE_LOG(LogRuntimeTransformer, Log, TEXT("[SERVER] Time Elapsed for %d Replicated Actors to replicate: %f")
-		       , SelectedComponents.Num(), timeElapsed);
+		if (actor->IsNetRelevantFor(playerController, viewTarget, viewLocation))
+			return true;
 
-		//send all the selected replicated actors!
-		MulticastSetSelectedComponents(SelectedComponents);
+		if (++checks >= Editor->MaxObserverRelevancyChecks)
+			break;
 	}
+	return false;
 }
 
-bool UTransformerComponent::ServerSetDomain_Validate(ETransformationDomain Domain)
+void UTransformerComponent::ForgetObservers()
 {
-	return true;
+	const APlayerController* playerController = GetPlayerController();
+	APlayerState* editor = playerController ? playerController->PlayerState : nullptr;
+	for (const TWeakObjectPtr<UTransformerComponent>& observer : Observers)
+	{
+		if (observer.IsValid())
+			observer->ClientForgetEditor(editor);
+	}
+	Observers.Empty();
 }
 
-void UTransformerComponent::ServerSetDomain_Implementation(ETransformationDomain Domain)
+void UTransformerComponent::GetObservedUpdate(FObservedEditorUpdate& outUpdate) const
 {
-	MulticastSetDomain(Domain);
+	const APlayerController* playerController = GetPlayerController();
+	outUpdate.Editor = playerController ? playerController->PlayerState : nullptr;
+	outUpdate.TransformationType = CurrentTransformation;
+	outUpdate.SpaceType = CurrentSpaceType;
+	outUpdate.Domain = CurrentDomain;
 }
 
-void UTransformerComponent::MulticastSetDomain_Implementation(ETransformationDomain Domain)
+FTransformerStateBatch* UTransformerComponent::GetServerStateBatch(FTransformerStateBatch::EField Field
+                                                                   , bool& bOutCoalesced)
 {
-	SetDomain(Domain);
+	bOutCoalesced = bCoalesceServerCommands;
+	if (!bCoalesceServerCommands) return nullptr;
+
+	UWorld* world = GetWorld();
+	if (UTransformerSubsystem* subsystem = world ? world->GetSubsystem<UTransformerSubsystem>() : nullptr)
+		subsystem->QueueStateBatchFlush(this);
+	else
+	{
+		//nothing would flush the Batches, so send the change right away
+		bOutCoalesced = false;
+		return nullptr;
+	}
+
+	if (QueuedStateBatches.Num() > 0 && QueuedStateBatches.Last().CanMerge(Field))
+		return &QueuedStateBatches.Last();
+
+	//the changes are Reliable, so rather than dropping any, the full Queue is sent over the Budget
+	if (QueuedStateBatches.Num() >= MaxQueuedStateBatches)
+		FlushServerStateBatches(true);
+
+	return &QueuedStateBatches.AddDefaulted_GetRef();
+}
+
+void UTransformerComponent::FlushServerStateBatches(bool bIgnoreBudget)
+{
+	if (QueuedStateBatches.Num() == 0) return;
+
+	UWorld* world = GetWorld();
+	if (!world) return;
+
+	//up to a second's worth of Batches can be sent at once
+	const float currentTime = world->GetTimeSeconds();
+	StateBatchBudget = FMath::Min(StateBatchBudget + (currentTime - LastStateBatchBudgetTime) * MaxStateBatchesPerSecond
+	                              , MaxStateBatchesPerSecond);
+	LastStateBatchBudgetTime = currentTime;
+
+	int32 sentCount = 0;
+	for (; sentCount < QueuedStateBatches.Num(); ++sentCount)
+	{
+		if (!bIgnoreBudget && StateBatchBudget < 1.f)
+			break;
+
+		StateBatchBudget -= 1.f;
+		MulticastApplyStateBatch(QueuedStateBatches[sentCount]);
+	}
+	QueuedStateBatches.RemoveAt(0, sentCount);
+
+	if (QueuedStateBatches.Num() > 0)
+		if (UTransformerSubsystem* subsystem = world->GetSubsystem<UTransformerSubsystem>())
+			subsystem->QueueStateBatchFlush(this);
+}
+
+void UTransformerComponent::MulticastApplyStateBatch_Implementation(const FTransformerStateBatch& Batch)
+{
+	COUNT_RPC(STAT_RuntimeTransformer_StateRPCs, Batch.GetParameterSize());
+
+	//same order as the Batch merges them in
+	if (Batch.Has(FTransformerStateBatch::SB_TransformationType))
+		SetTransformationType(Batch.TransformationType);
+	if (Batch.Has(FTransformerStateBatch::SB_SpaceType))
+		SetSpaceType(Batch.SpaceType);
+	if (Batch.Has(FTransformerStateBatch::SB_ComponentBased))
+		SetComponentBased(Batch.bComponentBased);
+	if (Batch.Has(FTransformerStateBatch::SB_RotateOnLocalAxis))
+		SetRotateOnLocalAxis(Batch.bRotateOnLocalAxis);
+
+	if (Batch.Has(FTransformerStateBatch::SB_Domain))
+	{
+		if (Batch.Domain == ETransformationDomain::TD_None)
+			ClearDomain();
+		else
+			SetDomain(Batch.Domain);
+	}
+
+	if (Batch.Has(FTransformerStateBatch::SB_DeltaTransform))
+	{
+		if (GetPlayerController() && !GetPlayerController()->IsLocalController()) //only apply to others
+			ApplyDeltaTransform(Batch.DeltaTransform);
+	}
+
+	if (Batch.Has(FTransformerStateBatch::SB_DeselectAll))
+		DeselectAll(Batch.bDestroySelected);
+}
+
+void UTransformerComponent::ReplicateSelection()
+{
+	//defer until the Selection Transaction ends, so that the removals are flushed only once
+	if (SelectionTransactionDepth > 0)
+	{
+		bSelectionSyncPending = true;
+		return;
+	}
+
+	ReplicatedSelection.FlushRemovals();
+}
+
+void UTransformerComponent::OnReplicatedSelect(USceneComponent* Component)
+{
+	//Apply only the diff, so the Selection doesn't toggle if it was already selected locally
+	if (!Component || SelectedComponents.Contains(Component)) return;
+
+	AddComponent_Internal(SelectedComponents, Component, false);
+	bReplicatedSelectionChanged = true;
+}
+
+void UTransformerComponent::OnReplicatedDeselect(USceneComponent* Component)
+{
+	if (!Component || !SelectedComponents.Contains(Component)) return;
+
+	DeselectComponent_Internal(SelectedComponents, Component);
+	bReplicatedSelectionChanged = true;
+}
+
+void UTransformerComponent::OnRep_ReplicatedSelection()
+{
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_ReplicatedSelection);
+	if (!bReplicatedSelectionChanged) return;
+
+	bReplicatedSelectionChanged = false;
+	UpdateGizmoPlacement();
 }
 
 bool UTransformerComponent::ServerSyncSelectedComponents_Validate()
@@ -1385,57 +4529,39 @@ bool UTransformerComponent::ServerSyncSelectedComponents_Validate()
 
 void UTransformerComponent::ServerSyncSelectedComponents_Implementation()
 {
-	MulticastSetSelectedComponents(SelectedComponents);
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, 0);
+	ResolveServerTraces();
+	FlushServerStateBatches(true);
+	ReplicatedSelection.MarkArrayDirty();
 }
 
 void UTransformerComponent::MulticastSetSelectedComponents_Implementation(
 	const TArray<USceneComponent*>& Components)
 {
+	RUNTIMETRANSFORMER_SCOPE(STAT_RuntimeTransformer_MulticastSetSelectedComponents);
+	COUNT_RPC(STAT_RuntimeTransformer_SelectionRPCs, Components.Num() * sizeof(FNetworkGUID));
 	if (GetOwnerRole() < ROLE_Authority)
 	{
 		UE_LOG(LogRuntimeTransformer, Log, TEXT("MulticastSelect ComponentCount: %d"), Components.Num());
 	}
 
+	FScopedSelectionTransaction SelectionTransaction(this);
 
 	DeselectAll(); //calling here because Selecting MultipleComponents empty is not going to call Deselect all
 	SelectMultipleComponents(Components, true);
 
-	//Tells whether we have Selected the exact number of components that came in 
-	// or there was a nullptr in Components and therefore there is a difference.
-	// if there is a difference we will need to resync
-	bResyncSelection = (Components.Num() != SelectedComponents.Num());
-	if (bResyncSelection)
+	//Components that were not resolvable came in as nullptr. Unlike the Replicated Selection,
+	//these won't get selected once they resolve
+	if (Components.Num() != SelectedComponents.Num())
 	{
-		//Timer to loop until all Unreplicated Actors have finished replicating!
-		if (UWorld* world = GetWorld())
-		{
-			if (!ResyncSelectionTimerHandle.IsValid())
-				world->GetTimerManager().SetTimer(ResyncSelectionTimerHandle, this
-				                                  , &UTransformerComponent::ResyncSelection
-				                                  , 0.1f, true, 0.0f);
-		}
+		UE_LOG(LogRuntimeTransformer, Warning, TEXT("MulticastSelect: %d Components could not be resolved")
+		       , Components.Num() - SelectedComponents.Num());
 	}
 
-
 	if (GetOwnerRole() < ROLE_Authority)
 	{
 		UE_LOG(LogRuntimeTransformer, Log, TEXT("Selected ComponentCount: %d"), SelectedComponents.Num());
 	}
 }
 
-void UTransformerComponent::ResyncSelection()
-{
-	if (bResyncSelection)
-	{
-		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Resyncing Selection"));
-		ServerSyncSelectedComponents();
-	}
-	else
-	{
-		UE_LOG(LogRuntimeTransformer, Warning, TEXT("Resyncing FINISHED"));
-		//stop calling this if no more resync is needed
-		GetOwner()->GetWorldTimerManager().ClearTimer(ResyncSelectionTimerHandle);
-	}
-}
-
 #undef RTT_LOG
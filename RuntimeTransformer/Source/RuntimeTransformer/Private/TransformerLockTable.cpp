@@ -0,0 +1,200 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformerLockTable.h"
+#include "TransformerSubsystem.h"
+#include "TransformerComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+FTransformerLockItem::FTransformerLockItem()
+{
+	Object = nullptr;
+	Holder = nullptr;
+	AppliedObject = nullptr;
+	Count = 0;
+}
+
+void FTransformerLockItem::PreReplicatedRemove(const FTransformerLockList& InArraySerializer)
+{
+	if (AppliedObject)
+		InArraySerializer.ClientHolders.Remove(AppliedObject);
+	AppliedObject = nullptr;
+}
+
+void FTransformerLockItem::PostReplicatedAdd(const FTransformerLockList& InArraySerializer)
+{
+	//nullptr if not resolvable yet. PostReplicatedChange will be called once it is
+	if (Object)
+		InArraySerializer.ClientHolders.Add(Object, Holder);
+	AppliedObject = Object;
+}
+
+void FTransformerLockItem::PostReplicatedChange(const FTransformerLockList& InArraySerializer)
+{
+	if (AppliedObject && AppliedObject != Object)
+		InArraySerializer.ClientHolders.Remove(AppliedObject);
+	if (Object)
+		InArraySerializer.ClientHolders.Add(Object, Holder);
+	AppliedObject = Object;
+}
+
+ESelectionRejectReason FTransformerLockList::Acquire(UObject* Object, UTransformerComponent* Transformer
+                                                     , APlayerState* Holder, int32 MaxLocks)
+{
+	if (!Object || !Transformer) return ESelectionRejectReason::SR_None;
+
+	if (int32* index = ItemIndex.Find(Object))
+	{
+		FTransformerLockItem& item = Items[*index];
+		if (item.Object == Object)
+		{
+			if (item.HolderTransformer == Transformer)
+			{
+				++item.Count;
+				return ESelectionRejectReason::SR_None;
+			}
+
+			if (item.HolderTransformer.IsValid())
+				return ESelectionRejectReason::SR_LockedByOther;
+		}
+
+		//the Holder is gone (or the Item was nulled by the GC), so the Lock is free to take
+		RemoveItem(*index);
+	}
+
+	int32& heldLocks = HeldLocks.FindOrAdd(Transformer);
+	if (MaxLocks > 0 && heldLocks >= MaxLocks)
+		return ESelectionRejectReason::SR_LockLimitReached;
+	++heldLocks;
+
+	const int32 index = Items.AddDefaulted();
+	FTransformerLockItem& item = Items[index];
+	item.Object = Object;
+	item.Holder = Holder;
+	item.HolderTransformer = Transformer;
+	item.Count = 1;
+	ItemIndex.Add(Object, index);
+	MarkItemDirty(item);
+	return ESelectionRejectReason::SR_None;
+}
+
+void FTransformerLockList::Release(UObject* Object, UTransformerComponent* Transformer)
+{
+	const int32* index = ItemIndex.Find(Object);
+	if (!index) return;
+
+	FTransformerLockItem& item = Items[*index];
+	if (item.Object == Object && item.HolderTransformer != Transformer)
+		return; //someone else's
+
+	if (item.Object == Object && --item.Count > 0)
+		return;
+
+	RemoveItem(*index);
+}
+
+void FTransformerLockList::ReleaseAll(UTransformerComponent* Transformer)
+{
+	for (int32 i = Items.Num() - 1; i >= 0; --i)
+	{
+		if (Items[i].HolderTransformer == Transformer || !Items[i].HolderTransformer.IsValid())
+			RemoveItem(i);
+	}
+	HeldLocks.Remove(Transformer);
+}
+
+APlayerState* FTransformerLockList::GetHolder(const UObject* Object) const
+{
+	if (const int32* index = ItemIndex.Find(Object))
+		return Items[*index].Object == Object ? Items[*index].Holder : nullptr;
+
+	if (const TWeakObjectPtr<APlayerState>* holder = ClientHolders.Find(Object))
+		return holder->Get();
+
+	return nullptr;
+}
+
+UTransformerComponent* FTransformerLockList::GetHolderTransformer(const UObject* Object) const
+{
+	const int32* index = ItemIndex.Find(Object);
+	if (!index || Items[*index].Object != Object) return nullptr;
+	return Items[*index].HolderTransformer.Get();
+}
+
+void FTransformerLockList::RemoveItem(int32 Index)
+{
+	auto removeFromIndex = [this](int32 ItemIdx)
+	{
+		if (const UObject* object = Items[ItemIdx].Object)
+		{
+			ItemIndex.Remove(object);
+			return;
+		}
+
+		//the Object was nulled by the GC, so the Map entry can only be found by Index
+		for (auto it = ItemIndex.CreateIterator(); it; ++it)
+		{
+			if (it.Value() == ItemIdx)
+			{
+				it.RemoveCurrent();
+				return;
+			}
+		}
+	};
+
+	removeFromIndex(Index);
+
+	//found even if the Transformer is gone, as Weak Pointers are compared by their Object Index
+	const TWeakObjectPtr<UTransformerComponent> holderTransformer = Items[Index].HolderTransformer;
+	if (int32* heldLocks = HeldLocks.Find(holderTransformer))
+	{
+		if (--*heldLocks <= 0)
+			HeldLocks.Remove(holderTransformer);
+	}
+
+	const int32 lastIndex = Items.Num() - 1;
+	if (Index != lastIndex)
+	{
+		//the last Item is moved to the removed slot
+		removeFromIndex(lastIndex);
+		if (const UObject* movedObject = Items[lastIndex].Object)
+			ItemIndex.Add(movedObject, Index);
+	}
+
+	Items.RemoveAtSwap(Index, 1, false);
+	MarkArrayDirty();
+}
+
+ATransformerLockTable::ATransformerLockTable()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicatingMovement(false);
+}
+
+void ATransformerLockTable::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//Clients find the Table through the Subsystem once it replicates
+	if (UWorld* world = GetWorld())
+		if (UTransformerSubsystem* subsystem = world->GetSubsystem<UTransformerSubsystem>())
+			subsystem->RegisterLockTable(this);
+}
+
+void ATransformerLockTable::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* world = GetWorld())
+		if (UTransformerSubsystem* subsystem = world->GetSubsystem<UTransformerSubsystem>())
+			subsystem->UnregisterLockTable(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATransformerLockTable::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(ATransformerLockTable, Locks);
+}
@@ -0,0 +1,124 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformerStateBatch.h"
+
+//The order the Fields are applied in. Fields of the same Stage can be merged in any order
+static int32 GetFieldStage(uint8 Field)
+{
+	if (Field & FTransformerStateBatch::SB_DeselectAll) return 3;
+	if (Field & FTransformerStateBatch::SB_DeltaTransform) return 2;
+	if (Field & FTransformerStateBatch::SB_Domain) return 1;
+	return 0;
+}
+
+FTransformerStateBatch::FTransformerStateBatch()
+{
+	Fields = 0;
+	TransformationType = ETransformationType::TT_NoTransform;
+	SpaceType = ESpaceType::ST_None;
+	Domain = ETransformationDomain::TD_None;
+	bComponentBased = false;
+	bRotateOnLocalAxis = false;
+	bDestroySelected = false;
+	DeltaTransform = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+}
+
+bool FTransformerStateBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar.SerializeBits(&Fields, 7);
+
+	if (Has(SB_TransformationType))
+		Ar << TransformationType;
+	if (Has(SB_SpaceType))
+		Ar << SpaceType;
+	if (Has(SB_Domain))
+		Ar << Domain;
+
+	uint8 flags = (bComponentBased ? 1 : 0) | (bRotateOnLocalAxis ? 2 : 0) | (bDestroySelected ? 4 : 0);
+	if (Has(SB_ComponentBased) || Has(SB_RotateOnLocalAxis) || Has(SB_DeselectAll))
+		Ar.SerializeBits(&flags, 3);
+	bComponentBased = !!(flags & 1);
+	bRotateOnLocalAxis = !!(flags & 2);
+	bDestroySelected = !!(flags & 4);
+
+	//full precision, as it's the final Transform rather than a preview
+	if (Has(SB_DeltaTransform))
+		Ar << DeltaTransform;
+
+	bOutSuccess = true;
+	return true;
+}
+
+bool FTransformerStateBatch::CanMerge(EField Field) const
+{
+	//a cleared Domain ends a Drag, which the receivers have to see even if another Domain follows right away
+	if (Field == SB_Domain && Has(SB_Domain) && Domain == ETransformationDomain::TD_None)
+		return false;
+
+	int32 lastStage = -1;
+	for (uint8 field = SB_TransformationType; field <= SB_DeselectAll; field <<= 1)
+	{
+		if (Fields & field)
+			lastStage = FMath::Max(lastStage, GetFieldStage(field));
+	}
+	return GetFieldStage(Field) >= lastStage;
+}
+
+void FTransformerStateBatch::SetTransformationType(ETransformationType Type)
+{
+	Fields |= SB_TransformationType;
+	TransformationType = Type;
+}
+
+void FTransformerStateBatch::SetSpaceType(ESpaceType Type)
+{
+	Fields |= SB_SpaceType;
+	SpaceType = Type;
+}
+
+void FTransformerStateBatch::SetComponentBased(bool bIsComponentBased)
+{
+	Fields |= SB_ComponentBased;
+	bComponentBased = bIsComponentBased;
+}
+
+void FTransformerStateBatch::SetRotateOnLocalAxis(bool bRotateLocalAxis)
+{
+	Fields |= SB_RotateOnLocalAxis;
+	bRotateOnLocalAxis = bRotateLocalAxis;
+}
+
+void FTransformerStateBatch::SetDomain(ETransformationDomain InDomain)
+{
+	Fields |= SB_Domain;
+	Domain = InDomain;
+}
+
+void FTransformerStateBatch::AddDeltaTransform(const FTransform& InDeltaTransform)
+{
+	Fields |= SB_DeltaTransform;
+	DeltaTransform = FTransform(
+		InDeltaTransform.GetRotation() * DeltaTransform.GetRotation(),
+		InDeltaTransform.GetLocation() + DeltaTransform.GetLocation(),
+		InDeltaTransform.GetScale3D() + DeltaTransform.GetScale3D());
+}
+
+void FTransformerStateBatch::DeselectAll(bool bInDestroySelected)
+{
+	if (Has(SB_DeselectAll)) return;
+
+	Fields |= SB_DeselectAll;
+	bDestroySelected = bInDestroySelected;
+}
+
+int32 FTransformerStateBatch::GetParameterSize() const
+{
+	int32 size = sizeof(Fields);
+	if (Has(SB_TransformationType)) size += sizeof(ETransformationType);
+	if (Has(SB_SpaceType)) size += sizeof(ESpaceType);
+	if (Has(SB_Domain)) size += sizeof(ETransformationDomain);
+	if (Has(SB_ComponentBased) || Has(SB_RotateOnLocalAxis) || Has(SB_DeselectAll)) size += sizeof(uint8);
+	if (Has(SB_DeltaTransform)) size += sizeof(FTransform);
+	return size;
+}
@@ -0,0 +1,137 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformerSubsystem.h"
+#include "TransformerLockTable.h"
+#include "TransformerComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarMaxAsyncServerTracesPerFrame(
+	TEXT("RuntimeTransformer.MaxAsyncServerTracesPerFrame"),
+	8,
+	TEXT("Max amount of Async Server Traces submitted per frame, over all the Transformers of the World.\n")
+	TEXT("The rest wait for the next frames."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarObserverInterestInterval(
+	TEXT("RuntimeTransformer.ObserverInterestInterval"),
+	0.5f,
+	TEXT("Seconds between the Server finding which Transformers are interested in each other\n")
+	TEXT("(so Players that become interested get a catch-up at most this late)."),
+	ECVF_Default);
+
+ATransformerLockTable* UTransformerSubsystem::GetLockTable(bool bSpawnIfMissing)
+{
+	if (IsValid(LockTable))
+		return LockTable;
+
+	UWorld* world = GetWorld();
+	if (!bSpawnIfMissing || !world || world->GetNetMode() == NM_Client)
+		return nullptr;
+
+	FActorSpawnParameters spawnParams;
+	spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	LockTable = world->SpawnActor<ATransformerLockTable>(spawnParams);
+	return LockTable;
+}
+
+void UTransformerSubsystem::RegisterLockTable(ATransformerLockTable* Table)
+{
+	LockTable = Table;
+}
+
+void UTransformerSubsystem::UnregisterLockTable(ATransformerLockTable* Table)
+{
+	if (LockTable == Table)
+		LockTable = nullptr;
+}
+
+void UTransformerSubsystem::QueueServerTrace(UTransformerComponent* Transformer)
+{
+	if (Transformer)
+		QueuedServerTraces.AddUnique(Transformer);
+}
+
+void UTransformerSubsystem::QueueStateBatchFlush(UTransformerComponent* Transformer)
+{
+	if (Transformer)
+		QueuedStateBatchFlushes.AddUnique(Transformer);
+}
+
+void UTransformerSubsystem::RegisterTransformer(UTransformerComponent* Transformer)
+{
+	if (Transformer)
+		ObservingTransformers.AddUnique(Transformer);
+	//so the new Transformer finds (and gets found by) the others right away
+	LastObserverInterestTime = -1.f;
+}
+
+void UTransformerSubsystem::UnregisterTransformer(UTransformerComponent* Transformer)
+{
+	ObservingTransformers.RemoveSwap(Transformer);
+}
+
+void UTransformerSubsystem::Deinitialize()
+{
+	QueuedServerTraces.Empty();
+	QueuedStateBatchFlushes.Empty();
+	ObservingTransformers.Empty();
+	Super::Deinitialize();
+}
+
+void UTransformerSubsystem::Tick(float DeltaTime)
+{
+	const int32 count = FMath::Min(QueuedServerTraces.Num()
+	                               , FMath::Max(CVarMaxAsyncServerTracesPerFrame.GetValueOnGameThread(), 1));
+
+	//removed first, as submitting may queue a Transformer again
+	TArray<TWeakObjectPtr<UTransformerComponent>> transformers(QueuedServerTraces.GetData(), count);
+	QueuedServerTraces.RemoveAt(0, count, false);
+
+	for (const TWeakObjectPtr<UTransformerComponent>& transformer : transformers)
+	{
+		if (transformer.IsValid())
+			transformer->SubmitPendingServerTrace();
+	}
+
+	//the Transformers still over Budget queue themselves again
+	TArray<TWeakObjectPtr<UTransformerComponent>> flushes = MoveTemp(QueuedStateBatchFlushes);
+	QueuedStateBatchFlushes.Reset();
+	for (const TWeakObjectPtr<UTransformerComponent>& transformer : flushes)
+	{
+		if (transformer.IsValid())
+			transformer->FlushServerStateBatches(false);
+	}
+
+	if (ObservingTransformers.Num() > 0)
+	{
+		ObservingTransformers.RemoveAllSwap([](const TWeakObjectPtr<UTransformerComponent>& Transformer)
+		{
+			return !Transformer.IsValid();
+		});
+
+		const float time = GetWorld()->GetTimeSeconds();
+		const bool bUpdateInterest = LastObserverInterestTime < 0.f
+			|| time - LastObserverInterestTime >= CVarObserverInterestInterval.GetValueOnGameThread();
+		if (bUpdateInterest)
+			LastObserverInterestTime = time;
+
+		for (const TWeakObjectPtr<UTransformerComponent>& transformer : ObservingTransformers)
+		{
+			if (transformer.IsValid())
+				transformer->UpdateObservers(ObservingTransformers, bUpdateInterest);
+		}
+	}
+}
+
+bool UTransformerSubsystem::IsTickable() const
+{
+	return !IsTemplate() && (QueuedServerTraces.Num() > 0 || QueuedStateBatchFlushes.Num() > 0
+	                         || ObservingTransformers.Num() > 0);
+}
+
+TStatId UTransformerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTransformerSubsystem, STATGROUP_Tickables);
+}
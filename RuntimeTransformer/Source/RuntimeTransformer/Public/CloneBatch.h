@@ -0,0 +1,82 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CloneBatch.generated.h"
+
+/**
+ * A list of Actors being Cloned together. The Clones are spawned deferred in chunks
+ * (spawn every Clone in the chunk, attach them, then finish spawning them) so a big Batch can be
+ * spread over several frames.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FCloneBatch
+{
+	GENERATED_BODY()
+
+public:
+
+	FCloneBatch();
+
+	/**
+	 * Sets the Actors to Clone (nulls & duplicates are dropped) sorted Parent-first,
+	 * so a Clone is always spawned after the Clone of the Actor it is attached to (if any).
+	 */
+	void Init(const TArray<AActor*>& Actors, bool bInSelectNewClones, bool bInAppendToList);
+
+	/**
+	 * Sets Actors to Spawn from their Class at the given World Transforms, rather than Cloned from a Template
+	 * (e.g. the ones of an Imported Layout that were not found). They are not attached to anything.
+	 */
+	void InitSpawns(const TArray<UClass*>& Classes, const TArray<FTransform>& Transforms
+	                , bool bInSelectNewClones, bool bInAppendToList);
+
+	void Reset();
+
+	//Whether the Batch has been Initialized and hasn't been Reset yet
+	bool IsActive() const { return bActive; }
+
+	//Whether all the Templates have been processed
+	bool IsDone() const { return NextTemplate >= Templates.Num(); }
+
+	int32 Num() const { return Templates.Num(); }
+
+	//Whether the Batch Spawns from Classes rather than Cloning Templates. @see InitSpawns
+	bool IsSpawnBatch() const { return SpawnClasses.Num() > 0; }
+
+	//The Index of the Template, or INDEX_NONE if it's not part of the Batch
+	int32 FindTemplate(const AActor* Template) const;
+
+	//The Root Components of the Clones that were spawned successfully, in Template order
+	TArray<class USceneComponent*> GetCloneRoots() const;
+
+	//Actors to Clone, Parent-first
+	UPROPERTY()
+	TArray<AActor*> Templates;
+
+	//Clone of each Template (nullptr if not spawned yet or it failed)
+	UPROPERTY()
+	TArray<AActor*> Clones;
+
+	//Class and World Transform of each Actor to Spawn (Spawn Batches only, with no Templates)
+	UPROPERTY()
+	TArray<UClass*> SpawnClasses;
+
+	TArray<FTransform> SpawnTransforms;
+
+	//Index of the next Template to Clone
+	int32 NextTemplate;
+
+	//Running average of the time it takes to Clone an Actor (seconds), used to size the chunks
+	double AverageCloneTime;
+
+	bool bSelectNewClones;
+	bool bAppendToList;
+
+private:
+
+	TMap<const AActor*, int32> TemplateIndex;
+
+	bool bActive;
+};
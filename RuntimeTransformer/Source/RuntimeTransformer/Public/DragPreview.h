@@ -0,0 +1,47 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+/**
+ * The Components being Previewed while a Drag is in progress (from the Domain being hit until it's cleared).
+ * They (and their children) have their Collision and Overlap Events turned off, and are moved without their
+ * Physics Bodies: only the Component and Render Transforms are updated, so physics-heavy Objects don't get their
+ * Bodies teleported and their Overlaps updated every frame of the Drag.
+ * At the Drop, the Collision is restored and every Previewed Primitive (children included) gets its Body
+ * Teleported once and a single Overlap Update.
+ * Components Simulating Physics are not Previewed, as their Bodies drive their Transforms.
+ */
+class RUNTIMETRANSFORMER_API FDragPreview
+{
+public:
+
+	//Starts Previewing the Components. The ones already Previewed or Simulating Physics are skipped
+	void Begin(const TArray<class USceneComponent*>& Components);
+
+	//Restores the Collision and Teleports the Bodies of the Previewed Components to where they ended up
+	void End();
+
+	bool IsActive() const { return Components.Num() > 0; }
+
+	bool Contains(class USceneComponent* Component) const { return Components.Contains(Component); }
+
+	//Moves the Component (and its children) without their Physics Bodies and without updating their Overlaps
+	static void MoveComponent(class USceneComponent* Component, const FTransform& WorldTransform);
+
+private:
+
+	//What the Preview changed in a Primitive, to restore it at the End
+	struct FPrimitiveState
+	{
+		TWeakObjectPtr<class UPrimitiveComponent> Primitive;
+		TEnumAsByte<ECollisionEnabled::Type> CollisionEnabled;
+		bool bGenerateOverlapEvents;
+	};
+
+	TSet<TWeakObjectPtr<class USceneComponent>> Components;
+
+	TArray<FPrimitiveState> Primitives;
+};
@@ -35,4 +35,23 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "Focusable")
 	void OnNewTransformation(class UTransformerComponent* Caller, class USceneComponent* Component, const FTransform& NewTransform, bool bComponentBased);
 
+	/**
+	 * Batched version of OnNewTransformation: called once per Transform with all the Components of this Focusable Object
+	 * that were transformed (Components[i] gets Transforms[i]).
+	 * It's only called if it's implemented in Blueprint, otherwise OnNewTransformation is called for each Component.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "Focusable")
+	void OnNewTransformations(class UTransformerComponent* Caller, const TArray<class USceneComponent*>& Components, const TArray<FTransform>& Transforms, bool bComponentBased);
+
+	/*
+	 * C++ fast paths, called directly (no Reflection) before the Blueprint Events.
+	 * Return true if handled, so the matching Blueprint Event is not called.
+	 */
+
+	virtual bool NativeFocus(class UTransformerComponent* Caller, class USceneComponent* Component, bool bComponentBased) { return false; }
+
+	virtual bool NativeUnfocus(class UTransformerComponent* Caller, class USceneComponent* Component, bool bComponentBased) { return false; }
+
+	virtual bool NativeOnNewTransformations(class UTransformerComponent* Caller, TArrayView<class USceneComponent* const> Components, TArrayView<const FTransform> Transforms, bool bComponentBased) { return false; }
+
 };
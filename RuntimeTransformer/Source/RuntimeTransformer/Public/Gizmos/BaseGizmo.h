@@ -18,12 +18,17 @@ public:
 	// Sets default values for this actor's properties
 	ABaseGizmo();
 
+	virtual void PostInitializeComponents() override;
+
 	virtual void Tick(float DeltaSeconds) override;
 
 	virtual ETransformationType GetGizmoType() const { return ETransformationType::TT_NoTransform; }
 
 	virtual void UpdateGizmoSpace(ESpaceType SpaceType);
 
+	//The Space the Gizmo ends up in for the given Space (e.g. the Scale Gizmo is always Local)
+	virtual ESpaceType GetEffectiveSpace(ESpaceType SpaceType) const { return SpaceType; }
+
 	//Base Gizmo does not affect anything and returns No Delta Transform.
 	// This func is overriden by each Transform Gizmo
 	virtual FTransform GetDeltaTransform(const FVector& LookingVector, const FVector& RayStartPoint
@@ -39,9 +44,38 @@ public:
 	*/
 	void ScaleGizmoScene(const FVector& ReferenceLocation, const FVector& ReferenceLookDirection, float FieldOfView = 90.f);
 
+	/**
+	 * The Scale of the Gizmo Scene for the Gizmo to keep its Screen Size in a View.
+	 * The same formula is used for Scaling the Gizmo Scene, by the Gizmo Renderer (for each View)
+	 * and for Picking, so they all agree.
+	 */
+	static float ComputeViewScale(const FVector& GizmoLocation, const FVector& ViewLocation
+		, const FVector& ViewDirection, float FieldOfView, float ScaleFactor, float ArcRadius);
+
 	UFUNCTION(BlueprintCallable, Category = "Gizmo")
 	ETransformationDomain GetTransformationDomain(class USceneComponent* ComponentHit) const;
 
+	/**
+	 * Analytically intersects a Ray with the registered Domain Shapes (Boxes & Spheres)
+	 * without going through the Physics Scene, so the Gizmo does not need collision to be picked.
+	 * @param RayOrigin - the origin of the Ray, in World Space
+	 * @param RayDirection - the direction of the Ray, in World Space (normalized)
+	 * @param outDistance - the distance from the Ray Origin to the closest hit
+	 * @return the Domain of the closest Shape hit, or TD_None if nothing was hit
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Gizmo")
+	virtual ETransformationDomain PickDomain(const FVector& RayOrigin, const FVector& RayDirection
+		, float& outDistance) const;
+
+	/**
+	 * Picks the Domain of a Gizmo that is not spawned (e.g. the Class Default Object), as if it was placed
+	 * at the Gizmo Transform (no Scale) and scaled for the View the Ray comes from.
+	 * Uses the Render Shapes, so it works without the Shapes being registered.
+	 * @see PickDomain
+	*/
+	ETransformationDomain PickDomainAt(const FTransform& GizmoTransform, const FVector& RayOrigin
+		, const FVector& RayDirection, float& outDistance) const;
+
 	// Returns a Snapped Transform based on how much has been accumulated, the Delta Transform and Snapping Value
 	// Also changes the Accumulated Transform based on how much was snapped
 	virtual FTransform GetSnappedTransform(FTransform& outCurrentAccumulatedTransform
@@ -70,6 +104,34 @@ protected:
 	//should be called at the end of the GetDeltaTransformation Implemenation
 	void UpdateRays(const FVector& RayStart, const FVector& RayEnd);
 
+	/**
+	 * The Ray to intersect the Domain Shapes with. With Constant Screen Size the Shapes keep their unscaled size,
+	 * so the Ray Origin is moved (scaled down around the Gizmo) instead, by the View Scale of the Ray.
+	 * If the Axes are Mirrored to the View, the Ray is mirrored the same way (around the Gizmo), to match the Renderer.
+	 * @param outScale - what the distances along the returned Ray have to be multiplied by to be World distances
+	 */
+	void GetPickRay(const FVector& RayOrigin, const FVector& RayDirection, FVector& outOrigin
+		, FVector& outDirection, float& outScale) const;
+
+	//Ray vs Box Component (oriented box, in the Box local space). outDistance is along the World Ray
+	static bool IntersectRayBox(const class UBoxComponent* Box, const FVector& RayOrigin
+		, const FVector& RayDirection, float& outDistance);
+
+	//Ray vs a Box of the given (unscaled) Extent placed at the Box Transform
+	static bool IntersectRayBox(const FTransform& BoxTransform, const FVector& Extent, const FVector& RayOrigin
+		, const FVector& RayDirection, float& outDistance);
+
+	//Ray vs Sphere Component. outDistance is along the World Ray
+	static bool IntersectRaySphere(const class USphereComponent* Sphere, const FVector& RayOrigin
+		, const FVector& RayDirection, float& outDistance);
+
+	static bool IntersectRaySphere(const FVector& Center, float Radius, const FVector& RayOrigin
+		, const FVector& RayDirection, float& outDistance);
+
+	//Ray vs a Ring lying on the plane perpendicular to the X Axis of the Ring Transform
+	static bool IntersectRayRing(const FTransform& RingTransform, float Radius, float Thickness
+		, const FVector& RayOrigin, const FVector& RayDirection, float& outDistance);
+
 	/**
 	 * Adds or modifies an entry to the DomainMap.
 	*/
@@ -77,6 +139,12 @@ protected:
 	void RegisterDomainComponent(class USceneComponent* Component
 		, ETransformationDomain Domain);
 
+	/**
+	 * The Handles the Gizmo Renderer draws, in Scaling Scene space.
+	 * By default, a Box or Sphere for each registered Domain Shape. Can be overriden (e.g. by Rotation Gizmo).
+	*/
+	virtual void GetRenderShapes(TArray<struct FGizmoRenderShape>& outShapes) const;
+
 public:
 
 	UFUNCTION(BlueprintCallable, Category = "Gizmo")
@@ -86,6 +154,23 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gizmo")
 	bool GetTransformProgressState() const { return bTransformInProgress; }
 
+	/**
+	 * Activates / Deactivates the Gizmo.
+	 * A deactivated Gizmo is hidden, has no collision and does not tick,
+	 * so that it can be kept (pooled) and reused instead of being destroyed and spawned again.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Gizmo")
+	virtual void SetGizmoActive(bool bActive);
+
+	UFUNCTION(BlueprintCallable, Category = "Gizmo")
+	bool IsGizmoActive() const { return bGizmoActive; }
+
+	/**
+	 * Should be called after the Gizmo has been attached to a new Component.
+	 * Enables the Tick so that the attachment is fixed up in the next frame.
+	 */
+	void NotifyAttachmentChanged();
+
 	/**
 	 * Delegate that is called when the Transform State is changed (when it changes from
 	 * in progress = true to false (and viceversa)
@@ -117,6 +202,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Gizmo")
 	class UBoxComponent* Z_AxisBox;
 
+	// Draws all the Handles in a single Primitive. Only created (once the Components are initialized) if Use Gizmo Renderer is set
+	UPROPERTY(VisibleAnywhere, Transient, BlueprintReadOnly, Category = "Gizmo")
+	class UGizmoRenderComponent* GizmoRenderer;
+
 	// Used to calculate the distance the rays have travelled
 	FVector PreviousRayStartPoint;
 	FVector PreviousRayEndPoint;
@@ -128,6 +217,42 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gizmo")
 	float CameraArcRadius;
 
+	/**
+	 * Whether the Gizmo should Tick every frame while active.
+	 * If false, the Gizmo only Ticks right after being attached (to fix up the attachment)
+	 * and then disables its Tick, so that an idle Gizmo costs nothing.
+	 * Enable this if a child Blueprint relies on the Tick event.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gizmo")
+	bool bAlwaysTick;
+
+	/**
+	 * Whether the Handles are drawn by the Gizmo Renderer (one Primitive for the whole Gizmo)
+	 * rather than by Mesh Components added to each Handle.
+	 * The Domain being Transformed is Highlighted. The Domain Shapes are still used for picking.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gizmo")
+	bool bUseGizmoRenderer;
+
+	//The Class of the Gizmo Renderer (e.g. a Blueprint with other Colors or Material)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gizmo", meta = (EditCondition = "bUseGizmoRenderer"))
+	TSubclassOf<class UGizmoRenderComponent> GizmoRendererClass;
+
+	/**
+	 * Only with the Gizmo Renderer. Whether the Renderer scales the Gizmo for each View as it draws it,
+	 * so that it keeps the same size on screen in every View (e.g. Split-Screen) without the Scaling Scene
+	 * (and every Handle under it) being rescaled as the Camera moves.
+	 * Picking applies the same scale, from the View the Ray comes from.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gizmo", meta = (EditCondition = "bUseGizmoRenderer"))
+	bool bConstantScreenSize;
+
+	//With Constant Screen Size, the Field of View assumed when Picking (the last one the Gizmo was scaled for)
+	float ViewFieldOfView;
+
+	//Whether the Axes are flipped to face the View (e.g. the Rotation Gizmo). Used by the Gizmo Renderer
+	bool bMirrorAxesToView;
+
 private:
 	// Maps the Box Component to their Respective Domain
 	TMap<class UShapeComponent*, ETransformationDomain> DomainMap;
@@ -135,6 +260,12 @@ private:
 	//Whether Transform is in Progress or Not 
 	bool bTransformInProgress;
 
+	//Whether the Gizmo is currently in use (visible, with collision and ticking)
+	bool bGizmoActive;
+
+	//Whether the Root Scene needs to be re-attached in the next Tick
+	bool bAttachmentDirty;
+
 protected:
 
 	//bool to check whether the PrevRay vectors have been set
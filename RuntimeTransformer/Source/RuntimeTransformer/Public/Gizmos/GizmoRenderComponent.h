@@ -0,0 +1,125 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "RuntimeTransformer.h"
+#include "GizmoRenderComponent.generated.h"
+
+//A Handle of a Gizmo, in the space of the Gizmo Render Component
+struct FGizmoRenderShape
+{
+	enum class EType : uint8
+	{
+		Box,
+		Sphere,
+		//lies on the plane perpendicular to the X Axis of the Transform
+		Ring,
+	};
+
+	EType Type = EType::Box;
+
+	ETransformationDomain Domain = ETransformationDomain::TD_None;
+
+	FTransform Transform;
+
+	//Box: the Half Extent. Sphere: X is the Radius. Ring: X is the Radius, Y the Thickness
+	FVector Size = FVector::ZeroVector;
+};
+
+/**
+ * Draws all the Handles of a Gizmo as a single Primitive: one Scene Proxy submitting one Mesh Batch,
+ * instead of a Primitive (with its own draw calls and transform updates) per Handle.
+ * The Mesh is built and uploaded once, when the Shapes are set. Highlighting a Domain only recolors it
+ * in the Render Thread.
+ * Has no collision: the Gizmo is picked with its Domain Shapes (@see ABaseGizmo::PickDomain).
+ *
+ * With View Scaling, the Proxy scales the Mesh for each View as it submits it (@see ABaseGizmo::ComputeViewScale),
+ * so nothing has to be rescaled in the Game Thread when the Camera moves, and every View gets its own size.
+ */
+UCLASS(ClassGroup = (RuntimeTransformer), meta = (BlueprintSpawnableComponent))
+class RUNTIMETRANSFORMER_API UGizmoRenderComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UGizmoRenderComponent();
+
+	//Sets the Handles to draw, recreating the Scene Proxy. Nothing is drawn while there are none
+	void SetShapes(TArray<FGizmoRenderShape>&& InShapes);
+
+	//Draws the Handles of the Domain with the Highlight Color. TD_None to highlight nothing
+	UFUNCTION(BlueprintCallable, Category = "Gizmo")
+	void SetHighlightedDomain(ETransformationDomain Domain);
+
+	UFUNCTION(BlueprintCallable, Category = "Gizmo")
+	ETransformationDomain GetHighlightedDomain() const { return HighlightedDomain; }
+
+	/**
+	 * Sets whether the Mesh is scaled for each View to keep its Screen Size, recreating the Scene Proxy.
+	 * @param bMirrorAxes - whether each Axis is also flipped towards the View
+	 */
+	void SetViewScaling(bool bEnabled, float ScaleFactor, float ArcRadius, bool bMirrorAxes);
+
+	/**
+	 * With Mirrored Axes, makes every View use the given Mirror (e.g. while Transforming, so the Axes don't flip
+	 * under the cursor) rather than its own.
+	 */
+	void SetFrozenMirror(bool bFrozen, const FVector& Mirror);
+
+	//The Color the Handles of the Domain are drawn with (Planes mix the Colors of their Axes)
+	FLinearColor GetDomainColor(ETransformationDomain Domain) const;
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual void GetUsedMaterials(TArray<class UMaterialInterface*>& OutMaterials
+	                              , bool bGetDebugMaterials = false) const override;
+	//~ End UPrimitiveComponent Interface
+
+	//~ Begin USceneComponent Interface
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End USceneComponent Interface
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	FLinearColor XColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	FLinearColor YColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	FLinearColor ZColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	FLinearColor XYZColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	FLinearColor HighlightColor;
+
+	//Material of the Handles, tinted by the Vertex Color. If not set, the Engine's Vertex Color Material is used
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo")
+	class UMaterialInterface* HandleMaterial;
+
+	//Segments of the Spheres and Rings
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (ClampMin = "4"))
+	int32 CircleSegments;
+
+private:
+
+	friend class FGizmoRenderSceneProxy;
+
+	class UMaterialInterface* GetHandleMaterial() const;
+
+	TArray<FGizmoRenderShape> Shapes;
+
+	ETransformationDomain HighlightedDomain;
+
+	bool bViewScaling;
+	float ViewScaleFactor;
+	float ViewArcRadius;
+	bool bMirrorAxesToView;
+
+	bool bMirrorFrozen;
+	FVector FrozenMirror;
+};
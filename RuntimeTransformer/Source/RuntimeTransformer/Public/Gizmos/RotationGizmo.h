@@ -26,6 +26,14 @@ public:
 		, ETransformationDomain Domain
 		, float SnappingValue) const override;
 
+	/**
+	 * If a Ring Radius is set, picks the Domain by intersecting the Ray with a Ring per Axis
+	 * (lying on the plane perpendicular to the Axis, in Scaling Scene space).
+	 * Otherwise the registered Domain Shapes are used.
+	*/
+	virtual ETransformationDomain PickDomain(const FVector& RayOrigin, const FVector& RayDirection
+		, float& outDistance) const override;
+
 protected:
 
 	//Rotation has a special way of Handling the Scene Scaling and that is, that its AXis need to face the Camera as well!
@@ -37,6 +45,17 @@ protected:
 		, const FVector& RayEndPoint
 		,  ETransformationDomain Domain) override;
 
+	//If a Ring Radius is set, the Renderer draws the Rings that are picked. Otherwise the registered Domain Shapes
+	virtual void GetRenderShapes(TArray<struct FGizmoRenderShape>& outShapes) const override;
+
+	//Radius of the Rings (in Scaling Scene space) used for picking. If 0, the registered Domain Shapes are used instead.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gizmo")
+	float RingPickRadius;
+
+	//Thickness of the Rings (in Scaling Scene space) used for picking.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Gizmo")
+	float RingPickThickness;
+
 private:
 
 	FVector PreviousRotationViewScale;
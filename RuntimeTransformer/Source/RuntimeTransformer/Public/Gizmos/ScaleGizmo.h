@@ -22,6 +22,9 @@ public:
 
 	virtual void UpdateGizmoSpace(ESpaceType SpaceType);
 
+	//Always Local
+	virtual ESpaceType GetEffectiveSpace(ESpaceType SpaceType) const override { return ESpaceType::ST_Local; }
+
 	virtual FTransform GetDeltaTransform(const FVector& LookingVector
 		, const FVector& RayStartPoint
 		, const FVector& RayEndPoint
@@ -0,0 +1,62 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Compact Set of the Selected Instances of an Instanced Static Mesh Component.
+ * Stored as a Bit Array indexed by Instance Index, so Add / Remove / Contains are O(1)
+ * and the Instances are iterated in ascending order (which lets contiguous runs be updated in a batch).
+ */
+class RUNTIMETRANSFORMER_API FInstanceSet
+{
+public:
+
+	FInstanceSet();
+
+	//Returns false if the Instance was already in the Set
+	bool Add(int32 Instance);
+
+	//Returns false if the Instance was not in the Set
+	bool Remove(int32 Instance);
+
+	//Moves the Instance to its new Index (e.g. after its Component reordered its Instances), if it was in the Set
+	void Relocate(int32 OldInstance, int32 NewInstance);
+
+	bool Contains(int32 Instance) const;
+
+	void Empty();
+
+	int32 Num() const { return Count; }
+
+	bool IsEmpty() const { return Count == 0; }
+
+	//The Instance that was added last (INDEX_NONE if it was removed or the Set is empty)
+	int32 GetLastAdded() const { return LastAdded; }
+
+	//The lowest Instance in the Set (INDEX_NONE if empty)
+	int32 First() const { return Bits.Find(true); }
+
+	//Gets the Instances in ascending order
+	void GetInstances(TArray<int32>& outInstances) const;
+
+private:
+
+	TBitArray<> Bits;
+
+	int32 Count;
+
+	int32 LastAdded;
+};
+
+//World Transforms of the Selected Instances of a Component, as they were when a Drag started. @see FTransformSnapshot
+struct FInstanceSnapshot
+{
+	TWeakObjectPtr<class UInstancedStaticMeshComponent> Component;
+
+	//in ascending order, so contiguous runs can be updated in a batch
+	TArray<int32> Instances;
+
+	TArray<FTransform> Transforms;
+};
@@ -0,0 +1,100 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class FBufferReader;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+//One Object of a Layout: where to find it, what to Spawn if it's not there, and its World Transform
+struct RUNTIMETRANSFORMER_API FLayoutEntry
+{
+	//Path of the Component (the Actor Root, unless Component Based), without any PIE prefix
+	FSoftObjectPath Path;
+
+	//Class of the Actor to Spawn if the Path can't be found. Only set for Actors Spawned at runtime (e.g. Clones)
+	FSoftClassPath ActorClass;
+
+	FTransform Transform;
+};
+
+/**
+ * Writes Layouts as a compact, Versioned binary blob:
+ * - Header: Magic, Version
+ * - String Table: every Asset Path (i.e. Level) and Class, stored once
+ * - Entries: Flags, the String index of their Asset Path (and Class), their Sub Path and their Quantized Transform.
+ *   Location at 0.01 units and Scale at 0.001 as Packed Zig-Zag integers (so small values take a byte or two),
+ *   Rotation as the 4 components of the Quaternion in 16 bits each. A unit Scale is not stored.
+ */
+struct RUNTIMETRANSFORMER_API FLayoutWriter
+{
+	static void Write(const TArray<FLayoutEntry>& Entries, TArray<uint8>& outData);
+};
+
+/**
+ * Reads a Layout straight from the given memory (which must outlive it), one Entry at a time,
+ * so a big Layout can be read over several frames.
+ */
+class RUNTIMETRANSFORMER_API FLayoutReader
+{
+public:
+
+	FLayoutReader();
+	~FLayoutReader();
+
+	//Reads the Header and the String Table. Returns false if it's not a Layout (or of a newer Version)
+	bool Open(const uint8* Data, int64 Size);
+
+	//Reads the next Entry. Returns false once all have been read, or if the Data is corrupt
+	bool ReadEntry(FLayoutEntry& outEntry);
+
+	bool IsDone() const { return EntriesRead >= NumEntries; }
+
+	bool IsError() const;
+
+	int32 Num() const { return NumEntries; }
+
+	int32 NumRead() const { return EntriesRead; }
+
+private:
+
+	TUniquePtr<FBufferReader> Reader;
+
+	TArray<FString> Strings;
+
+	int32 NumEntries;
+	int32 EntriesRead;
+	bool bError;
+};
+
+/**
+ * A Layout being Imported: its Reader, the memory it reads from (a loaded array or a Mapped File)
+ * and what has been gathered so far.
+ */
+struct RUNTIMETRANSFORMER_API FLayoutImport
+{
+	FLayoutImport();
+	~FLayoutImport();
+
+	bool OpenData(TArray<uint8>&& InData);
+
+	//Maps the File if the Platform supports it, otherwise it's loaded whole
+	bool OpenFile(const FString& FilePath);
+
+	TArray<uint8> Data;
+
+	//the Region is declared after the File, so it's released first
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	FLayoutReader Reader;
+
+	//Entries that were not found and have a Class to Spawn them from, once the whole Layout has been read
+	TArray<FSoftClassPath> SpawnClasses;
+	TArray<FTransform> SpawnTransforms;
+
+	int32 NumPlaced;
+};
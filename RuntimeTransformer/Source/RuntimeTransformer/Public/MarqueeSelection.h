@@ -0,0 +1,93 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ConvexVolume.h"
+#include "CollisionQueryParams.h"
+#include "MarqueeSelection.generated.h"
+
+UENUM()
+enum class EMarqueeQueryType : uint8
+{
+	MQ_ObjectTypes,
+	MQ_Channel,
+	MQ_Profile,
+};
+
+/**
+ * The Frustum that goes from the Camera through a Rectangle of the Screen.
+ * Besides the Convex Volume (used for the narrow phase), it keeps an Oriented Box that encloses it,
+ * which is the Shape used for the broad phase Overlap Query.
+ */
+struct RUNTIMETRANSFORMER_API FMarqueeFrustum
+{
+	/**
+	 * Builds the Frustum from two opposite corners of the Rectangle (in Viewport pixels).
+	 * @param ViewRect - the Rect of the View in the Viewport
+	 * @param ViewProjectionMatrix - the View Projection Matrix of the View (perspective or orthographic)
+	 * @param Distance - how far from the Camera the Frustum reaches
+	 * @return false if the Rectangle is degenerate (zero width or height)
+	 */
+	bool Build(const FVector2D& CornerA, const FVector2D& CornerB
+	           , const FIntRect& ViewRect, const FMatrix& ViewProjectionMatrix, float Distance);
+
+	/**
+	 * Whether the Bounds are in the Frustum.
+	 * If bFullyInside, the Bounds (projected to the Screen) must also be entirely inside the Rectangle.
+	 * Only reads, so it's safe to call from several threads at once.
+	 */
+	bool IsInside(const FBoxSphereBounds& Bounds, bool bFullyInside) const;
+
+	//Faces point outwards
+	FConvexVolume Volume;
+
+	//Box that encloses the Frustum, oriented with the Camera
+	FVector BoxCenter = FVector::ZeroVector;
+	FVector BoxExtent = FVector::ZeroVector;
+	FQuat BoxRotation = FQuat::Identity;
+
+private:
+
+	FIntRect ViewRect;
+	FMatrix ViewProjectionMatrix;
+	FVector2D RectMin = FVector2D::ZeroVector;
+	FVector2D RectMax = FVector2D::ZeroVector;
+};
+
+/**
+ * State of a Marquee (Rectangle) Selection that is being dragged.
+ * Keeps track of the Components the Marquee itself selected, so every Update only
+ * selects / deselects the difference with the previous one.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FMarqueeSelection
+{
+	GENERATED_BODY()
+
+public:
+
+	FMarqueeSelection();
+
+	void Reset();
+
+	bool bActive;
+
+	//Screen Position where the Marquee started (Viewport pixels)
+	FVector2D ScreenStart;
+
+	float Distance;
+
+	EMarqueeQueryType QueryType;
+
+	FCollisionObjectQueryParams ObjectQueryParams;
+	TEnumAsByte<ECollisionChannel> TraceChannel;
+	FName ProfileName;
+
+	UPROPERTY()
+	TArray<AActor*> IgnoredActors;
+
+	//The Components currently Selected by the Marquee (not the ones that were already Selected when it started)
+	UPROPERTY()
+	TSet<class USceneComponent*> MarqueeSelected;
+};
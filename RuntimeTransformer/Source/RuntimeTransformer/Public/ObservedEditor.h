@@ -0,0 +1,95 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeTransformer.h"
+#include "ObservedEditor.generated.h"
+
+/**
+ * What another Player (an Editor) is doing with their Transformer, as seen by an Observer.
+ * Kept up to date with FObservedEditorUpdates.
+ * @see UTransformerComponent::bReplicateToObservers
+ */
+USTRUCT(BlueprintType)
+struct RUNTIMETRANSFORMER_API FObservedEditorState
+{
+	GENERATED_BODY()
+
+public:
+
+	FObservedEditorState();
+
+	//The Player doing the Editing
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer")
+	class APlayerState* Editor;
+
+	//The Components the Editor has Selected (only the ones resolvable in this Client)
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer")
+	TArray<class USceneComponent*> Components;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer")
+	ETransformationType TransformationType;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer")
+	ESpaceType SpaceType;
+
+	//TD_None unless the Editor is Transforming
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer")
+	ETransformationDomain Domain;
+};
+
+/**
+ * A change of an Editor's State, sent by the Server only to the Observers the Editor is of interest to:
+ * the whole Selection as a catch-up once they become interested (Reset), and afterwards (at most once per frame)
+ * only the Components that were Selected and Deselected since.
+ * Big changes are split over several Updates. The enums are packed into a single byte when Net Serialized.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FObservedEditorUpdate
+{
+	GENERATED_BODY()
+
+public:
+
+	FObservedEditorUpdate();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	//Applies the Update to what the Observer knows of the Editor
+	void ApplyTo(FObservedEditorState& outState) const;
+
+	//Approximate size of the RPC Parameter, for the stats
+	int32 GetParameterSize() const;
+
+	UPROPERTY()
+	class APlayerState* Editor;
+
+	//Whether the Added Components replace the known Selection (a catch-up) rather than add to it
+	UPROPERTY()
+	bool bReset;
+
+	UPROPERTY()
+	TArray<class USceneComponent*> AddedComponents;
+
+	UPROPERTY()
+	TArray<class USceneComponent*> RemovedComponents;
+
+	UPROPERTY()
+	ETransformationType TransformationType;
+
+	UPROPERTY()
+	ESpaceType SpaceType;
+
+	UPROPERTY()
+	ETransformationDomain Domain;
+};
+
+template<>
+struct TStructOpsTypeTraits<FObservedEditorUpdate> : public TStructOpsTypeTraitsBase2<FObservedEditorUpdate>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
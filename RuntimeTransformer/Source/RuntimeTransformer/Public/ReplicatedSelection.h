@@ -0,0 +1,99 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "ReplicatedSelection.generated.h"
+
+/**
+ * A Selected Component in the Replicated Selection List.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FReplicatedSelectionItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	FReplicatedSelectionItem();
+
+	UPROPERTY()
+	class USceneComponent* Component;
+
+	/**
+	 * Client only. The Component that was Selected because of this Item.
+	 * Differs from Component while the Component reference is not resolvable yet (i.e. it's nullptr)
+	 */
+	UPROPERTY(NotReplicated)
+	class USceneComponent* AppliedComponent;
+
+	void PreReplicatedRemove(const struct FReplicatedSelectionList& InArraySerializer);
+	void PostReplicatedAdd(const struct FReplicatedSelectionList& InArraySerializer);
+	void PostReplicatedChange(const struct FReplicatedSelectionList& InArraySerializer);
+};
+
+/**
+ * Selection of a Transformer replicated from the Server as a Fast Array,
+ * so only the Components Added/Removed since the last update are sent (instead of the whole Selection).
+ * The Clients apply these diffs through the regular Select/Deselect callbacks.
+ *
+ * A Component that is not resolvable yet on a Client (e.g. a Clone that has not been replicated yet)
+ * comes through as nullptr and is Selected as soon as it resolves (PostReplicatedChange).
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FReplicatedSelectionList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	FReplicatedSelectionList();
+
+	//Server only. Adds the Component to the List (if it was not already there)
+	void Add(class USceneComponent* Component);
+
+	/**
+	 * Server only. Removes the Component from the List (if it was there).
+	 * Its Item is only cleared, and goes away on the next FlushRemovals.
+	 */
+	void Remove(class USceneComponent* Component);
+
+	/**
+	 * Server only. Drops the Items that were Removed (or collected by the GC) in one pass that keeps the order
+	 * of the rest, so the Clients get the Components in the same order they were Selected in the Server.
+	 */
+	void FlushRemovals();
+
+	//Server only. Removes every Component from the List
+	void Reset();
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FReplicatedSelectionItem, FReplicatedSelectionList>(
+			Items, DeltaParms, *this);
+	}
+
+	//The Transformer that owns this List, which receives the Select/Deselect diffs
+	class UTransformerComponent* Owner;
+
+private:
+
+	UPROPERTY()
+	TArray<FReplicatedSelectionItem> Items;
+
+	//Server only. Maps each Component to its Item index
+	TMap<const class USceneComponent*, int32> ItemIndex;
+
+	//Server only. Whether there are Removed Items waiting for FlushRemovals
+	bool bHasRemovals;
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedSelectionList> : public TStructOpsTypeTraitsBase2<FReplicatedSelectionList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
@@ -4,10 +4,23 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 #include "RuntimeTransformer.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRuntimeTransformer, Log, All);
 
+//stat RuntimeTransformer
+DECLARE_STATS_GROUP(TEXT("RuntimeTransformer"), STATGROUP_RuntimeTransformer, STATCAT_Advanced);
+
+//Scopes the code for both the Stats System and Unreal Insights (the Insights Event is named after the Stat).
+//With Stats, the Cycle Counter already emits the Insights Event, so it's only added on its own without them
+#if STATS
+#define RUNTIMETRANSFORMER_SCOPE(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define RUNTIMETRANSFORMER_SCOPE(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
+
 UENUM(BlueprintType)
 enum class ETransformationType : uint8
 {
@@ -0,0 +1,180 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SelectionSet.generated.h"
+
+/**
+ * What is known about a Selected Component that can't change while it stays Selected,
+ * resolved once when it's Selected so the per-frame loops don't need any Interface / Class lookups.
+ */
+struct FSelectionEntry
+{
+	/**
+	 * The UFocusable that is notified for the Component (itself or its Owner), if any.
+	 * Weak, as the Entry isn't seen by the GC and can outlive it (e.g. an Owner destroyed while its Component is Selected)
+	 */
+	TWeakObjectPtr<class UObject> FocusableObject;
+
+	//The Focusable Object as a Native Interface, nullptr if it's not implemented in C++. @see GetNativeFocusable
+	class IFocusableObject* NativeFocusable = nullptr;
+
+	//Whether the Focusable Object implements OnNewTransformations in Blueprint
+	bool bBatchedInScript = false;
+
+	//The Focusable Object, nullptr if none or if it's gone
+	class UObject* GetFocusable() const { return FocusableObject.Get(); }
+
+	//The Native Focusable, nullptr if none or if the Focusable Object is gone
+	class IFocusableObject* GetNativeFocusable() const { return FocusableObject.IsValid() ? NativeFocusable : nullptr; }
+};
+
+/**
+ * Insertion-Ordered Set of Selected Components.
+ * The Components are stored in a dense Array (in the order they were selected) and a Hash Index
+ * maps every Component to its slot in the Array, so Contains / Add / Remove are all O(1).
+ *
+ * Removing a Component leaves a Tombstone (nullptr) in its slot. Tombstones are skipped when iterating
+ * and are compacted away in bulk once they make up half of the Array.
+ * The live and Root counts are kept as Components are added and removed. Components collected by the GC
+ * (nulled out in their slot) are only accounted for by PruneCollected, which the owner calls after every GC.
+ *
+ * It also keeps which Components are Roots (have no Selected attach ancestor), so a parent and its child being
+ * both Selected is known without walking the hierarchy. Kept incrementally: adding or removing a Root only walks
+ * its attach children down to the next Selected ones. The hierarchy is assumed not to change while Selected,
+ * call RebuildRoots otherwise.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FSelectionSet
+{
+	GENERATED_BODY()
+
+public:
+
+	FSelectionSet();
+
+	//Adds the Component (and its Entry) to the end of the Selection. Returns false if it was already selected.
+	bool Add(class USceneComponent* Component, const FSelectionEntry& Entry = FSelectionEntry());
+
+	//Removes the Component from the Selection. Returns false if it was not selected.
+	bool Remove(class USceneComponent* Component);
+
+	bool Contains(const class USceneComponent* Component) const;
+
+	//The Entry of the Component, nullptr if it's not selected
+	const FSelectionEntry* FindEntry(const class USceneComponent* Component) const;
+
+	//Calls the Function for every Selected Component (in Selection order) and its Entry
+	void ForEachEntry(TFunctionRef<void(class USceneComponent*, const FSelectionEntry&)> Function) const;
+
+	//Whether the Component is Selected and none of its attach ancestors are
+	bool IsRoot(const class USceneComponent* Component) const
+	{
+		return Contains(Component) && !NonRoots.Contains(Component);
+	}
+
+	//Calls the Function for every Root (in Selection order) and its Entry
+	void ForEachRootEntry(TFunctionRef<void(class USceneComponent*, const FSelectionEntry&)> Function) const;
+
+	//The amount of Selected Components that have no Selected attach ancestor. @see Num
+	int32 NumRoots() const { return NumLive - NonRoots.Num(); }
+
+	//Recomputes the Roots from scratch (e.g. after Selected Components were attached elsewhere)
+	void RebuildRoots();
+
+	void Empty();
+
+	//Compacts the Set if the GC collected any of its Components. Call after every GC
+	void PruneCollected();
+
+	//The amount of Selected Components. @see PruneCollected
+	int32 Num() const { return NumLive; }
+
+	bool IsEmpty() const { return NumLive == 0; }
+
+	//The Component that was selected first (nullptr if empty)
+	class USceneComponent* First() const;
+
+	//The Component that was selected last (nullptr if empty)
+	class USceneComponent* Last() const;
+
+	//Returns the Selected Components in the order they were selected
+	TArray<class USceneComponent*> ToArray() const;
+
+	/**
+	 * Iterates the Selected Components in their Selection order, skipping Tombstones.
+	 * The Set must not be modified while iterating (copy it with ToArray first).
+	 */
+	class FConstIterator
+	{
+	public:
+		FConstIterator(const TArray<class USceneComponent*>& InComponents, int32 InSlot)
+			: Components(InComponents), Slot(InSlot)
+		{
+			SkipTombstones();
+		}
+
+		class USceneComponent* operator*() const { return Components[Slot]; }
+
+		FConstIterator& operator++()
+		{
+			++Slot;
+			SkipTombstones();
+			return *this;
+		}
+
+		bool operator!=(const FConstIterator& Other) const { return Slot != Other.Slot; }
+
+	private:
+		void SkipTombstones()
+		{
+			while (Slot < Components.Num() && !Components[Slot])
+				++Slot;
+		}
+
+		const TArray<class USceneComponent*>& Components;
+		int32 Slot;
+	};
+
+	FConstIterator begin() const { return FConstIterator(Components, FirstSlot); }
+	FConstIterator end() const { return FConstIterator(Components, Components.Num()); }
+
+private:
+
+	//Removes all the Tombstones and rebuilds the Index
+	void Compact();
+
+	//Pops the trailing tombstones and advances the First Slot past the leading ones
+	void TrimTombstones();
+
+	bool HasSelectedAncestor(const class USceneComponent* Component) const;
+
+	/**
+	 * Sets whether the Selected descendants of the Component are Roots. Only the nearest ones (down to the next
+	 * Selected Component of each branch) can change, as the ones below those are not Roots either way.
+	 */
+	void SetDescendantsNonRoots(const class USceneComponent* Component, bool bNonRoots);
+
+	/**
+	 * Dense Array of the Selected Components, in Selection order. Removed entries are left as nullptr (Tombstones).
+	 * UPROPERTY so that the GC sees the references (a destroyed Component is nulled out by the GC as well).
+	 */
+	UPROPERTY()
+	TArray<class USceneComponent*> Components;
+
+	//Entry of the Component in the same slot
+	TArray<FSelectionEntry> Entries;
+
+	//Maps each Selected Component to its slot in the Components Array
+	TMap<const class USceneComponent*, int32> Index;
+
+	//Slot of the First Selected Component (every slot before this is a Tombstone)
+	int32 FirstSlot;
+
+	//Slots that hold a Selected Component (i.e. are not Tombstones). Kept by Add / Remove and recounted by Compact
+	int32 NumLive;
+
+	//The Selected Components that have a Selected attach ancestor (i.e. are moved along with it)
+	TSet<const class USceneComponent*> NonRoots;
+};
@@ -0,0 +1,155 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TransformHistory.generated.h"
+
+/**
+ * What an Undo / Redo does to the World, sent to everyone in as few RPCs as its size allows.
+ * All the Transforms of each are written in one batched pass.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformHistoryStep
+{
+	GENERATED_BODY()
+
+public:
+
+	bool IsEmpty() const
+	{
+		return Components.Num() == 0 && DeletedActors.Num() == 0 && RestoredActors.Num() == 0;
+	}
+
+	//Components to move, along with the World Transform to set to each
+	UPROPERTY()
+	TArray<class USceneComponent*> Components;
+
+	UPROPERTY()
+	TArray<FTransform> Transforms;
+
+	//Actors to Soft-Delete (hide and disable collision, but keep alive in case they are restored)
+	UPROPERTY()
+	TArray<AActor*> DeletedActors;
+
+	//Soft-Deleted Actors to bring back
+	UPROPERTY()
+	TArray<AActor*> RestoredActors;
+};
+
+enum class ETransformHistoryOperation : uint8
+{
+	Transform,
+	Clone,
+	Delete,
+};
+
+/**
+ * Undo / Redo History of the Transforms, Clones and Deletes.
+ *
+ * Each Operation is a small Header in a Ring (so the oldest ones are dropped past the Max Operations)
+ * and a Payload in a shared Byte Arena: the Objects (as Weak Pointers) and, for Transforms, only the fields
+ * (Location, Rotation, Scale) the Operation changed, Before and After.
+ * Operations older than the Quantize After count have their Rotations & Scales quantized.
+ * Past the Memory Budget, the oldest Operations are dropped.
+ *
+ * The History doesn't destroy anything itself: Soft-Deleted Actors that can no longer be restored
+ * (their Operation was dropped) are handed back as Released Actors, for the owner to destroy.
+ */
+class RUNTIMETRANSFORMER_API FTransformHistory
+{
+public:
+
+	FTransformHistory();
+
+	//Sets the limits. Operations past them are dropped right away
+	void Configure(int32 InMemoryBudget, int32 InMaxOperations, int32 InQuantizeAfter
+	               , TArray<AActor*>& outReleasedActors);
+
+	/**
+	 * Records a Transform of the Components (Before & After are their World Transforms).
+	 * Nothing is recorded if no Component actually changed. Discards whatever could be Redone.
+	 */
+	void RecordTransforms(const TArray<class USceneComponent*>& Components
+	                      , const TArray<FTransform>& Before, const TArray<FTransform>& After
+	                      , TArray<AActor*>& outReleasedActors);
+
+	//Records the Actors that were Cloned or (Soft-)Deleted. Discards whatever could be Redone.
+	void RecordActors(ETransformHistoryOperation Operation, const TArray<AActor*>& Actors
+	                  , TArray<AActor*>& outReleasedActors);
+
+	//Steps back one Operation. Returns false if there is nothing to Undo
+	bool Undo(FTransformHistoryStep& outStep);
+
+	//Steps forward one Operation. Returns false if there is nothing to Redo
+	bool Redo(FTransformHistoryStep& outStep);
+
+	bool CanUndo() const { return Cursor > 0; }
+
+	bool CanRedo() const { return Cursor < Count; }
+
+	int32 Num() const { return Count; }
+
+	//Drops every Operation
+	void Reset(TArray<AActor*>& outReleasedActors);
+
+	//Bytes allocated by the History
+	SIZE_T GetAllocatedSize() const { return Operations.GetAllocatedSize() + Arena.GetAllocatedSize(); }
+
+private:
+
+	struct FOperation
+	{
+		ETransformHistoryOperation Type;
+
+		//Transformed fields (see ETransformField in the cpp)
+		uint8 FieldMask;
+
+		bool bQuantized;
+
+		//Amount of Objects
+		int32 Num;
+
+		//Payload in the Arena
+		int32 Offset;
+		int32 Size;
+	};
+
+	//Operation by age (0 is the oldest)
+	FOperation& GetOperation(int32 Index) { return Operations[(Head + Index) % Operations.Num()]; }
+
+	//Adds the Operation (its Payload must be at the end of the Arena already) and enforces the limits
+	void Push(const FOperation& Operation, TArray<AActor*>& outReleasedActors);
+
+	//Drops the Operations that could be Redone
+	void DiscardRedo(TArray<AActor*>& outReleasedActors);
+
+	void DropOldest(TArray<AActor*>& outReleasedActors);
+
+	//Gathers the Actors that can no longer be restored once the Operation is dropped
+	void Release(FOperation& Operation, bool bApplied, TArray<AActor*>& outReleasedActors);
+
+	//Quantizes the Transform Operations that are older than Quantize After
+	void QuantizeOldOperations();
+
+	//Moves the live Payloads to the front of the Arena, once too much of it is wasted
+	void CompactArena();
+
+	//Fills the Step with the Transforms (Before or After) or the Actors of the Operation
+	void GetStep(FOperation& Operation, bool bUndo, FTransformHistoryStep& outStep);
+
+	TArray<FOperation> Operations;
+	int32 Head;
+	int32 Count;
+
+	//Operations before the Cursor are applied, the ones after it have been Undone
+	int32 Cursor;
+
+	TArray<uint8> Arena;
+
+	//Bytes of the Arena in use by Payloads (the rest is wasted, until compacted)
+	int32 ArenaUsed;
+
+	int32 MemoryBudget;
+	int32 QuantizeAfter;
+};
@@ -0,0 +1,83 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SelectionSet.h"
+#include "TransformSnapshot.generated.h"
+
+/**
+ * Snapshot of the World Transforms of a list of Components, taken when a Transform starts (Domain is entered).
+ * Stored as a Structure of Arrays so that computing the transforms of a large selection each frame
+ * is a tight loop over contiguous memory.
+ *
+ * Every frame the final transforms are computed from the Snapshot and the Delta accumulated since the start,
+ * so no float error builds up over long drags, and reverting is a single write of the Snapshot.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformSnapshot
+{
+	GENERATED_BODY()
+
+public:
+
+	FTransformSnapshot();
+
+	/**
+	 * Captures the current World Transforms of the Components (along with their Selection Entries).
+	 * Pivot is the point the rotations are done around (i.e. the Gizmo)
+	 */
+	void Capture(const TArray<class USceneComponent*>& InComponents, const TArray<FSelectionEntry>& InEntries
+	             , const FVector& InPivot);
+
+	void Reset();
+
+	bool IsValid() const { return bValid; }
+
+	int32 Num() const { return Components.Num(); }
+
+	class USceneComponent* GetComponent(int32 Index) const { return Components[Index]; }
+
+	const TArray<class USceneComponent*>& GetComponents() const { return Components; }
+
+	const TArray<FSelectionEntry>& GetEntries() const { return Entries; }
+
+	//The Transform of the Component at the time of the Capture
+	FTransform GetTransform(int32 Index) const
+	{
+		return FTransform(Rotations[Index], Locations[Index], Scales[Index]);
+	}
+
+	/**
+	 * Computes the Transform of the Component at the given Index after applying the Accumulated Delta
+	 * (Rotation is done around the Pivot unless bRotateOnLocalAxis, Scale is applied in Local Space).
+	 */
+	FTransform ComputeTransform(int32 Index, const FTransform& AccumulatedDelta, bool bRotateOnLocalAxis) const
+	{
+		const FQuat& rotation = Rotations[Index];
+		const FQuat deltaRotation = AccumulatedDelta.GetRotation();
+
+		FVector deltaLocation = Locations[Index] - Pivot;
+		if (!bRotateOnLocalAxis)
+			deltaLocation = deltaRotation.RotateVector(deltaLocation);
+
+		return FTransform(deltaRotation * rotation
+		                  , deltaLocation + Pivot + AccumulatedDelta.GetLocation()
+		                  , rotation.UnrotateVector(AccumulatedDelta.GetScale3D()) + Scales[Index]);
+	}
+
+private:
+
+	UPROPERTY()
+	TArray<class USceneComponent*> Components;
+
+	TArray<FSelectionEntry> Entries;
+
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+	TArray<FVector> Scales;
+
+	FVector Pivot;
+
+	bool bValid;
+};
@@ -0,0 +1,96 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TransformStreamPacket.generated.h"
+
+/**
+ * Unreliable, Sequence-Numbered update of a Transform in progress (a Drag) sent while Streaming.
+ * It carries the Delta accumulated since the Drag started (not since the last packet),
+ * so a lost packet is simply corrected by the next one that arrives.
+ *
+ * The Delta is quantized when Net Serialized:
+ * - Translation: only the non-zero axes (a constrained Domain only sends its axes) as packed integers at 0.01cm
+ * - Rotation: compressed to 16 bits per non-zero axis
+ * - Scale: only the non-zero axes as 16 bit integers at 0.001
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformStreamPacket
+{
+	GENERATED_BODY()
+
+public:
+
+	FTransformStreamPacket();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	//Whether Sequence A comes after Sequence B (handles the wrap around)
+	static bool IsNewerSequence(uint16 A, uint16 B) { return static_cast<int16>(A - B) > 0; }
+
+	//Sequence number of this packet. Increases with every Packet sent, across Drags.
+	uint16 Sequence;
+
+	//Identifies the Drag the Packet belongs to
+	uint8 DragId;
+
+	//Delta Transform accumulated since the Drag started (Rotations are composed, Locations & Scales are added)
+	FTransform AccumulatedDelta;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTransformStreamPacket> : public TStructOpsTypeTraitsBase2<FTransformStreamPacket>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//State kept by a Receiver for a Drag being Streamed
+struct FStreamedDragState
+{
+	//Last Sequence applied for this Drag
+	uint16 LastSequence = 0;
+
+	//Accumulated Delta that has been applied so far for this Drag
+	FTransform AppliedDelta;
+
+	//When Interpolating: the Applied Delta when the last Packet arrived, and the one that Packet carried
+	FTransform StartDelta;
+	FTransform TargetDelta;
+
+	//When Interpolating: how far the Applied Delta is from the Start (0) to the Target (1)
+	float InterpolationAlpha = 1.f;
+};
+
+//State kept by a Sender for a Drag it Committed and the Server hasn't Acknowledged yet
+struct FPredictedDragState
+{
+	uint8 DragId = 0;
+
+	//the Transforms the Components ended up with locally
+	TMap<TWeakObjectPtr<class USceneComponent>, FTransform> Transforms;
+
+	//the World Transforms the Selected Instances ended up with locally, by Instance Index
+	TMap<TWeakObjectPtr<class UInstancedStaticMeshComponent>, TMap<int32, FTransform>> InstanceTransforms;
+};
+
+//The authoritative World Transforms of the Selected Instances of a Component, once a Drag was Committed
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FAcknowledgedInstances
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	class UInstancedStaticMeshComponent* Component = nullptr;
+
+	UPROPERTY()
+	TArray<int32> Instances;
+
+	UPROPERTY()
+	TArray<FTransform> Transforms;
+};
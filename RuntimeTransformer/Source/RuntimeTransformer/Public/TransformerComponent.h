@@ -4,8 +4,24 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "WorldCollision.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "RuntimeTransformer.h"
 #include "Gizmos/BaseGizmo.h"
+#include "SelectionSet.h"
+#include "TransformSnapshot.h"
+#include "DragPreview.h"
+#include "TransformStreamPacket.h"
+#include "ReplicatedSelection.h"
+#include "CloneBatch.h"
+#include "LayoutSnapshot.h"
+#include "InstanceSet.h"
+#include "MarqueeSelection.h"
+#include "TransformHistory.h"
+#include "TransformerLockTable.h"
+#include "TransformerSubsystem.h"
+#include "TransformerStateBatch.h"
+#include "ObservedEditor.h"
 #include "TransformerComponent.generated.h"
 
 UENUM(BlueprintType)
@@ -16,6 +32,12 @@ enum class EGizmoPlacement : uint8
 	GP_OnLastSelection UMETA(DisplayName = "On Last Selection"),
 };
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FCloneBatchProgressDelegate, int32, ClonesProcessed, int32, ClonesTotal);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FCloneBatchCompletedDelegate, const TArray<class USceneComponent*>&, Clones);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSelectionRejectedDelegate, class USceneComponent*, Component, ESelectionRejectReason, Reason);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLayoutImportedDelegate, int32, ComponentsPlaced, int32, ActorsSpawned);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FObservedEditorChangedDelegate, class APlayerState*, Editor);
+
 UCLASS(ClassGroup = (RuntimeTransformer), meta = (BlueprintSpawnableComponent))
 class RUNTIMETRANSFORMER_API UTransformerComponent : public UActorComponent
 {
@@ -28,22 +50,34 @@ public:
 	virtual void GetLifetimeReplicatedProps(
 		TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 	//Gets the UFocusable Object. If ComponentBased, returns the UFocusable Component or nullptr (if it doesn't implement)
 	// if ActorBased, returns the UFosuable Owner Actor or nullptr (if it doesn't implement)
 	class UObject* GetUFocusable(class USceneComponent* Component) const;
 
-	//Sets the Transform for a Given Component and calls the 
-	//Ufocusable transform function called if it implements the Interface
-	void SetTransform(class USceneComponent* Component, const FTransform& Transform);
+	/**
+	 * Notifies a UFocusable of the new Transforms of its Components, once for all of them:
+	 * through the Native fast path if it handles it, else through OnNewTransformations if implemented in Blueprint,
+	 * else with one OnNewTransformation per Component.
+	 */
+	void NotifyNewTransformations(const FSelectionEntry& Entry, const TArray<class USceneComponent*>& Components
+	                              , const TArray<FTransform>& Transforms);
+
+	//Resolves what the Selection needs to know about the Component (its UFocusable, Owner, etc.)
+	FSelectionEntry ResolveSelectionEntry(class USceneComponent* Component) const;
 
 	//Called when the Component is added to the SelectedComponent List
 	// Calls the IFocusableObject::Focus if the Component implements the UFocusable interface
-	void Select(class USceneComponent* Component, bool* bImplementsUFocusable = nullptr);
+	void Select(class USceneComponent* Component, const FSelectionEntry& Entry);
 
 	// Called when the Component is removed from the SelectedComponent List
 	// Calls the IFocusableObject::Unfocus if the Component implements the UFocusable interface
-	void Deselect(class USceneComponent* Component, bool* bImplementsUFocusable = nullptr);
+	void Deselect(class USceneComponent* Component, const FSelectionEntry& Entry);
 
 	//Used to Filter unwanted things from a list of OutHits.
 	void FilterHits(TArray<FHitResult>& outHits);
@@ -86,6 +120,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
 	void ClearDomain();
 
+	/**
+	 * Cancels the Transform in Progress: the Selected Components are restored to
+	 * the transforms they had when the Transform started, and the Domain is cleared.
+	 * In a Replicated Environment, call this instead of ReplicateFinishTransform.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void CancelTransform();
+
 	//Gets the Start and End Points of the Mouse based on the Player Controller possessing this pawn
 	// returns true if outStartPoint and outEndPoint were given a successful value
 	bool GetMouseStartEndPoints(float TraceDistance, FVector& outStartPoint, FVector& outEndPoint);
@@ -211,6 +253,79 @@ public:
 	                    , TArray<AActor*> IgnoredActors
 	                    , bool bAppendToList = false);
 
+	/**
+	 * Starts a Marquee (Rectangle) Selection at the given Screen Position.
+	 * Each UpdateMarqueeSelection then selects what is inside the Rectangle from the Start to the new Position,
+	 * found with an Overlap Query (rather than walking every Actor), and deselects what left it.
+	 * For a one-shot Rectangle Selection, call Begin, Update and End in a row.
+
+	 * This function only works if there is a Player Controller Set (its Camera & Viewport are used)
+	 * @see SetPlayerController
+
+	 * @param ScreenPosition - the Start of the Rectangle, in Viewport pixels (e.g. the Mouse Position)
+	 * @param Distance - how far from the Camera the Objects are considered
+	 * @param CollisionChannels - All the Object Types to be considered in the Query
+	 * @param Ignored Actors	- The Actors to be Ignored in the Query
+	 * @param bAppendToList - whether to keep the previously selected components or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void BeginMarqueeSelectionByObjectTypes(const FVector2D& ScreenPosition
+	                                        , float Distance
+	                                        , TArray<TEnumAsByte<ECollisionChannel>> CollisionChannels
+	                                        , TArray<AActor*> IgnoredActors
+	                                        , bool bAppendToList = false);
+
+	/**
+	 * @see BeginMarqueeSelectionByObjectTypes
+	 * @param TraceChannel - The Collision Channel to be considered in the Query
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void BeginMarqueeSelectionByChannel(const FVector2D& ScreenPosition
+	                                    , float Distance
+	                                    , TEnumAsByte<ECollisionChannel> TraceChannel
+	                                    , TArray<AActor*> IgnoredActors
+	                                    , bool bAppendToList = false);
+
+	/**
+	 * @see BeginMarqueeSelectionByObjectTypes
+	 * @param ProfileName - The Profile Name to be used in the Query
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void BeginMarqueeSelectionByProfile(const FVector2D& ScreenPosition
+	                                    , float Distance
+	                                    , const FName& ProfileName
+	                                    , TArray<AActor*> IgnoredActors
+	                                    , bool bAppendToList = false);
+
+	/**
+	 * Moves the other corner of the Marquee to the given Screen Position (e.g. while the Mouse is dragged).
+	 * Only the difference with the previous Update is selected / deselected, in a single Selection Transaction.
+	 * @return bool Whether there is anything inside the Marquee
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool UpdateMarqueeSelection(const FVector2D& ScreenPosition);
+
+	//Finishes the Marquee Selection, keeping what it selected
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void EndMarqueeSelection();
+
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool IsMarqueeSelectionInProgress() const { return MarqueeSelection.bActive; }
+
+private:
+
+	//Starts the Marquee (the Query settings must have been set already)
+	void BeginMarqueeSelection_Internal(const FVector2D& ScreenPosition, float Distance
+	                                    , const TArray<AActor*>& IgnoredActors, bool bAppendToList);
+
+	//Gets the Rect & View Projection Matrix of the Player's View
+	bool GetViewProjection(FIntRect& outViewRect, FMatrix& outViewProjectionMatrix) const;
+
+	//Gets the Components (Actor Root Components if not Component Based) that the Frustum contains
+	void GetComponentsInFrustum(const FMarqueeFrustum& Frustum, TSet<class USceneComponent*>& outComponents);
+
+public:
+
 	// Update every Frame
 	// Checks for Mouse Update
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType,
@@ -235,9 +350,45 @@ public:
 	FTransform UpdateTransform(const FVector& LookingVector
 	                           , const FVector& RayOrigin, const FVector& RayDirection);
 
+	/**
+	 * Applies a Delta Transform to the Selected Components (relative to the Gizmo).
+	 * The new transforms are first computed (in parallel for large selections) and then applied in a single pass.
+	 * Components whose ancestor is also selected are skipped, since they are moved along with it.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
 	void ApplyDeltaTransform(const FTransform& DeltaTransform);
 
+private:
+	//Gets the Selected Components that need to be transformed directly
+	void GetTransformableComponents(TArray<class USceneComponent*>& outComponents
+	                                , TArray<FSelectionEntry>& outEntries) const;
+
+	//Whether the Component can be moved (is Moveable, or Mobility is being forced)
+	bool CanTransform(const class USceneComponent* Component) const;
+
+	//Whether the Component has a Selected ancestor that is going to be transformed (and so will move it)
+	//Walks the hierarchy, so only needed for the Selected Components that are not Selection Roots
+	bool IsTransformedByAncestor(const class USceneComponent* Component) const;
+
+	//Writes the given transforms (and their Mobility, if needed) to the Components in a single pass
+	void ApplyComponentTransforms(const TArray<class USceneComponent*>& Components
+	                              , const TArray<FSelectionEntry>& Entries
+	                              , const TArray<FTransform>& Transforms);
+
+	//Moves the Component, without its Physics Bodies if it's being Previewed. @see bPreviewDrags
+	void SetComponentTransform(class USceneComponent* Component, const FTransform& Transform);
+
+	//Rebuilds the Selection Roots, captures the Drag Snapshot of the Components to transform and resets the Drag Delta Transform
+	void CaptureDragSnapshot();
+
+	//Applies the Drag Delta Transform to the Drag Snapshot (absolute transforms rather than incremental)
+	void ApplyDragTransform();
+
+	//Adds a Delta Transform to an Accumulated Transform (Rotations are composed, Locations & Scales are added)
+	static void AccumulateDeltaTransform(FTransform& outAccumulatedTransform, const FTransform& DeltaTransform);
+
+public:
+
 	/**
 	 * Processes the OutHits generated by Tracing and Selects either a Gizmo (priority) or
 	 * if no Gizmo is present in the trace, the first object hit is selected.
@@ -348,6 +499,12 @@ public:
 	* Makes an exact copy of the Actors that are owners of the components and makes
 	* a copy of them.
 	
+	* The Actors are Cloned as a Batch: if a Clone Frame Budget is set, the Batch is spread over several frames.
+	* Progress is reported through OnCloneBatchProgress and completion through OnCloneBatchCompleted.
+	* The new Clones are selected all at once, when the whole Batch finishes.
+	* If a Batch is already in progress, it is finished right away before starting the new one.
+	* Component Based Cloning is not Batched (it's done right away).
+
 	* Don't spam this :)
 	* @param bSelectNewClones - whether to add the new clones to the Selection
 	* @param bAppendToList - If the New Clones are selected, whether to Append them to the List or Clear the previous Selections
@@ -355,6 +512,58 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
 	void CloneSelected(bool bSelectNewClones = true, bool bAppendToList = false);
 
+	//Whether a Clone Batch is in progress
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool IsCloneBatchInProgress() const { return CloneBatch.IsActive(); }
+
+	//Called after every chunk of a Clone Batch is processed
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Transformer")
+	FCloneBatchProgressDelegate OnCloneBatchProgress;
+
+	/**
+	 * Writes the Layout of the Components (their World Transforms and what's needed to find them again) as a compact
+	 * binary blob (@see FLayoutWriter). Ancestors are written before their descendants, so they're placed first.
+	 * Actors Spawned at runtime (e.g. Clones) also get their Class, so they can be Spawned again if not found.
+	 * Component Based, only the Components are found again (nothing is Spawned).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void ExportLayout(const TArray<class USceneComponent*>& Components, TArray<uint8>& outData) const;
+
+	//Exports the Layout of the Selected Components. @see ExportLayout
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void ExportSelectedLayout(TArray<uint8>& outData) const;
+
+	//Exports the Layout of the Components to a File. Returns false if it couldn't be written. @see ExportLayout
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool SaveLayoutToFile(const FString& FilePath, const TArray<class USceneComponent*>& Components) const;
+
+	/**
+	 * Imports a Layout: it's read Layout Import Entries Per Frame at a time (over several frames, for big Layouts)
+	 * and the Components found get their Transforms back, in a batch per frame. Once it's all read, the Actors
+	 * that were not found (and have a Class) are Spawned through a Clone Batch (@see OnCloneBatchCompleted).
+	 * In a Client, only the Actors that don't Replicate are Spawned (the Server Spawns the rest).
+	 * If an Import is already in progress, it is finished right away before starting the new one.
+	 * @return false if the Data is not a Layout
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool ImportLayout(const TArray<uint8>& Data);
+
+	//Imports a Layout from a File, Memory Mapped if the Platform supports it. @see ImportLayout
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool LoadLayoutFromFile(const FString& FilePath);
+
+	//Whether a Layout Import is in progress
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool IsLayoutImportInProgress() const { return LayoutImport.IsValid(); }
+
+	//Called when a Layout Import has read all its Entries, before the Actors to Spawn (if any) are Spawned
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Transformer")
+	FLayoutImportedDelegate OnLayoutImported;
+
+	//Called when a Clone Batch has finished, after the Clones have been selected (if requested)
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Transformer")
+	FCloneBatchCompletedDelegate OnCloneBatchCompleted;
+
 protected:
 	TArray<class USceneComponent*> CloneFromList(
 		const TArray<class USceneComponent*>& ComponentList);
@@ -363,8 +572,102 @@ private:
 	TArray<class USceneComponent*> CloneActors(
 		const TArray<AActor*>& Actors);
 
+	//Starts Cloning the Actors in a Batch (finishing the one in progress, if any)
+	void BeginCloneBatch(const TArray<AActor*>& Actors, bool bSelectNewClones, bool bAppendToList);
+
+	//Reads (and places) the next Entries of the Layout Import, and schedules the next ones for the next tick
+	void ProcessLayoutImport();
+
+	//Reads the rest of the Layout Import right away and completes it
+	void FlushLayoutImport();
+
+	//Starts the Import (finishing the one in progress, if any)
+	void BeginLayoutImport(TUniquePtr<FLayoutImport>&& Import);
+
+	//Reads up to Count Entries of the Import, applying the Transforms of the Components found all at once
+	void ReadLayoutEntries(int32 Count);
+
+	//Broadcasts the Import and Spawns the Actors that were not found
+	void CompleteLayoutImport();
+
+	//Starts Spawning the Actors from their Classes in a Batch (finishing the one in progress, if any)
+	void BeginSpawnBatch(const TArray<UClass*>& Classes, const TArray<FTransform>& Transforms);
+
+	//Processes the Batch just Initialized: over several frames if there's a Clone Frame Budget, else right away
+	void RunCloneBatch();
+
+	//Processes a chunk of the Clone Batch (sized by the Frame Budget) and schedules the next one for the next tick
+	void ProcessCloneBatch();
+
+	//Processes the rest of the Clone Batch right away and completes it
+	void FlushCloneBatch();
+
+	/**
+	 * Clones the next Count Templates of the Batch: every Clone is spawned deferred, 
+	 * attached to the Clone of its parent (if the parent is in the Batch), then they all finish spawning.
+	 */
+	void CloneBatchChunk(FCloneBatch& Batch, int32 Count);
+
+	//Selects the Clones (if requested), broadcasts the Completion and resets the Batch
+	void CompleteCloneBatch();
+
+	/**
+	 * Clones the Components in one pass over the Selected subtree (Parent-first).
+	 * Each Clone is attached to the Clone of its nearest cloned ancestor (or to the original parent if there's none)
+	 * before it's registered, so each Clone registers only once.
+	 * @param outTopmostClones - if given, the Clones that have no cloned ancestor are added to it
+	 */
 	TArray<class USceneComponent*> CloneComponents(
-		const TArray<class USceneComponent*>& Components);
+		const TArray<class USceneComponent*>& Components
+		, TArray<class USceneComponent*>* outTopmostClones = nullptr);
+
+public:
+
+	/**
+	 * Undoes the last recorded Transform (Drag), Clone or Delete. Authority only (see ServerUndo).
+	 * The Transforms of the Operation are all written in one batch, and sent to everyone
+	 * in Multicasts of at most MaxHistoryStepObjects Objects each.
+	 * Only recorded if bRecordHistory is set.
+	 * @return false if there was nothing to Undo, or if a Drag is in progress (the Domain is set)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool Undo();
+
+	//Redoes the last Undone Operation. Authority only (see ServerRedo). @see Undo
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool Redo();
+
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool CanUndo() const { return History.CanUndo(); }
+
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool CanRedo() const { return History.CanRedo(); }
+
+	//Drops every recorded Operation (Actors that were Soft-Deleted by them are Destroyed)
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void ClearHistory();
+
+private:
+
+	//Captures the Transforms of the Components about to be transformed, for the History
+	void BeginHistoryTransform();
+
+	//Records the Transform since BeginHistoryTransform (if anything moved)
+	void EndHistoryTransform();
+
+	//Destroys the Soft-Deleted Actors the History no longer needs
+	void DestroyReleasedActors(const TArray<AActor*>& ReleasedActors);
+
+	//Hides the Actor and disables its Collision (or the other way around), keeping it alive so it can be restored
+	void SetActorSoftDeleted(AActor* Actor, bool bSoftDeleted);
+
+	//Applies an Undo / Redo Step locally
+	void ApplyHistoryStep(const FTransformHistoryStep& Step);
+
+	//Multicasts the Step in chunks of at most MaxHistoryStepObjects Objects
+	void MulticastHistoryStep(const FTransformHistoryStep& Step);
+
+	bool IsRecordingHistory() const;
 
 public:
 	/**
@@ -413,6 +716,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
 	void DeselectActor(AActor* Actor);
 
+	/**
+	 * Selects an Instance of an Instanced Static Mesh Component (e.g. the FHitResult Item of a Trace).
+	 * Instances are transformed, cloned (as new Instances) and destroyed like the Selected Components.
+	 * NOTE: Instance Selection is local, it's not replicated.
+	 * @param Component - the Instanced Static Mesh Component (or Hierarchical) that has the Instance
+	 * @param InstanceIndex - the Index of the Instance to select
+	 * @param bAppendToList - whether to append to the previously selected components/instances or not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void SelectInstance(class UInstancedStaticMeshComponent* Component, int32 InstanceIndex
+	                    , bool bAppendToList = false);
+
+	//Deselects an Instance of an Instanced Static Mesh Component, if it was selected
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void DeselectInstance(class UInstancedStaticMeshComponent* Component, int32 InstanceIndex);
+
+	//Gets the Selected Instances of an Instanced Static Mesh Component, in ascending order
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	TArray<int32> GetSelectedInstances(class UInstancedStaticMeshComponent* Component) const;
+
+	//Whether there is any Instance Selected
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool HasSelectedInstances() const { return SelectedInstances.Num() > 0; }
+
 	/*
 	* Deselects all the Selected Components that are in the list.
 
@@ -423,38 +750,213 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
 	TArray<class USceneComponent*> DeselectAll(bool bDestroyDeselected = false);
 
+	/**
+	 * Begins a Selection Transaction. Transactions can be nested.
+	 * While a Transaction is open, Focus/Unfocus and OnComponentSelectionChange are still called per Component,
+	 * but the Gizmo Placement (including the Gizmo Spawn / Destroy) and the flush of the Replicated Selection
+	 * Removals are deferred and run only once, when the outermost Transaction ends.
+	 * Every Begin must be matched by an EndSelectionTransaction.
+
+	 @see FScopedSelectionTransaction for C++
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void BeginSelectionTransaction();
+
+	/**
+	 * Ends a Selection Transaction. If it's the outermost Transaction,
+	 * the deferred Gizmo Placement and Replicated Selection flush are performed.
+	 @see BeginSelectionTransaction
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	void EndSelectionTransaction();
+
+	//Whether there is currently a Selection Transaction open
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	bool IsInSelectionTransaction() const { return SelectionTransactionDepth > 0; }
+
+	/**
+	 * The Player holding the Edit Lock of the Component (or of its Actor, if not Component Based).
+	 * nullptr if it's not locked (or Edit Locks are not in use).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Runtime Transformer")
+	class APlayerState* GetLockHolder(class USceneComponent* Component) const;
+
+	//Called when Selecting a Component is rejected because of the Edit Locks
+	UPROPERTY(BlueprintAssignable, Category = "Runtime Transformer")
+	FSelectionRejectedDelegate OnSelectionRejected;
+
+	/**
+	 * Server only. Sets the Editing Group of this Transformer. Takes effect the next time the Server
+	 * updates the Interest of the Observers.
+	 * @see bReplicateToObservers
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
+	void SetEditingGroup(FName Group);
+
+	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
+	FName GetEditingGroup() const { return EditingGroup; }
+
+	//The other Players this Transformer currently Observes, and what they are doing
+	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
+	void GetObservedEditors(TArray<FObservedEditorState>& outEditors) const { outEditors = ObservedEditors; }
+
+	//The Observed Player that has the Component Selected. nullptr if none (that this Transformer Observes) does
+	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
+	class APlayerState* GetObservedEditor(class USceneComponent* Component) const;
+
+	//Called when an Observed Player changes what they are doing, starts being Observed or stops being Observed
+	UPROPERTY(BlueprintAssignable, Category = "Replicated Runtime Transformer")
+	FObservedEditorChangedDelegate OnObservedEditorChanged;
+
 private:
 	/*
 	The core functionality, but can be called by Selection of Multiple objects
 	so as to not call UpdateGizmo every time
+	@param bCheckLock - whether the Edit Lock has to be acquired (the Replicated Selection was already granted by the Server)
 	*/
-	void AddComponent_Internal(TArray<class USceneComponent*>& OutComponentList
-	                           , class USceneComponent* Component);
+	void AddComponent_Internal(FSelectionSet& OutComponentList
+	                           , class USceneComponent* Component, bool bCheckLock = true);
+
+	//The Object the Edit Lock of the Component is kept for: the Component if Component Based, its Actor otherwise
+	UObject* GetLockObject(class USceneComponent* Component) const;
+
+	/**
+	 * Server: acquires the Edit Lock of the Component. Client: checks the replicated Locks to predict whether
+	 * the Server will reject it. Rejections are broadcast (and sent to the owning Client, if remote).
+	 */
+	ESelectionRejectReason AcquireLock(class USceneComponent* Component);
+
+	//Server only. Releases the Edit Lock of the Component
+	void ReleaseLock(class USceneComponent* Component);
+
+	class ATransformerLockTable* GetLockTable(bool bSpawnIfMissing) const;
 
 	/*
 	The core functionality, but can be called by Selection of Multiple objects
 	so as to not call UpdateGizmo every time
 	*/
-	void DeselectComponent_Internal(TArray<class USceneComponent*>& OutComponentList
+	void DeselectComponent_Internal(FSelectionSet& OutComponentList
 	                                , class USceneComponent* Component);
-	void DeselectComponentAtIndex_Internal(TArray<class USceneComponent*>& OutComponentList
-	                                       , int32 Index);
 
 	/**
-	 * Creates / Replaces Gizmo with the Current Transformation.
-	 * It destroys any current active gizmo to replace it.
+	 * Activates the Gizmo of the Current Transformation (or none if there are no Selected Components).
+	 * The previously active Gizmo is deactivated and kept in the Gizmo Pool, not destroyed.
 	*/
 	void SetGizmo();
 
+	/**
+	 * Gets the pooled Gizmo for the given Transformation,
+	 * spawning it (deactivated) if it's not in the Pool yet.
+	*/
+	ABaseGizmo* GetPooledGizmo(ETransformationType TransformationType);
+
 	/**
 	 * Updates the Gizmo Placement (Position)
 	 * Called when an object was selected, deselected
 	*/
 	void UpdateGizmoPlacement();
 
+	//Brings the Selected Components Stat up to date with the Selection of this Transformer
+	void UpdateSelectionStats();
+
+	/**
+	 * Server only. Flushes the Removals of the Replicated Selection (@see FReplicatedSelectionList::FlushRemovals).
+	 * If a Selection Transaction is open, it's deferred until the Transaction ends.
+	*/
+	void ReplicateSelection();
+
+	//Client only. Called by the Replicated Selection when the Server Selected a Component
+	void OnReplicatedSelect(class USceneComponent* Component);
+
+	//Client only. Called by the Replicated Selection when the Server Deselected a Component
+	void OnReplicatedDeselect(class USceneComponent* Component);
+
+	//Places the Gizmo after the Replicated Selection diffs have been applied
+	UFUNCTION()
+	void OnRep_ReplicatedSelection();
+
+	friend struct FReplicatedSelectionItem;
+
+	/**
+	 * Enables the Tick only if there's something to do (a Gizmo to keep updated or a Transform in progress)
+	 * Only takes effect if bEventDrivenGizmoUpdates is true.
+	 */
+	void UpdateComponentTickState();
+
+	//Applies the Delta Transform to the Selected Instances. One batched update & render state refresh per Component
+	void ApplyDeltaTransformToInstances(const FTransform& DeltaTransform);
+
+	//Captures the Instance Drag Snapshots of the Selected Instances. @see CaptureDragSnapshot
+	void CaptureInstanceDragSnapshot(const FVector& Pivot);
+
+	//Applies the Drag Delta Transform to the Instance Drag Snapshots, like ApplyDragTransform does for the Components
+	void ApplyInstanceDragTransform();
+
+	/**
+	 * Keeps the Selected Instances pointing at the same Instances when their Component moves them to other Indices
+	 * (e.g. removing an Instance shifts or swaps the ones after it)
+	 */
+	void OnInstanceIndexUpdated(class UInstancedStaticMeshComponent* Component
+	                            , TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates);
+
+	//Drops the Selected Components the GC collected, so the Selection counts stay right. @see FSelectionSet::PruneCollected
+	void OnPostGarbageCollect();
+
+	/**
+	 * Focuses / Unfocuses the Instanced Static Mesh Component and calls OnComponentSelectionChange, as it's done
+	 * for a Selected Component. Called when its first Instance is Selected and when its last one is Deselected.
+	 */
+	void OnInstanceComponentSelectionChange(class UInstancedStaticMeshComponent* Component, bool bSelected);
+
+	//Clones the Selected Instances into new Instances of the same Components
+	void CloneSelectedInstances(bool bSelectNewClones, bool bAppendToList);
+
+	//Deselects all the Instances (and removes them from their Components if bRemoveInstances)
+	void DeselectAllInstances(bool bRemoveInstances);
+
+	//The Instance the Gizmo is placed on, if there are no Selected Components to attach to. Returns false if none
+	bool GetGizmoInstance(class UInstancedStaticMeshComponent*& outComponent, int32& outInstance) const;
+
+	//Places the (detached) Gizmo on the Gizmo Instance
+	void PlaceGizmoOnInstance();
+
+	//Whether the Tick has work to do. @see UpdateComponentTickState
+	bool NeedsTick() const;
+
+	//Whether this Transformer goes without Gizmo Actors. @see bLocalGizmosOnly
+	bool IsHeadless() const;
+
+	//The Class Default Object of the Gizmo of the Current Transformation
+	const ABaseGizmo* GetGizmoDefaults() const;
+
+	/**
+	 * Where the Gizmo would be placed (with no Scale) for the current Selection, Placement and Space,
+	 * without it having to be spawned. Returns false if there is nothing Selected
+	 */
+	bool GetVirtualGizmoTransform(FTransform& outTransform) const;
+
+	//The Location the Transforms are applied around: the Gizmo's, or the Virtual one if Headless
+	bool GetTransformPivot(FVector& outPivot) const;
+
+	//Whether the Camera or the Gizmo moved (past the thresholds) since the Gizmo Scene was last scaled
+	bool IsGizmoScaleDirty(const FVector& CameraLocation, const FVector& CameraForward, float FieldOfView);
+
+	//Whether the Space Type or the Gizmo parent changed since the Gizmo Space was last applied
+	bool IsGizmoSpaceDirty() const;
+
+	//Applies the Current Space Type to the Gizmo and caches the state for IsGizmoSpaceDirty
+	void ApplyGizmoSpace();
+
 	//Gets the respective assigned class for a given TransformationType
 	UClass* GetGizmoClass(ETransformationType TransformationType) const;
 
+	/**
+	 * Picks a Domain of the current Gizmo by intersecting the segment analytically (@see ABaseGizmo::PickDomain).
+	 * If a Domain is hit, it is set as the Current Domain and true is returned.
+	 */
+	bool PickGizmoDomain(const FVector& StartLocation, const FVector& EndLocation
+	                     , const TArray<AActor*>& IgnoredActors);
+
 	//Resets the transform to all Zeros (including Scale)
 	static void ResetDeltaTransform(FTransform& Transform);
 
@@ -586,13 +1088,55 @@ public:
 	/*
 	 * Calls the ServerClearDomain.
 	 * Then it calls ServerApplyTransform and Resets the Accumulated Network Transform.
+	 * If Streaming Transforms, ServerCommitStreamedTransform is called instead of ServerApplyTransform.
 
 	 * @see ServerClearDomain
 	 * @see ServerApplyTransform
+	 * @see ServerCommitStreamedTransform
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
 	void ReplicateFinishTransform();
 
+	/*
+	 * ServerCall, Unreliable. Sent (at the Transform Stream Rate) while a Transform is in progress and Streaming.
+	 * @see FTransformStreamPacket
+	 */
+	UFUNCTION(Server, Unreliable, WithValidation, Category = "Replicated Runtime Transformer")
+	void ServerStreamTransform(const FTransformStreamPacket& Packet);
+
+	/*
+	 * Multicast, Unreliable. The Streamed Transform is previewed in the Clients.
+	 * Packets older than the last one received (or than the last Commit) are dropped.
+	 */
+	UFUNCTION(NetMulticast, Unreliable, Category = "Replicated Runtime Transformer")
+	void MulticastStreamTransform(const FTransformStreamPacket& Packet);
+
+	/*
+	 * ServerCall, Reliable. Authoritative end of a Streamed Drag. 
+	 * @param FinalDeltaTransform - the full precision Delta accumulated since the Drag started
+	 * @param LastSequence - the Sequence of the last Packet sent for the Drag
+	 * @param DragId - the Drag being committed
+	 */
+	UFUNCTION(Server, Reliable, WithValidation, Category = "Replicated Runtime Transformer")
+	void ServerCommitStreamedTransform(const FTransform& FinalDeltaTransform, uint16 LastSequence, uint8 DragId);
+
+	/*
+	 * Multicast, Reliable. The Clients apply what remains of the Final Delta (i.e. what was not Streamed or was lost).
+	 */
+	UFUNCTION(NetMulticast, Reliable, Category = "Replicated Runtime Transformer")
+	void MulticastCommitStreamedTransform(const FTransform& FinalDeltaTransform, uint16 LastSequence, uint8 DragId);
+
+	/*
+	 * ClientCall, Reliable. The authoritative Transforms the Components (and Selected Instances) ended up with
+	 * in the Server, once the Drag was Committed. The Client reconciles the ones whose Predicted Transforms are off
+	 * by more than the Tolerance.
+	 * @see bPredictTransforms
+	 */
+	UFUNCTION(Client, Reliable, Category = "Replicated Runtime Transformer")
+	void ClientAcknowledgeDrag(uint8 DragId, const TArray<USceneComponent*>& Components
+	                           , const TArray<FTransform>& Transforms
+	                           , const TArray<FAcknowledgedInstances>& Instances);
+
 	/*
 	 * ServerCall, Reliable. DeselectAll is performed in the Server.
 	 * Currently no Validation takes place.
@@ -676,22 +1220,18 @@ public:
 	* WARNING: Component Cloning will NOT take place. (PluginLimitations.txt for details)
 
 	* NOTE: The Objects must be Replicating in order to be reflected in the Clients.
-	* Objects that are cloned are NOT directly handled but rather a Timer is used to check
-	* when the objects have finished beginplay, so that we are sure that the networking logic has been processed for them
+	* The Clones are Selected in the Server once the Clone Batch completes. A Client Selects each Clone as soon as 
+	* its reference resolves there (i.e. the Clone has replicated), through the Replicated Selection.
 
 	* @ see CloneSelected
-	* @ see CheckUnreplicatedActors
 	*/
 	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Replicated Runtime Transformer")
 	void ServerCloneSelected(bool bSelectNewClones = true
 	                         , bool bAppendToList = false);
 
-	/*
-	 * A function called by a Timer that checks when a List of Actors have BegunPlay
-	 * and have been replicated. Once all Actors that are on the Unreplicated list have been processed,
-	 * the remaining functions such as MulticastSetSelectedComponents are called.
-	 */
-	void CheckUnreplicatedActors();
+	//Does nothing: the Clones are Selected in the Clients through the Replicated Selection as they resolve
+	UE_DEPRECATED(4.27, "Clones no longer need to be polled for. The Replicated Selection Selects them as they resolve.")
+	void CheckUnreplicatedActors() {}
 
 	/*
 	 * ServerCall, Reliable. SetDomain is performed in the Server.
@@ -701,6 +1241,57 @@ public:
 	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Replicated Runtime Transformer")
 	void ServerSetDomain(ETransformationDomain Domain);
 
+	/*
+	 * ServerCall, Reliable. Undo is performed in the Server, and the resulting Step is Multicast.
+	 * Currently no Validation takes place.
+	 * @ see Undo
+	 */
+	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Replicated Runtime Transformer")
+	void ServerUndo();
+
+	/*
+	 * ServerCall, Reliable. Redo is performed in the Server, and the resulting Step is Multicast.
+	 * Currently no Validation takes place.
+	 * @ see Redo
+	 */
+	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Replicated Runtime Transformer")
+	void ServerRedo();
+
+	/*
+	 * Multicast, Reliable. Applies an Undo / Redo Step (all its Transforms in one batch) everywhere.
+	 * Steps of more than MaxHistoryStepObjects Objects are sent as several, in order.
+	 */
+	UFUNCTION(NetMulticast, Reliable, Category = "Replicated Runtime Transformer")
+	void MulticastApplyHistoryStep(const FTransformHistoryStep& Step);
+
+	/*
+	 * ClientCall, Reliable. The Server rejected Selecting the Component (e.g. another Player holds its Edit Lock).
+	 * Undoes the Selection if the Client had predicted it, and broadcasts OnSelectionRejected.
+	 */
+	UFUNCTION(Client, Reliable, Category = "Replicated Runtime Transformer")
+	void ClientSelectionRejected(class USceneComponent* Component, ESelectionRejectReason Reason);
+
+	/*
+	 * ClientCall, Reliable. What an Editor (another Player) is doing, sent only while this Transformer is interested
+	 * in them. The first ones are the catch-up, the rest only carry what changed in the Editor's State.
+	 * @see bReplicateToObservers, MaxObservedComponentsPerUpdate
+	 */
+	UFUNCTION(Client, Reliable, Category = "Replicated Runtime Transformer")
+	void ClientObserveEditor(const FObservedEditorUpdate& Update);
+
+	/*
+	 * ClientCall, Reliable. This Transformer is no longer interested in the Editor (or the Editor is gone).
+	 */
+	UFUNCTION(Client, Reliable, Category = "Replicated Runtime Transformer")
+	void ClientForgetEditor(class APlayerState* Editor);
+
+	/*
+	 * Multicast, Reliable. Applies the State changes the Server merged (when bCoalesceServerCommands is set),
+	 * in place of the individual Multicasts.
+	 */
+	UFUNCTION(NetMulticast, Reliable, Category = "Replicated Runtime Transformer")
+	void MulticastApplyStateBatch(const FTransformerStateBatch& Batch);
+
 	/*
 	 * Multicast, Reliable. SetDomain is performed in the Clients.
 	 * @ see SetDomain
@@ -709,7 +1300,8 @@ public:
 	void MulticastSetDomain(ETransformationDomain Domain);
 
 	/*
-	 * ServerCall, Reliable. Multicasts the Selected Components of the Server to all Clients.
+	 * ServerCall, Reliable. Forces the whole Replicated Selection of the Server to be compared again with the Clients'.
+	 * Not needed normally, as the Replicated Selection is kept in sync as the Server Selection changes.
 	 * Currently no Validation takes place.
 	 */
 	UFUNCTION(Server, Reliable, WithValidation, BlueprintCallable, Category = "Replicated Runtime Transformer")
@@ -717,13 +1309,134 @@ public:
 
 	/*
 	 * Multicast, Reliable. 
-	 * Syncs the SelectedComponents of the Server to the Clients.
+	 * Syncs the SelectedComponents of the Server to the Clients by resending the whole list.
+	 * The built-in paths use the Replicated Selection (which only sends the diffs) instead.
 	 */
 	UFUNCTION(NetMulticast, Reliable, Category = "Replicated Runtime Transformer")
 	void MulticastSetSelectedComponents(const TArray<USceneComponent*>& Components);
 
-	//Tries to resync the Selections 
-	void ResyncSelection();
+	//Asks the Server to compare its whole Selection with this Client's once. @see ServerSyncSelectedComponents
+	UE_DEPRECATED(4.27, "The Replicated Selection is kept in sync without polling. Use ServerSyncSelectedComponents to force a resync.")
+	void ResyncSelection() { ServerSyncSelectedComponents(); }
+
+	/*
+	 * Server only. Sends a Layout to the Client that owns this Transformer (e.g. a late joiner) in chunks of
+	 * Layout Chunk Size, over Reliable Client RPCs (at most Max Layout Chunks Per Frame, and only while the
+	 * Connection has room for them). The Client Imports it once it has all of it. @see ImportLayout
+	 * A Layout still being sent is dropped.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Replicated Runtime Transformer")
+	void SendLayoutToClient(const TArray<uint8>& Data);
+
+private:
+
+	/*
+	 * ClientCall, Reliable. A chunk of the Layout being sent (the chunks of a Transfer arrive in order).
+	 * A new Transfer Id drops what was received of the previous one. @see SendLayoutToClient
+	 */
+	UFUNCTION(Client, Reliable, Category = "Replicated Runtime Transformer")
+	void ClientReceiveLayoutChunk(uint8 TransferId, int32 TotalSize, const TArray<uint8>& Chunk);
+
+	//Sends the next chunks of the Outgoing Layout, and schedules the next ones for the next tick
+	void SendLayoutChunks();
+
+	//Sends a Stream Packet if Streaming and the Stream Interval has passed since the last one
+	void StreamTransform();
+
+	/**
+	 * Applies the part of the Accumulated Delta of the Drag that has not been applied yet.
+	 * @param bInterpolate - whether to get there over the time until the next Packet is due, rather than right away
+	 */
+	void ApplyStreamedDelta(uint8 DragId, uint16 Sequence, const FTransform& AccumulatedDelta, bool bInterpolate);
+
+	//Receiver: whether the Streamed Drags are Interpolated. @see bInterpolateStreamedTransforms
+	bool ShouldInterpolateStreamedDrags() const;
+
+	//Receiver: whether any Streamed Drag has not caught up with its last Packet yet
+	bool IsInterpolatingStreamedDrags() const;
+
+	//Receiver: moves the Streamed Drags being Interpolated towards the Delta of their last Packet
+	void InterpolateStreamedDrags(float DeltaTime);
+
+	/**
+	 * Sender: Commits the Drag (with the Network Delta Transform) so it ends for the Server and the others.
+	 * If Predicting, the Transforms the Components ended up with are kept until the Server Acknowledges the Drag.
+	 */
+	void CommitDrag();
+
+	//Server: sends the Client its authoritative Transforms for the Drag. @see ClientAcknowledgeDrag
+	void AcknowledgeDrag(uint8 DragId);
+
+	//The Delta that takes an Accumulated Delta From to an Accumulated Delta To. @see AccumulateDeltaTransform
+	static FTransform GetDeltaBetween(const FTransform& From, const FTransform& To);
+
+	//Deselects (if nothing was hit and not appending) and sends the resulting Domain, after a Server Trace
+	void FinishServerTrace(bool bTraceSuccessful, bool bAppendToList);
+
+	/**
+	 * Adds the Request to the Pending Server Traces and queues it in the Subsystem, if Async Server Traces are on.
+	 * A Request that doesn't Append to the List replaces the last Pending one if that didn't either,
+	 * Appending ones are kept in order.
+	 * @return false if the Trace has to be done right away instead
+	 */
+	bool QueueServerTrace(const FServerTraceRequest& Request);
+
+	//Submits the oldest Pending Server Trace as an Async Trace. Called by the Subsystem when it's its turn
+	void SubmitPendingServerTrace();
+
+	//Handles the Hits of an Async Server Trace, the frame after it was submitted (unless it was Resolved since)
+	void OnServerTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, bool bAppendToList
+	                            , uint32 Generation);
+
+	//Does the Trace of the Request right away, and finishes it
+	void RunServerTrace(const FServerTraceRequest& Request);
+
+	/**
+	 * Does the Submitted and Pending Server Traces right away, in order (the Submitted ones' results are ignored).
+	 * Called before the Server RPCs that depend on the Selection, so they see every click sent before them.
+	 */
+	void ResolveServerTraces();
+
+	/**
+	 * Server only. The Batch a change of the Field can be merged into: the last queued one, or a new one if that
+	 * would reorder it. Schedules the Batches to be Flushed. If the Queue is full, it's Flushed first (over the Budget).
+	 * @return nullptr if coalescing is off (the change has to be sent right away)
+	 */
+	FTransformerStateBatch* GetServerStateBatch(FTransformerStateBatch::EField Field, bool& bOutCoalesced);
+
+	/**
+	 * Server only. Sends the queued State Batches, as many as the Budget allows.
+	 * @param bIgnoreBudget - sends all of them (e.g. before a Server RPC that is not batched, to keep the order)
+	 */
+	void FlushServerStateBatches(bool bIgnoreBudget);
+
+	/**
+	 * Server only. Sends the State of this Transformer to the Observers, if it changed.
+	 * Called by the Subsystem once per frame.
+	 * @param Transformers - every Transformer that can Observe
+	 * @param bUpdateInterest - whether to find which Transformers are interested first. The ones that become
+	 * interested get the State right away (the catch-up), the ones that no longer are get told to forget it
+	 */
+	void UpdateObservers(const TArray<TWeakObjectPtr<UTransformerComponent>>& Transformers, bool bUpdateInterest);
+
+	//Server only. Whether this Transformer is interested in what the Editor is doing
+	bool IsInterestedIn(const UTransformerComponent* Editor) const;
+
+	//Server only. Tells the current Observers to forget this Transformer
+	void ForgetObservers();
+
+	//Sets the Editor and the Transformation & Space Types and Domain of the Update
+	void GetObservedUpdate(FObservedEditorUpdate& outUpdate) const;
+
+	/**
+	 * Server only. Sends the Observer the Added & Removed Components, split over as many Updates as
+	 * MaxObservedComponentsPerUpdate needs (only the first one Resets, if Update does)
+	 */
+	void SendObservedUpdate(UTransformerComponent* Observer, const FObservedEditorUpdate& Update
+	                        , const TArray<class USceneComponent*>& Added
+	                        , const TArray<class USceneComponent*>& Removed);
+
+	friend class UTransformerSubsystem;
 
 	//Networking Variables
 private:
@@ -739,29 +1452,210 @@ private:
 	bool bIgnoreNonReplicatedObjects;
 
 	/*
-	 * Optional minimum time to wait for all Cloned objects to fully replicate and are selectable.
-	 * It is not required, but there are occassions (especially when cloning multiple objects at once)
-	 * where the newly spawned clone objects are not selected on the client side because the object, 
-	 * although has begun play, is not still fully network addressable on the client side and so a nullptr is passed 
-	 * (so no selection occurs).
-	 * The time it actually takes to Replicate can be more because it also waits for all clone objects to have begun play.
+	 * No longer used: Clones are Selected in the Clients as soon as they resolve.
+	 * Kept under its name (and readable from Blueprints, with a Deprecation Warning) for one release,
+	 * so existing values still load and the Blueprints reading it still compile.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", DeprecatedProperty,
+			DeprecationMessage = "Clones are no longer polled for, so there's no wait."))
+	float MinimumCloneReplicationTime;
+
+	//No longer used, see Minimum Clone Replication Time
+	UPROPERTY(BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", DeprecatedProperty,
+			DeprecationMessage = "Clones are no longer polled for."))
+	float CloneReplicationCheckFrequency;
+
+	FTransform NetworkDeltaTransform;
+
+	/*
+	 * Whether to Stream the Transform in progress (Unreliable, Quantized) so that other users get a live preview.
+	 * The final, authoritative Transform is still sent Reliably when the Transform finishes.
+	 * @see ReplicateFinishTransform
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
 		meta = (AllowPrivateAccess = "true"))
-	float MinimumCloneReplicationTime;
+	bool bStreamTransforms;
 
-	//The frequency at which checks are done on newly spawned clones. Whether they are suitable for replication.
+	//How many Stream Packets are sent per second (at most) while Transforming
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	float TransformStreamRate;
+
+	//Sender: Sequence of the last Stream Packet sent
+	uint16 StreamSequence;
+
+	//Sender: the Drag being Streamed (or Predicted). Receiver: not used
+	uint8 StreamDragId;
+
+	//Sender: time the last Stream Packet was sent
+	float LastStreamTime;
+
+	//Sender: the Network Delta Transform that was last Streamed, to not resend when nothing moved
+	FTransform LastStreamedDelta;
+
+	//Receiver: the Drags being Streamed that haven't been Committed yet
+	TMap<uint8, FStreamedDragState> StreamedDrags;
+
+	//Receiver: Sequence of the last Committed Drag. Any packet not newer than this is stale
+	uint16 LastCommittedSequence;
+	bool bHasCommittedSequence;
+
+	/*
+	 * Whether the Receivers of the Stream (the Server, e.g. what a Listen Server's Player sees) Interpolate from
+	 * one Packet to the next, over the Stream Interval, instead of jumping to each Packet as it arrives.
+	 * The Commit still takes them right to the Final Delta. Never done in a Dedicated Server (nobody sees it).
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
 		meta = (AllowPrivateAccess = "true"))
-	float CloneReplicationCheckFrequency;
+	bool bInterpolateStreamedTransforms;
 
-	FTransform NetworkDeltaTransform;
+	/*
+	 * Whether the Client predicts its Drags: every Drag ends with a Commit tagged with the Drag Id (even if not
+	 * Streaming), the Client keeps the Transforms it got locally and the Server Acknowledges the Drag with its own.
+	 * Only the Components off by more than the Tolerances are corrected (along with anything moved since).
+	 * @see ClientAcknowledgeDrag
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true"))
+	bool bPredictTransforms;
+
+	//How far (in Unreal Units) a Predicted Location can be from the Server's before it is corrected
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float PredictionLocationTolerance;
+
+	//How far (in Degrees) a Predicted Rotation can be from the Server's before it is corrected
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float PredictionAngleTolerance;
 
-	//List of clone actor/components that need replication but haven't been replicated yet
-	TArray<class USceneComponent*> UnreplicatedComponentClones;
+	//How far a Predicted Scale can be from the Server's before it is corrected
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float PredictionScaleTolerance;
+
+	//Most Components and Instances the Server Acknowledges per Drag. The ones past it keep their Prediction
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 MaxAcknowledgedComponents;
+
+	//Client: the Committed Drags waiting for the Server's Acknowledgement, oldest first
+	TArray<FPredictedDragState> PredictedDrags;
+
+	//Size (in bytes) of the chunks a Layout is sent in. @see SendLayoutToClient
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "256", ClampMax = "32768"))
+	int32 LayoutChunkSize;
+
+	//Most chunks of a Layout sent per frame
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxLayoutChunksPerFrame;
 
-	FTimerHandle CheckUnrepTimerHandle;
-	FTimerHandle ResyncSelectionTimerHandle;
+	//Client: the biggest Layout (in KB) accepted from the Server. Bigger Transfers are dropped
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxLayoutTransferSizeKB;
+
+	//Server: the Layout being sent, and how much of it has been sent
+	TArray<uint8> OutgoingLayout;
+	int32 OutgoingLayoutOffset;
+	uint8 OutgoingLayoutId;
+
+	FTimerHandle LayoutTransferTimerHandle;
+
+	//Client: the Layout being received (the last Transfer, that is, and whether it's still being received)
+	TArray<uint8> IncomingLayout;
+	int32 IncomingLayoutSize;
+	uint8 IncomingLayoutId;
+	bool bReceivingLayout;
+
+	/*
+	 * Whether the Server Traces (ServerTraceBy*) are done as Async Traces rather than in the RPC.
+	 * Only the latest of consecutive non-Appending Trace requests of each Client waits to be submitted,
+	 * and the Server submits a bounded amount per frame (RuntimeTransformer.MaxAsyncServerTracesPerFrame).
+	 * The Hits are handled the next frame, or right away if a Server RPC that depends on the Selection arrives first.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true"))
+	bool bAsyncServerTraces;
+
+	//Server: the Trace requests waiting for their turn to be submitted, oldest first
+	TArray<FServerTraceRequest> PendingServerTraces;
+
+	//Server: the Trace requests submitted as Async Traces whose Hits haven't been handled yet, oldest first
+	TArray<FServerTraceRequest> SubmittedServerTraces;
+
+	//Server: bumped when the Traces are Resolved, so the Async Traces submitted before are ignored once done
+	uint32 ServerTraceGeneration;
+
+	/*
+	 * Whether the Server merges the State changes (Setters, Domain, Transforms, Deselect All) of the Client
+	 * and sends them once per frame as a single Multicast, instead of one Multicast per Server RPC.
+	 * The Multicasts sent are limited to Max State Batches Per Second, the rest wait in a Queue.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true"))
+	bool bCoalesceServerCommands;
+
+	//Budget of State Batch Multicasts per second, for each Client (up to a second's worth can be sent at once)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bCoalesceServerCommands", ClampMin = "1"))
+	float MaxStateBatchesPerSecond;
+
+	//Past this many queued State Batches, they are all sent at once (over the Budget) before another is queued
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bCoalesceServerCommands", ClampMin = "1"))
+	int32 MaxQueuedStateBatches;
+
+	//Server: State Batches waiting to be sent, oldest first
+	TArray<FTransformerStateBatch> QueuedStateBatches;
+
+	//Server: State Batches that can be sent right now (refilled over time)
+	float StateBatchBudget;
+	float LastStateBatchBudgetTime;
+
+	/*
+	 * Whether the Server sends what this Transformer is doing (Selection, Transformation & Space Types, Domain)
+	 * to the other Players interested in it: the ones in the same (non-None) Editing Group, and the ones that have
+	 * any of the Selected Actors Net Relevant. The Multicasts only reach the Client owning the Transformer
+	 * (it lives in its Player Controller), so this is how the other Players see who is Editing what.
+	 * Has to be set for both the Editor and the Observers.
+	 * @see ClientObserveEditor
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true"))
+	bool bReplicateToObservers;
+
+	//Players in the same Editing Group Observe each other regardless of Net Relevancy. None for no Group
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bReplicateToObservers"))
+	FName EditingGroup;
+
+	//How many of the Selected Components are checked for Net Relevancy, at most, for each Observer
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bReplicateToObservers", ClampMin = "1"))
+	int32 MaxObserverRelevancyChecks;
+
+	//Most Components (Selected & Deselected) sent to an Observer per RPC. Bigger changes are sent in several
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bReplicateToObservers", ClampMin = "1"))
+	int32 MaxObservedComponentsPerUpdate;
+
+	//Server: the Transformers that were sent the State of this one
+	TArray<TWeakObjectPtr<UTransformerComponent>> Observers;
+
+	//Server: the Selection as the Observers know it, for the next Update to only carry what changed
+	TSet<TWeakObjectPtr<class USceneComponent>> ObservedComponents;
+
+	//Server: whether the State changed since it was last sent to the Observers
+	bool bObservedStateDirty;
+
+	//Client: the Editors this Transformer Observes
+	UPROPERTY()
+	TArray<FObservedEditorState> ObservedEditors;
 
 
 	//Other Vars
@@ -774,6 +1668,19 @@ private:
 	//The Transform Accumulated for Snapping
 	FTransform AccumulatedDeltaTransform;
 
+	//Transforms of the Components that are being transformed, as they were when the Transform started
+	UPROPERTY()
+	FTransformSnapshot DragSnapshot;
+
+	//Transforms of the Selected Instances, as they were when the Transform started. Valid along with the Drag Snapshot
+	TArray<FInstanceSnapshot> InstanceDragSnapshots;
+
+	//Pivot the Instance Drag Snapshots were captured with
+	FVector InstanceDragPivot;
+
+	//The Delta Transform (after snapping) accumulated since the Drag Snapshot was captured
+	FTransform DragDeltaTransform;
+
 	/**
 	 * GizmoClasses are variables that specified which Gizmo to spawn for each
 	 * transformation. This can even be childs of classes that are already defined
@@ -798,9 +1705,97 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<class AScaleGizmo> ScaleGizmoClass;
 
+	/**
+	 * Max time (milliseconds) to spend Cloning per frame when doing a Batched Clone. 
+	 * If 0 or less, the whole Batch is processed right away.
+	 * @see CloneSelected
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformer", meta = (AllowPrivateAccess = "true"))
+	float CloneFrameBudgetMs;
+
+	//The Clone Batch in progress
+	UPROPERTY()
+	FCloneBatch CloneBatch;
+
+	FTimerHandle CloneBatchTimerHandle;
+
+	/**
+	 * How many Entries of a Layout are read (and placed) per frame when Importing it.
+	 * If 0 or less, the whole Layout is read right away.
+	 * @see ImportLayout
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformer", meta = (AllowPrivateAccess = "true"))
+	int32 LayoutImportEntriesPerFrame;
+
+	//The Layout Import in progress
+	TUniquePtr<FLayoutImport> LayoutImport;
+
+	FTimerHandle LayoutImportTimerHandle;
+
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
 	ABaseGizmo* Gizmo;
 
+	/**
+	 * Whether to spawn the Gizmos of all Transformations at BeginPlay,
+	 * so that the first Selection (or Transformation change) does not need to spawn one.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
+	bool bPrewarmGizmoPool;
+
+	/**
+	 * Whether to pick the Gizmo Domains by analytically intersecting the Trace Ray with the Gizmo Shapes
+	 * instead of going through the Physics Scene. When enabled, the Gizmos have their collision disabled
+	 * and the World Trace only needs a Single Hit (the closest object) rather than a Multi Hit.
+	 * Note that with a Single Hit, a closest object filtered out (e.g. non-replicated) hides the ones behind it.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
+	bool bAnalyticGizmoPicking;
+
+	/**
+	 * Whether Gizmo Actors are only spawned for a Locally Controlled Transformer (the only one they are seen and
+	 * dragged in). The Server's (e.g. a Dedicated Server's) and the Remote ones keep the Selection and apply the
+	 * Transforms, but without Gizmos: the Transforms are applied around where the Gizmo would be, server traces
+	 * pick analytically against the Gizmo Class Defaults, and they only Tick while there is a Transform in progress.
+	 * @see GetVirtualGizmoTransform
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
+	bool bLocalGizmosOnly;
+
+	//One Gizmo per Transformation, spawned lazily. The ones not in use are kept deactivated.
+	UPROPERTY()
+	TMap<ETransformationType, ABaseGizmo*> GizmoPool;
+
+	/**
+	 * Whether the Gizmo is only Scaled / Reoriented when something changed (Camera, FOV, Gizmo Transform, Space, Parent)
+	 * rather than every frame. The Tick is also disabled while there is no Gizmo and no Transform in progress.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"))
+	bool bEventDrivenGizmoUpdates;
+
+	//How much (in Unreal Units) the Camera / Gizmo needs to move for the Gizmo Scene to be scaled again
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"
+		, EditCondition = "bEventDrivenGizmoUpdates"))
+	float GizmoUpdateLocationThreshold;
+
+	//How much (in Degrees) the Camera / Gizmo needs to rotate (or the FOV to change) for the Gizmo Scene to be scaled again
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Gizmo", meta = (AllowPrivateAccess = "true"
+		, EditCondition = "bEventDrivenGizmoUpdates"))
+	float GizmoUpdateAngleThreshold;
+
+	//State of the last Gizmo Scene Scale. @see IsGizmoScaleDirty
+	FVector LastScaleCameraLocation;
+	FVector LastScaleCameraForward;
+	float LastScaleFieldOfView;
+	FTransform LastScaleGizmoTransform;
+	bool bLastScaleInProgress;
+	bool bGizmoScaleDirty;
+
+	//State of the last Gizmo Space update. @see IsGizmoSpaceDirty
+	ESpaceType LastAppliedSpaceType;
+	TWeakObjectPtr<class USceneComponent> LastSpaceParent;
+	FQuat LastSpaceParentRotation;
+	bool bGizmoSpaceDirty;
+
 	// Tell which Domain is Selected. If NONE, then that means that there is no Selected Objects, or
 	// that the Gizmo has not been hit yet.
 	ETransformationDomain CurrentDomain;
@@ -816,11 +1811,11 @@ private:
 	ETransformationType CurrentTransformation;
 
 	/**
-	 * Array storing Selected Components. Although a quick O(1) removal is needed (like a Set),
-	 * it is Crucial that we maintain the order of the elements as they were selected
+	 * Set storing Selected Components. Contains / Add / Remove are O(1),
+	 * and the order of the elements is maintained as they were selected (needed for the Gizmo Placement)
 	 */
 	UPROPERTY()
-	TArray<class USceneComponent*> SelectedComponents;
+	FSelectionSet SelectedComponents;
 
 	/*
 	* Map storing the Snap values for each transformation
@@ -870,6 +1865,104 @@ private:
 		meta = (AllowPrivateAccess = "true"))
 	bool bTransformUFocusableObjects;
 
+	/**
+	 * Whether Drags are Previewed: while the Domain is set, the Components being transformed have no Collision
+	 * and Overlap Events, and only their Component (and Render) Transforms are moved. At the Drop they get a single
+	 * Physics Teleport and Overlap Update each. The UFocusable Objects are still notified of every Transform.
+	 * @see FDragPreview
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true"))
+	bool bPreviewDrags;
+
+	FDragPreview DragPreview;
+
+	/**
+	 * Whether Tracing an Instanced Static Mesh Component selects the Instance hit, rather than the whole Component/Actor.
+	 * @see SelectInstance
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true"))
+	bool bSelectInstances;
+
+	//The Selected Instances of each Instanced Static Mesh Component
+	TMap<TWeakObjectPtr<class UInstancedStaticMeshComponent>, FInstanceSet> SelectedInstances;
+
+	//The Instanced Static Mesh Component that had an Instance selected last (used for the Gizmo Placement)
+	TWeakObjectPtr<class UInstancedStaticMeshComponent> LastInstanceComponent;
+
+	//Whether the Gizmo is currently placed on an Instance (rather than attached to a Component)
+	bool bGizmoOnInstance;
+
+	FDelegateHandle InstanceIndexUpdatedHandle;
+
+	FDelegateHandle PostGarbageCollectHandle;
+
+	/**
+	 * Whether Marquee Selections only select the Objects whose Bounds are fully inside the Rectangle
+	 * (rather than the ones that touch it).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true"))
+	bool bMarqueeRequiresFullyInside;
+
+	//The Selected Components count this Transformer has added to the Selected Components Stat
+	int32 StatSelectedCount;
+
+	/**
+	 * Whether the Transforms (Drags), Clones and Deletes done in the Server are recorded, so they can be Undone.
+	 * While set, Actors are Soft-Deleted (hidden without collision) rather than Destroyed,
+	 * until the Operation that deleted them is dropped from the History.
+	 * Component Based Deletes and Clones are not recorded.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true"))
+	bool bRecordHistory;
+
+	//Max memory (KB) of the History. Past it, the oldest Operations are dropped
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bRecordHistory", ClampMin = "1"))
+	int32 HistoryMemoryBudgetKB;
+
+	//Max amount of Operations in the History
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bRecordHistory", ClampMin = "1"))
+	int32 MaxHistoryOperations;
+
+	//How many of the newest Operations are kept at full precision; the older ones are quantized
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bRecordHistory", ClampMin = "0"))
+	int32 HistoryQuantizeAfter;
+
+	//Most Objects (Components and Actors) sent per Undo / Redo Multicast. Bigger Steps are sent in several
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bRecordHistory", ClampMin = "1"))
+	int32 MaxHistoryStepObjects;
+
+	FTransformHistory History;
+
+	//Transforms of the Components being transformed, as they were when the Domain was set
+	UPROPERTY()
+	FTransformSnapshot HistoryTransformStart;
+
+	/**
+	 * Whether Selecting an Object acquires its Edit Lock in the Server, so no two Players can have it Selected
+	 * (and transform it) at once. Selections of Objects locked by another Player are rejected.
+	 * The Lock is kept on the Actor, or on the Component if Component Based, and released on Deselect.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true"))
+	bool bUseEditLocks;
+
+	//Max amount of Objects this Transformer can have Locked at once. 0 for no limit
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replicated Runtime Transformer",
+		meta = (AllowPrivateAccess = "true", EditCondition = "bUseEditLocks", ClampMin = "0"))
+	int32 MaxEditLocks;
+
+	//The Marquee Selection in progress
+	UPROPERTY()
+	FMarqueeSelection MarqueeSelection;
+
 	//Property that checks whether a CLICK on an already selected object should deselect the object or not.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Runtime Transformations",
 		meta = (AllowPrivateAccess = "true"))
@@ -884,6 +1977,48 @@ private:
 		meta = (AllowPrivateAccess = "true"))
 	bool bComponentBased;
 
-	//Whether we need to Sync with Server if there is a mismatch in number of Selections.
-	bool bResyncSelection;
+	/**
+	 * The Selection of the Server, replicated as diffs to the Clients.
+	 * Kept up to date by the Server as Components are Selected / Deselected.
+	 */
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedSelection)
+	FReplicatedSelectionList ReplicatedSelection;
+
+	//Client only. Whether the Replicated Selection diffs changed the Selection, so the Gizmo needs to be placed again
+	bool bReplicatedSelectionChanged;
+
+	//How many Selection Transactions are currently open (nested)
+	int32 SelectionTransactionDepth;
+
+	//Whether the Gizmo Placement was requested while a Selection Transaction was open
+	bool bGizmoPlacementPending;
+
+	//Whether the Replicated Selection needs flushing once the Selection Transaction ends
+	bool bSelectionSyncPending;
+};
+
+/**
+ * Opens a Selection Transaction on construction and ends it on destruction.
+ * @see UTransformerComponent::BeginSelectionTransaction
+ */
+struct RUNTIMETRANSFORMER_API FScopedSelectionTransaction
+{
+	explicit FScopedSelectionTransaction(UTransformerComponent* InTransformer)
+		: Transformer(InTransformer)
+	{
+		if (Transformer)
+			Transformer->BeginSelectionTransaction();
+	}
+
+	~FScopedSelectionTransaction()
+	{
+		if (Transformer)
+			Transformer->EndSelectionTransaction();
+	}
+
+	FScopedSelectionTransaction(const FScopedSelectionTransaction&) = delete;
+	FScopedSelectionTransaction& operator=(const FScopedSelectionTransaction&) = delete;
+
+private:
+	UTransformerComponent* Transformer;
 };
@@ -0,0 +1,147 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
+#include "TransformerLockTable.generated.h"
+
+//Why the Server rejected a Selection
+UENUM(BlueprintType)
+enum class ESelectionRejectReason : uint8
+{
+	SR_None					UMETA(DisplayName = "None"),
+	SR_LockedByOther		UMETA(DisplayName = "Locked by another Player"),
+	SR_LockLimitReached		UMETA(DisplayName = "Lock Limit Reached"),
+};
+
+/**
+ * An Object (Component or Actor) locked for editing by a Transformer.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformerLockItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	FTransformerLockItem();
+
+	UPROPERTY()
+	UObject* Object;
+
+	//The Player holding the Lock
+	UPROPERTY()
+	class APlayerState* Holder;
+
+	//Client only. The Object the Lock was applied for (differs from Object while it's not resolvable)
+	UPROPERTY(NotReplicated)
+	UObject* AppliedObject;
+
+	//Server only. The Transformer holding the Lock
+	TWeakObjectPtr<class UTransformerComponent> HolderTransformer;
+
+	//Server only. How many Selected Components of the Holder need the Lock
+	int32 Count;
+
+	void PreReplicatedRemove(const struct FTransformerLockList& InArraySerializer);
+	void PostReplicatedAdd(const struct FTransformerLockList& InArraySerializer);
+	void PostReplicatedChange(const struct FTransformerLockList& InArraySerializer);
+};
+
+/**
+ * The Edit Locks of a World, replicated as a Fast Array so only the Locks that changed are sent.
+ * Authoritative in the Server: a Lock is acquired when a Transformer Selects an Object and released
+ * when it Deselects it. Clients only use it to predict which Selections the Server will reject.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformerLockList : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Server only. Locks the Object for the Transformer (or adds to the Lock it already holds).
+	 * Locks of Transformers that no longer exist are taken over.
+	 * @param MaxLocks - how many Objects the Transformer can have Locked at once. 0 or less for no limit
+	 */
+	ESelectionRejectReason Acquire(UObject* Object, class UTransformerComponent* Transformer
+	                               , class APlayerState* Holder, int32 MaxLocks);
+
+	//Server only. Releases the Lock of the Object, if held by the Transformer
+	void Release(UObject* Object, class UTransformerComponent* Transformer);
+
+	//Server only. Releases every Lock held by the Transformer
+	void ReleaseAll(class UTransformerComponent* Transformer);
+
+	//The Player holding the Lock of the Object, nullptr if it's not locked
+	class APlayerState* GetHolder(const UObject* Object) const;
+
+	//Server only. The Transformer holding the Lock of the Object, nullptr if it's not locked
+	class UTransformerComponent* GetHolderTransformer(const UObject* Object) const;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTransformerLockItem, FTransformerLockList>(
+			Items, DeltaParms, *this);
+	}
+
+private:
+
+	friend struct FTransformerLockItem;
+
+	void RemoveItem(int32 Index);
+
+	UPROPERTY()
+	TArray<FTransformerLockItem> Items;
+
+	//Server only. Maps each Object to its Item index
+	TMap<const UObject*, int32> ItemIndex;
+
+	//Server only. How many Objects each Transformer has Locked, so the Lock Limit is checked without a scan
+	TMap<TWeakObjectPtr<class UTransformerComponent>, int32> HeldLocks;
+
+	//Client only. The Holder of each Object with an Applied Lock (weak, as the Holder may be gone before the Lock)
+	mutable TMap<const UObject*, TWeakObjectPtr<class APlayerState>> ClientHolders;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTransformerLockList> : public TStructOpsTypeTraitsBase2<FTransformerLockList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Replicates the Edit Locks of the World to everyone.
+ * Spawned by the Server the first time a Transformer needs it.
+ * @see UTransformerSubsystem
+ */
+UCLASS(NotPlaceable, NotBlueprintable, Transient)
+class RUNTIMETRANSFORMER_API ATransformerLockTable : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+
+	ATransformerLockTable();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	FTransformerLockList& GetLocks() { return Locks; }
+
+	const FTransformerLockList& GetLocks() const { return Locks; }
+
+private:
+
+	UPROPERTY(Replicated)
+	FTransformerLockList Locks;
+};
@@ -0,0 +1,82 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RuntimeTransformer.h"
+#include "TransformerStateBatch.generated.h"
+
+/**
+ * The State changes (Setters, Domain, Delta Transform, Deselect All) a Client requested, merged by the Server
+ * and sent to everyone in a single Multicast.
+ *
+ * The changes are applied in a fixed order: Setters, then Domain, then Delta Transform, then Deselect All.
+ * A change can only be merged into the Batch if that doesn't reorder it with the changes already there
+ * (e.g. a Domain after a Delta Transform needs a new Batch). Merging is last-wins for the Setters and the Domain,
+ * except that a cleared Domain (TD_None) is never replaced, and Delta Transforms are accumulated.
+ *
+ * Only the fields that were set are Net Serialized.
+ */
+USTRUCT()
+struct RUNTIMETRANSFORMER_API FTransformerStateBatch
+{
+	GENERATED_BODY()
+
+public:
+
+	enum EField : uint8
+	{
+		SB_TransformationType	= 1 << 0,
+		SB_SpaceType			= 1 << 1,
+		SB_ComponentBased		= 1 << 2,
+		SB_RotateOnLocalAxis	= 1 << 3,
+		SB_Domain				= 1 << 4,
+		SB_DeltaTransform		= 1 << 5,
+		SB_DeselectAll			= 1 << 6,
+	};
+
+	FTransformerStateBatch();
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool IsEmpty() const { return Fields == 0; }
+
+	bool Has(EField Field) const { return (Fields & Field) != 0; }
+
+	//Whether a change of the Field can be merged into this Batch without being reordered
+	bool CanMerge(EField Field) const;
+
+	void SetTransformationType(ETransformationType Type);
+	void SetSpaceType(ESpaceType Type);
+	void SetComponentBased(bool bIsComponentBased);
+	void SetRotateOnLocalAxis(bool bRotateLocalAxis);
+	void SetDomain(ETransformationDomain InDomain);
+	void AddDeltaTransform(const FTransform& InDeltaTransform);
+
+	//Only the first Deselect All of the Batch matters, the ones after it find nothing Selected
+	void DeselectAll(bool bInDestroySelected);
+
+	//Approximate size of the set fields, for the RPC Stats
+	int32 GetParameterSize() const;
+
+	uint8 Fields;
+
+	ETransformationType TransformationType;
+	ESpaceType SpaceType;
+	ETransformationDomain Domain;
+	bool bComponentBased;
+	bool bRotateOnLocalAxis;
+	bool bDestroySelected;
+
+	//Rotations are composed, Locations & Scales are added
+	FTransform DeltaTransform;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTransformerStateBatch> : public TStructOpsTypeTraitsBase2<FTransformerStateBatch>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
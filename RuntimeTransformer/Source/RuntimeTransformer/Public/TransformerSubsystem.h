@@ -0,0 +1,95 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "CollisionQueryParams.h"
+#include "TransformerSubsystem.generated.h"
+
+//A Trace requested by a Client, waiting in the Server for its turn to be submitted as an Async Trace
+struct FServerTraceRequest
+{
+	enum class EQueryType : uint8
+	{
+		ObjectTypes,
+		Channel,
+		Profile,
+	};
+
+	EQueryType QueryType = EQueryType::Channel;
+	FVector StartLocation = FVector::ZeroVector;
+	FVector EndLocation = FVector::ZeroVector;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	//the Object Types of ObjectQueryParams, for when the Trace has to be done right away
+	TArray<TEnumAsByte<ECollisionChannel>> CollisionChannels;
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECollisionChannel::ECC_Visibility;
+	FName ProfileName;
+	bool bAppendToList = false;
+};
+
+/**
+ * State shared by all the Transformers of a World (e.g. the Edit Locks).
+ * Also submits the Async Server Traces of the Transformers, at most
+ * RuntimeTransformer.MaxAsyncServerTracesPerFrame per frame (in request order),
+ * and flushes the queued State Batches of the Transformers once per frame.
+ * In the Server, it also sends the State of the Transformers to their Observers once per frame,
+ * finding who is interested every RuntimeTransformer.ObserverInterestInterval seconds.
+ */
+UCLASS()
+class RUNTIMETRANSFORMER_API UTransformerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * The Lock Table of the World.
+	 * @param bSpawnIfMissing - Server only. Spawns the Table if there's none yet.
+	 * In Clients it's nullptr until the Table has replicated.
+	 */
+	class ATransformerLockTable* GetLockTable(bool bSpawnIfMissing = false);
+
+	void RegisterLockTable(class ATransformerLockTable* Table);
+
+	void UnregisterLockTable(class ATransformerLockTable* Table);
+
+	//Queues the Transformer to submit its Pending Server Trace (does nothing if it's already queued)
+	void QueueServerTrace(class UTransformerComponent* Transformer);
+
+	//Queues the Transformer to flush its State Batches next Tick (does nothing if it's already queued)
+	void QueueStateBatchFlush(class UTransformerComponent* Transformer);
+
+	//Server only. Adds the Transformer to the ones that Observe (and can be Observed by) each other
+	void RegisterTransformer(class UTransformerComponent* Transformer);
+
+	void UnregisterTransformer(class UTransformerComponent* Transformer);
+
+	virtual void Deinitialize() override;
+
+	//~ Begin FTickableGameObject Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject Interface
+
+private:
+
+	UPROPERTY()
+	class ATransformerLockTable* LockTable;
+
+	//Transformers with a Pending Server Trace, oldest request first
+	TArray<TWeakObjectPtr<class UTransformerComponent>> QueuedServerTraces;
+
+	//Transformers with State Batches to flush
+	TArray<TWeakObjectPtr<class UTransformerComponent>> QueuedStateBatchFlushes;
+
+	//Transformers that replicate to Observers
+	TArray<TWeakObjectPtr<class UTransformerComponent>> ObservingTransformers;
+
+	//World Time the Interest of the Observers was last updated
+	float LastObserverInterestTime = -1.f;
+};
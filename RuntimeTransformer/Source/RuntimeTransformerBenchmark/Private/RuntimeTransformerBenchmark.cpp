@@ -0,0 +1,9 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "RuntimeTransformerBenchmark.h"
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY(LogTransformerBenchmark);
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, RuntimeTransformerBenchmark)
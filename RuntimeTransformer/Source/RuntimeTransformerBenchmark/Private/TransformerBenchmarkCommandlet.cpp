@@ -0,0 +1,360 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+
+#include "TransformerBenchmarkCommandlet.h"
+#include "RuntimeTransformerBenchmark.h"
+#include "TransformerComponent.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace TransformerBenchmark
+{
+	//Space between the Spawned Actors
+	static constexpr float Spacing = 200.f;
+
+	//Amount of times the Selection operations are repeated
+	static constexpr int32 SelectionIterations = 10;
+
+	//Time of every Ticked frame
+	static constexpr float FrameTime = 1.f / 60.f;
+
+	//Frames Ticked after every phase, and at most while a Clone Batch is still in progress
+	static constexpr int32 MinSettleFrames = 2;
+	static constexpr int32 MaxSettleFrames = 600;
+
+	struct FResult
+	{
+		FString Hierarchy;
+		int32 Components;
+		FString Operation;
+		int32 Iterations;
+		double TotalMs;
+		double MinMs;
+		double MaxMs;
+	};
+
+	struct FDragCase
+	{
+		ETransformationType Type;
+		ETransformationDomain Domain;
+		float SnappingValue;
+	};
+
+	static const FDragCase DragCases[] = {
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_X_Axis, 10.f},
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_Y_Axis, 10.f},
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_Z_Axis, 10.f},
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_XY_Plane, 10.f},
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_YZ_Plane, 10.f},
+		{ETransformationType::TT_Translation, ETransformationDomain::TD_XZ_Plane, 10.f},
+		{ETransformationType::TT_Rotation, ETransformationDomain::TD_X_Axis, 15.f},
+		{ETransformationType::TT_Rotation, ETransformationDomain::TD_Y_Axis, 15.f},
+		{ETransformationType::TT_Rotation, ETransformationDomain::TD_Z_Axis, 15.f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_X_Axis, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_Y_Axis, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_Z_Axis, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_XY_Plane, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_YZ_Plane, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_XZ_Plane, 0.25f},
+		{ETransformationType::TT_Scale, ETransformationDomain::TD_XYZ, 0.25f},
+	};
+
+	//Times every Iteration of the Function separately. Setup is called before each Iteration, outside of the timing
+	template <typename SetupType, typename FunctionType>
+	static FResult Measure(const FString& Hierarchy, int32 Components, const FString& Operation
+	                       , int32 Iterations, SetupType&& Setup, FunctionType&& Function)
+	{
+		FResult result{Hierarchy, Components, Operation, Iterations, 0.0, TNumericLimits<double>::Max(), 0.0};
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			Setup(i);
+
+			const double startTime = FPlatformTime::Seconds();
+			Function(i);
+			const double elapsedMs = (FPlatformTime::Seconds() - startTime) * 1000.0;
+
+			result.TotalMs += elapsedMs;
+			result.MinMs = FMath::Min(result.MinMs, elapsedMs);
+			result.MaxMs = FMath::Max(result.MaxMs, elapsedMs);
+		}
+		if (Iterations <= 0) result.MinMs = 0.0;
+		return result;
+	}
+
+	template <typename FunctionType>
+	static FResult Measure(const FString& Hierarchy, int32 Components, const FString& Operation
+	                       , int32 Iterations, FunctionType&& Function)
+	{
+		return Measure(Hierarchy, Components, Operation, Iterations, [](int32) {}
+		               , Forward<FunctionType>(Function));
+	}
+
+	/**
+	 * Spawns Count Actors with a Movable Root Component each.
+	 * If Depth > 1, every Actor is attached to the previous one in chains of Depth Actors.
+	 */
+	static TArray<USceneComponent*> SpawnScene(UWorld* World, int32 Count, int32 Depth)
+	{
+		TArray<USceneComponent*> roots;
+		roots.Reserve(Count);
+
+		const int32 rowSize = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count))));
+		for (int32 i = 0; i < Count; ++i)
+		{
+			AActor* actor = World->SpawnActor<AActor>();
+			if (!actor) continue;
+
+			USceneComponent* root = NewObject<USceneComponent>(actor, TEXT("Root"));
+			root->SetMobility(EComponentMobility::Type::Movable);
+			actor->SetRootComponent(root);
+			root->RegisterComponent();
+			actor->SetActorLocation(FVector((i % rowSize) * Spacing, (i / rowSize) * Spacing, 0.f));
+
+			if (Depth > 1 && i % Depth != 0 && roots.Num() > 0)
+				actor->AttachToActor(roots.Last()->GetOwner(), FAttachmentTransformRules::KeepWorldTransform);
+
+			roots.Add(root);
+		}
+		return roots;
+	}
+
+	static void TickWorld(UWorld* World)
+	{
+		World->Tick(ELevelTick::LEVELTICK_All, FrameTime);
+		++GFrameCounter;
+	}
+
+	/**
+	 * Ticks the World until the work deferred by the previous phase is done
+	 * (the Clone Batch is complete, the Async Traces have returned and the Batched RPCs have been flushed)
+	 */
+	static FResult Settle(UWorld* World, UTransformerComponent* Transformer, const FString& Hierarchy
+	                      , int32 Components, const FString& Operation)
+	{
+		int32 frames = 0;
+		FResult result = Measure(Hierarchy, Components, Operation + TEXT("_Deferred"), 1, [&](int32)
+		{
+			while (frames < MinSettleFrames || (Transformer->IsCloneBatchInProgress() && frames < MaxSettleFrames))
+			{
+				TickWorld(World);
+				++frames;
+			}
+		});
+		if (Transformer->IsCloneBatchInProgress())
+			UE_LOG(LogTransformerBenchmark, Warning, TEXT("%s did not complete in %d frames"), *Operation, frames);
+		result.Iterations = frames;
+		return result;
+	}
+
+	static FString GetEnumName(ETransformationType Type)
+	{
+		return StaticEnum<ETransformationType>()->GetNameStringByValue(static_cast<int64>(Type));
+	}
+
+	static FString GetEnumName(ETransformationDomain Domain)
+	{
+		return StaticEnum<ETransformationDomain>()->GetNameStringByValue(static_cast<int64>(Domain));
+	}
+
+	//Runs every benchmark on a scene (in a World of its own, destroyed afterwards)
+	static void RunScene(int32 Count, int32 Depth, int32 Frames, TArray<FResult>& outResults)
+	{
+		UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TransformerBenchmark"));
+		FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		worldContext.SetCurrentWorld(world);
+		world->InitializeActorsForPlay(FURL());
+		world->BeginPlay();
+
+		const FString hierarchy = Depth > 1 ? FString::Printf(TEXT("Deep%d"), Depth) : TEXT("Flat");
+		UE_LOG(LogTransformerBenchmark, Display, TEXT("Benchmarking %d Components (%s)"), Count, *hierarchy);
+
+		const TArray<USceneComponent*> roots = SpawnScene(world, Count, Depth);
+
+		APlayerController* controller = world->SpawnActor<APlayerController>();
+		UTransformerComponent* transformer = NewObject<UTransformerComponent>(controller);
+		transformer->RegisterComponent();
+
+		/* SELECTION */
+		auto deselect = [&](int32) { transformer->DeselectAll(); };
+		auto select = [&](int32) { transformer->SelectMultipleComponents(roots, false); };
+
+		outResults.Add(Measure(hierarchy, Count, TEXT("SelectMultipleComponents"), SelectionIterations
+		                       , deselect, select));
+		outResults.Add(Measure(hierarchy, Count, TEXT("DeselectAll"), SelectionIterations, select, deselect));
+		select(0);
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("SelectMultipleComponents")));
+
+		/* DRAGGING */
+		//the Gizmo is on the Last Selected Component. The Camera looks at it from above and to the side
+		const FVector gizmoLocation = roots.Num() > 0 ? roots.Last()->GetComponentLocation() : FVector::ZeroVector;
+		const FVector cameraLocation = gizmoLocation + FVector(-600.f, -600.f, 400.f);
+		const FVector lookingVector = (gizmoLocation - cameraLocation).GetSafeNormal();
+
+		for (const FDragCase& dragCase : DragCases)
+		{
+			for (bool bSnapping : {false, true})
+			{
+				transformer->SetTransformationType(dragCase.Type);
+				transformer->SetSnappingValue(dragCase.Type, dragCase.SnappingValue);
+				transformer->SetSnappingEnabled(dragCase.Type, bSnapping);
+				transformer->ServerSetDomain(dragCase.Domain);
+
+				const FString operation = FString::Printf(TEXT("Drag_%s_%s%s"), *GetEnumName(dragCase.Type)
+				                                          , *GetEnumName(dragCase.Domain)
+				                                          , bSnapping ? TEXT("_Snapping") : TEXT(""));
+
+				outResults.Add(Measure(hierarchy, Count, operation, Frames, [&](int32 frame)
+				{
+					//the Mouse moves in a circle around the Gizmo
+					const float angle = frame * (2.f * PI / 60.f);
+					const FVector target = gizmoLocation + FVector(0.f, FMath::Cos(angle), FMath::Sin(angle)) * 50.f;
+					transformer->UpdateTransform(lookingVector, cameraLocation, (target - cameraLocation).GetSafeNormal());
+					TickWorld(world);
+				}));
+
+				//put everything back so the next case starts from the same scene
+				transformer->CancelTransform();
+				outResults.Add(Settle(world, transformer, hierarchy, Count, operation));
+			}
+		}
+		transformer->SetTransformationType(ETransformationType::TT_Translation);
+
+		/* CLONING */
+		outResults.Add(Measure(hierarchy, Count, TEXT("CloneSelected"), 1, [&](int32)
+		{
+			transformer->CloneSelected(true, false);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("CloneSelected")));
+		outResults.Add(Measure(hierarchy, Count, TEXT("DeselectAll_DestroySelected"), 1, [&](int32)
+		{
+			transformer->DeselectAll(true);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("DeselectAll_DestroySelected")));
+		select(0);
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("SelectMultipleComponents")));
+
+		/* SERVER RPCS (Standalone, so they run locally, which is what the Server does when they arrive) */
+		outResults.Add(Measure(hierarchy, Count, TEXT("ApplyDeltaTransform"), Frames, [&](int32)
+		{
+			transformer->ApplyDeltaTransform(FTransform(FQuat::Identity, FVector(1.f, 0.f, 0.f), FVector::ZeroVector));
+			TickWorld(world);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("ApplyDeltaTransform")));
+		outResults.Add(Measure(hierarchy, Count, TEXT("ServerApplyTransform"), Frames, [&](int32)
+		{
+			transformer->ServerApplyTransform(FTransform(FQuat::Identity, FVector(1.f, 0.f, 0.f), FVector::ZeroVector));
+			TickWorld(world);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("ServerApplyTransform")));
+		outResults.Add(Measure(hierarchy, Count, TEXT("ServerCloneSelected"), 1, [&](int32)
+		{
+			transformer->ServerCloneSelected(true, false);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("ServerCloneSelected")));
+		outResults.Add(Measure(hierarchy, Count, TEXT("ServerDeselectAll_DestroySelected"), 1, [&](int32)
+		{
+			transformer->ServerDeselectAll(true);
+		}));
+		outResults.Add(Settle(world, transformer, hierarchy, Count, TEXT("ServerDeselectAll_DestroySelected")));
+
+		//Ends its Play, so it unbinds from the Engine Delegates before the World is gone
+		transformer->DestroyComponent();
+
+		GEngine->DestroyWorldContext(world);
+		world->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	static FString ToCSV(const TArray<FResult>& Results, const FString& Label)
+	{
+		FString csv = TEXT("Label,Hierarchy,Components,Operation,Iterations,TotalMs,AverageMs,MinMs,MaxMs\n");
+		for (const FResult& result : Results)
+		{
+			csv += FString::Printf(TEXT("%s,%s,%d,%s,%d,%.4f,%.4f,%.4f,%.4f\n"), *Label, *result.Hierarchy
+			                       , result.Components, *result.Operation, result.Iterations, result.TotalMs
+			                       , result.TotalMs / FMath::Max(1, result.Iterations), result.MinMs, result.MaxMs);
+		}
+		return csv;
+	}
+
+	static FString ToJSON(const TArray<FResult>& Results, const FString& Label, const FString& Date)
+	{
+		FString json = FString::Printf(TEXT("{\n\t\"Label\": \"%s\",\n\t\"Date\": \"%s\",\n\t\"EngineVersion\": \"%s\",\n\t\"Results\": [\n")
+		                               , *Label.ReplaceCharWithEscapedChar(), *Date
+		                               , *FEngineVersion::Current().ToString());
+		for (int32 i = 0; i < Results.Num(); ++i)
+		{
+			const FResult& result = Results[i];
+			json += FString::Printf(TEXT("\t\t{\"Hierarchy\": \"%s\", \"Components\": %d, \"Operation\": \"%s\", \"Iterations\": %d, ")
+			                        TEXT("\"TotalMs\": %.4f, \"AverageMs\": %.4f, \"MinMs\": %.4f, \"MaxMs\": %.4f}%s\n")
+			                        , *result.Hierarchy, result.Components, *result.Operation, result.Iterations
+			                        , result.TotalMs, result.TotalMs / FMath::Max(1, result.Iterations)
+			                        , result.MinMs, result.MaxMs, i + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+		json += TEXT("\t]\n}\n");
+		return json;
+	}
+}
+
+UTransformerBenchmarkCommandlet::UTransformerBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTransformerBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace TransformerBenchmark;
+
+	FString countsParam = TEXT("1,100,1000,10000");
+	FParse::Value(*Params, TEXT("Counts="), countsParam, false);
+
+	int32 depth = 16;
+	FParse::Value(*Params, TEXT("Depth="), depth);
+
+	int32 frames = 300;
+	FParse::Value(*Params, TEXT("Frames="), frames);
+
+	FString label = TEXT("Unlabeled");
+	FParse::Value(*Params, TEXT("Label="), label);
+
+	TArray<FString> countStrings;
+	countsParam.ParseIntoArray(countStrings, TEXT(","));
+
+	TArray<FResult> results;
+	for (const FString& countString : countStrings)
+	{
+		const int32 count = FCString::Atoi(*countString);
+		if (count <= 0) continue;
+
+		RunScene(count, 1, frames, results);
+		if (depth > 1)
+			RunScene(count, depth, frames, results);
+	}
+
+	const FString date = FDateTime::Now().ToString();
+	const FString directory = FPaths::ProjectSavedDir() / TEXT("Benchmarks");
+	const FString baseName = directory / FString::Printf(TEXT("RuntimeTransformer_%s"), *date);
+	IFileManager::Get().MakeDirectory(*directory, true);
+
+	const bool bSaved = FFileHelper::SaveStringToFile(ToCSV(results, label), *(baseName + TEXT(".csv")))
+		&& FFileHelper::SaveStringToFile(ToJSON(results, label, date), *(baseName + TEXT(".json")));
+	if (!bSaved)
+	{
+		UE_LOG(LogTransformerBenchmark, Error, TEXT("Could not write the Benchmark Results to %s"), *directory);
+		return 1;
+	}
+
+	UE_LOG(LogTransformerBenchmark, Display, TEXT("Benchmark Results written to %s.csv/.json"), *baseName);
+	return 0;
+}
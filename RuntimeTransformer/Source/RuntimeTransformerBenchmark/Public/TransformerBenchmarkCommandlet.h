@@ -0,0 +1,32 @@
+// Copyright 2020 Juan Marcelo Portillo. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TransformerBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the Transformer hot paths (Selection, Dragging for every Gizmo & Domain, Cloning and the Server RPCs)
+ * on synthetic scenes of Movable Components, both flat and in deep hierarchies.
+ * The World is Ticked between (and, for the Drags & RPCs, during) the phases, so the deferred work
+ * (Clone Batches, Async Traces, Batched Server RPCs) is measured too, as "<Operation>_Deferred".
+ * The results are written as CSV & JSON to Saved/Benchmarks so they can be compared between versions.
+ *
+ * Usage: UE4Editor-Cmd <Project> -run=TransformerBenchmark [-Counts=1,100,1000,10000] [-Depth=16] [-Frames=300] [-Label=<Name>]
+ *  Counts - the amount of Components of each scene
+ *  Depth - the length of the attachment chains of the deep hierarchy scenes
+ *  Frames - the amount of frames of every scripted drag
+ *  Label - added to the output (e.g. the Plugin Version), defaults to "Unlabeled"
+ */
+UCLASS()
+class RUNTIMETRANSFORMERBENCHMARK_API UTransformerBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UTransformerBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};